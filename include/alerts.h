@@ -0,0 +1,136 @@
+#ifndef ALERTS_H
+#define ALERTS_H
+
+/*----------------------------------------------------------------
+  Weather alerts: OneCall 'alerts' kept in a fixed size store
+
+    {"sender_name": ..., "event": ..., "start": ..., "end": ..., "description": ..., "tags": [...]}
+
+    Descriptions run to several KB. The JSON filter drops 'alerts'; AlertFold, a
+    JsonTap listener, copies each alert into an AlertStore as the parser reads
+    past it. Text is cut to the field size a character at a time, so nothing but
+    the store is allocated however long the alert. At most ALERT_CAPACITY alerts
+    are kept, in response order; the rest are counted in 'dropped'.
+*/
+
+#include <Arduino.h>
+
+#include "jsonTap.h"
+
+#define ALERT_CAPACITY 3
+#define ALERT_DESCRIPTION_SIZE 160  // Start of description kept, incl. terminator
+
+struct WeatherAlert {
+  char sender[32];
+  char event[32];
+  uint32_t start;
+  uint32_t end;
+  char description[ALERT_DESCRIPTION_SIZE];
+  bool truncated;  // Description was cut
+};
+
+struct AlertStore {
+  WeatherAlert alerts[ALERT_CAPACITY];
+  uint8_t count;
+  uint8_t dropped;
+
+  bool sameAs(const AlertStore& other) const {
+    if (count != other.count || dropped != other.dropped) return false;
+    for (uint8_t i = 0; i < count; i++) {
+      const WeatherAlert &a = alerts[i], &b = other.alerts[i];
+      if (a.start != b.start || a.end != b.end || strcmp(a.event, b.event) != 0 ||
+          strcmp(a.description, b.description) != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Alert in force at 'now', or next to start, nullptr if none
+  const WeatherAlert* current(time_t now) const {
+    const WeatherAlert* next = nullptr;
+    for (uint8_t i = 0; i < count; i++) {
+      const WeatherAlert& a = alerts[i];
+      if (a.end && (time_t)a.end < now) continue;
+      if ((time_t)a.start <= now) return &a;
+      if (!next || a.start < next->start) next = &a;
+    }
+    return next;
+  }
+};
+
+// Fills an AlertStore from the "alerts" array of a response, see JsonTap
+class AlertFold : public JsonTap::Listener {
+ private:
+  AlertStore _store = {};
+  WeatherAlert* _alert = nullptr;  // Entry being read, nullptr if store is full
+  char* _text = nullptr;           // Text field being read, nullptr if not kept
+  size_t _size = 0;
+  size_t _length = 0;
+  bool* _truncated = nullptr;
+
+ public:
+  AlertFold() : Listener("alerts") {}
+
+  void reset() {
+    _store.count = _store.dropped = 0;
+    _alert = nullptr;
+    _text = nullptr;
+  }
+  const AlertStore& result() { return _store; }
+
+  void beginEntry() override {
+    _text = nullptr;
+    if (_store.count == ALERT_CAPACITY) {
+      _store.dropped++;
+      _alert = nullptr;
+      return;
+    }
+    _alert = &_store.alerts[_store.count++];
+    *_alert = {};
+  }
+
+  void number(const char* key, const char* text) override {
+    if (!_alert) return;
+    if (strcmp(key, "start") == 0) {
+      _alert->start = strtoul(text, nullptr, 10);
+    } else if (strcmp(key, "end") == 0) {
+      _alert->end = strtoul(text, nullptr, 10);
+    }
+  }
+
+  void beginString(const char* key) override {
+    _text = nullptr;
+    _truncated = nullptr;
+    _length = 0;
+    if (!_alert) return;
+    if (strcmp(key, "description") == 0) {
+      _text = _alert->description;
+      _size = sizeof(_alert->description);
+      _truncated = &_alert->truncated;
+    } else if (strcmp(key, "event") == 0) {
+      _text = _alert->event;
+      _size = sizeof(_alert->event);
+    } else if (strcmp(key, "sender_name") == 0) {
+      _text = _alert->sender;
+      _size = sizeof(_alert->sender);
+    }
+  }
+
+  // Append to the field, collapsing runs of white space. Quotes and backslashes would end
+  // or escape a Nextion text command, they become ' and /.
+  void stringChar(char c) override {
+    if (!_text) return;
+    if (c == '"') c = '\'';
+    if (c == '\\') c = '/';
+    if (c == ' ' && (_length == 0 || _text[_length - 1] == ' ')) return;
+    if (_length + 1 < _size) {
+      _text[_length++] = c;
+      _text[_length] = 0;
+    } else if (_truncated) {
+      *_truncated = true;
+    }
+  }
+};
+
+#endif  // ALERTS_H
@@ -0,0 +1,98 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+/*----------------------------------------------------------------
+  MonotonicArena: fixed buffer bump allocator for per-refresh work
+
+    Plugs into ArduinoJson as a custom Allocator so each weather refresh parses into
+    the same statically allocated buffer instead of the general heap. Call reset() once
+    the JsonDocument using it has been destroyed.
+
+    Blocks are only freed when they are the most recent allocation (ArduinoJson shrinks
+    its pools and string buffers this way), everything else is reclaimed by reset().
+    If the buffer is exhausted, allocations fall back to malloc() and are counted in
+    heapFallbacks() so an undersized arena shows up in the logs.
+
+    used(), peak(), capacity() report arena usage in bytes. peak() is the high water
+    mark since the last reset(), i.e. of the current refresh; maxPeak() is since boot.
+*/
+
+#include <ArduinoJson.h>
+
+template <size_t N>
+class MonotonicArena : public ArduinoJson::Allocator {
+ private:
+  static const size_t _align = 8;
+  static const size_t _header = _align;  // Block size stored in front of each block
+
+  alignas(8) uint8_t _buffer[N];
+  size_t _used = 0;
+  size_t _peak = 0;     // Since reset()
+  size_t _maxPeak = 0;  // Since boot
+  size_t _last = SIZE_MAX;  // Offset of most recent block's header
+  uint32_t _heapFallbacks = 0;
+
+  static size_t roundUp(size_t size) { return (size + _align - 1) & ~(_align - 1); }
+  bool owns(void* ptr) { return (uint8_t*)ptr >= _buffer && (uint8_t*)ptr < _buffer + N; }
+  size_t& blockSize(size_t offset) { return *(size_t*)(_buffer + offset); }
+
+ public:
+  void* allocate(size_t size) override {
+    size_t needed = _header + roundUp(size);
+    if (needed > N - _used) {
+      _heapFallbacks++;
+      return malloc(size);
+    }
+    _last = _used;
+    blockSize(_last) = size;
+    _used += needed;
+    if (_used > _peak) _peak = _used;
+    return _buffer + _last + _header;
+  }
+
+  void deallocate(void* ptr) override {
+    if (!owns(ptr)) {
+      free(ptr);
+      return;
+    }
+    // Only the most recent block can be given back
+    if ((uint8_t*)ptr == _buffer + _last + _header) {
+      _used = _last;
+      _last = SIZE_MAX;
+    }
+  }
+
+  void* reallocate(void* ptr, size_t newSize) override {
+    if (ptr == nullptr) return allocate(newSize);
+    if (!owns(ptr)) return realloc(ptr, newSize);
+
+    size_t offset = (uint8_t*)ptr - _buffer - _header;
+    if (offset == _last && _header + roundUp(newSize) <= N - _last) {
+      // Most recent block, grow or shrink in place
+      blockSize(offset) = newSize;
+      _used = _last + _header + roundUp(newSize);
+      if (_used > _peak) _peak = _used;
+      return ptr;
+    }
+    size_t oldSize = blockSize(offset);
+    void* newPtr = allocate(newSize);
+    if (newPtr) memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+    return newPtr;
+  }
+
+  // Release everything and start a new peak. Caller must ensure nothing still points into the arena.
+  void reset() {
+    if (_peak > _maxPeak) _maxPeak = _peak;
+    _used = 0;
+    _peak = 0;
+    _last = SIZE_MAX;
+  }
+
+  size_t used() { return _used; }
+  size_t peak() { return _peak; }
+  size_t maxPeak() { return _peak > _maxPeak ? _peak : _maxPeak; }
+  size_t capacity() { return N; }
+  uint32_t heapFallbacks() { return _heapFallbacks; }
+};
+
+#endif  // ARENA_H
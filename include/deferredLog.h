@@ -0,0 +1,131 @@
+#ifndef DEFERREDLOG_H
+#define DEFERREDLOG_H
+
+/*----------------------------------------------------------------
+  DeferredLog: log records formatted off the hot path
+
+      LOG_INFO("Fetch: %u ms, %s", ms, gzipped ? "gzip" : "identity");
+
+    stores the format string's address, a timestamp and up to LOG_MAX_ARGS raw
+    one word arguments in a lock-free ring: no formatting, no allocation, no wait
+    on the UART, a few dozen cycles. The Log task, at the lowest priority (see
+    taskPlan.h), formats the records and writes them to Serial.
+
+    Arguments are kept by value with their type, so %d %u %x %c %f and %s all
+    format as with printf; 64 bit values are cut to 32 bits and '*' widths are not
+    supported. A %s argument is kept as a pointer: it must still be valid when the
+    record is drained, so a literal or a long lived buffer, never a local buffer or
+    String::c_str() of a temporary. The macros still check formats against
+    arguments at compile time.
+
+    Levels above LOG_LEVEL (settings.h) compile to nothing, arguments included.
+
+    Any task may log. The ring is a bounded multi producer queue with a sequence
+    number per cell; when it is full records are dropped and counted, and the count
+    is logged by the next drain. Periodic reports (loop, tasks, stalls, heap...)
+    log many lines at once from loop(); they call waitForRoom() between lines so
+    a long report waits for the Log task instead of being cut short.
+*/
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <type_traits>
+
+#include "settings.h"
+
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_RING_SIZE 64  // Records, power of two
+#define LOG_MAX_ARGS 6
+#define LOG_DRAIN_MS 20   // Log task polls the ring this often
+
+class DeferredLog {
+ public:
+  enum ArgType : uint8_t { argUnsigned, argSigned, argFloat, argString };
+
+  // A word holds a 32 bit value or a pointer, so host builds (see test/) keep whole pointers
+  struct Arg {
+    uintptr_t word;
+    ArgType type;
+  };
+
+  struct Record {
+    const char* format;
+    uint32_t millis;
+    uintptr_t args[LOG_MAX_ARGS];
+    uint16_t types;  // ArgType, 2 bits per argument
+    uint8_t level;
+    uint8_t argc;
+  };
+
+  template <typename T>
+  static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, Arg>::type encode(T value) {
+    return {(uint32_t)value, std::is_signed<T>::value ? argSigned : argUnsigned};
+  }
+  template <typename T>
+  static typename std::enable_if<std::is_floating_point<T>::value, Arg>::type encode(T value) {
+    float f = value;
+    uint32_t word;
+    memcpy(&word, &f, sizeof(word));
+    return {word, argFloat};
+  }
+  static Arg encode(const char* text) { return {(uintptr_t)text, argString}; }
+
+  template <typename... Args>
+  void record(uint8_t level, const char* format, Args... args) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Too many log arguments");
+    const Arg encoded[] = {encode(args)..., {0, argUnsigned}};  // Never empty
+    push(level, format, encoded, sizeof...(Args));
+  }
+
+  void begin();            // Starts the Log task. Records made earlier wait in the ring.
+  void drain(Print* out);  // Formats all queued records. Log task only.
+
+  // Wait up to maxMs for 'records' free cells. For reports, not hot paths.
+  bool waitForRoom(uint8_t records, uint32_t maxMs = 1000);
+
+ private:
+  void push(uint8_t level, const char* format, const Arg* args, uint8_t argc);
+};
+
+extern DeferredLog deferredLog;
+
+// Never called, lets the compiler check formats against arguments
+__attribute__((format(printf, 1, 2))) inline void logFormatCheck(const char*, ...) {}
+
+#define LOG_RECORD(level, ...)                      \
+  do {                                              \
+    if (false) logFormatCheck(__VA_ARGS__);         \
+    deferredLog.record(level, __VA_ARGS__);         \
+  } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LOG_RECORD(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) LOG_RECORD(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) LOG_RECORD(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LOG_RECORD(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#endif  // DEFERREDLOG_H
@@ -0,0 +1,340 @@
+#ifndef FLEET_H
+#define FLEET_H
+
+/*----------------------------------------------------------------
+  Fleet: stations at the same location share one OpenWeather fetch
+
+    Stations join a UDP multicast group. Every FLEET_HEARTBEAT_MS each station
+    announces itself; a station that hears a new member announces straight away,
+    so a booting station learns the fleet within a moment.
+
+    Leader election: the leader is the member with the lowest device id heard
+    within FLEET_TIMEOUT_MS (including this station). Every station computes the
+    same answer from its member table, so no votes are exchanged. If the leader
+    goes quiet it times out and the next lowest id takes over.
+
+    A leader whose last FLEET_MISSED_FETCHES fetches failed stops announcing, so
+    the others time it out and the next lowest id takes over. It keeps fetching
+    and takes snapshots from the new leader. Its next good fetch is published
+    and it rejoins, again as leader. If every station's fetches fail, each one
+    ends up fetching for itself until one succeeds.
+
+    The leader fetches and parses OneCall, then multicasts a WeatherSnapshot
+    (see weather.h). Followers skip their own fetch and copy the snapshot into
+    their model. Snapshot sequence numbers increase across the fleet (a new
+    leader continues from the highest it has seen), so only newer snapshots are
+    applied. A follower that announces an older sequence than the leader's is
+    sent the current snapshot again.
+
+    Datagram, little endian:
+      Header  : "OWFL" magic, uint8_t version, uint8_t type, uint16_t length,
+                uint32_t sender, uint32_t group, uint32_t sequence, uint32_t crc,
+                uint8_t mac[16]
+      Payload : type fleetAnnounce - none
+                type fleetSnapshot - uint8_t snapshot version + WeatherSnapshot
+    group is a hash of the configured location, stations elsewhere are ignored.
+    crc is the CRC-32 of the payload.
+
+    The CRC only catches corruption. Without FLEET_KEY any host on the LAN can
+    send a snapshot with a higher sequence and every station will show it, or
+    announce a low id and take the lead. With FLEET_KEY (the same on every
+    station) mac is an HMAC-SHA256 of header and payload, cut to 16 bytes, and
+    packets without a valid mac are rejected. Replayed packets are still
+    accepted, but a snapshot is applied only if it is newer than the one shown.
+
+    Without begin() the station is always its own leader.
+*/
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <esp_rom_crc.h>
+#ifdef FLEET_KEY
+#include <mbedtls/md.h>
+#endif
+
+#include "deferredLog.h"
+#include "weather.h"
+
+#define FLEET_GROUP_IP IPAddress(239, 255, 42, 99)  // Multicast group
+#define FLEET_PORT 42099
+#define FLEET_HEARTBEAT_MS 10000  // Announce period
+#define FLEET_TIMEOUT_MS 35000    // Member is gone after this long without an announce
+#define FLEET_MAX_MEMBERS 8
+#define FLEET_MISSED_FETCHES 3    // Failed fetches in a row before the leader stands down
+
+class Fleet {
+ private:
+  static const uint8_t _protocolVersion = 2;
+  enum MessageType : uint8_t { fleetAnnounce = 1, fleetSnapshot = 2 };
+
+  struct __attribute__((packed)) Header {
+    char magic[4];
+    uint8_t version;
+    uint8_t type;
+    uint16_t length;
+    uint32_t sender;
+    uint32_t group;
+    uint32_t sequence;
+    uint32_t crc;
+    uint8_t mac[16];  // Zero without FLEET_KEY
+  };
+
+  struct __attribute__((packed)) SnapshotMessage {
+    Header header;
+    uint8_t snapshotVersion;
+    WeatherSnapshot snapshot;
+  };
+
+  // One Ethernet frame: 1500 less IP and UDP headers
+  static_assert(sizeof(SnapshotMessage) <= 1472, "snapshot datagram would be fragmented");
+
+  struct Member {
+    uint32_t id;
+    uint32_t sequence;  // Newest snapshot member holds
+    unsigned long lastHeard;
+  };
+
+  WiFiUDP _udp;
+  bool _active = false;
+  uint32_t _id = 0;
+  uint32_t _group = 0;
+  uint32_t _leader = 0;
+  Member _members[FLEET_MAX_MEMBERS] = {};
+  unsigned long _lastAnnounce = 0;
+  unsigned long _lastResend = 0;
+  bool _resendWanted = false;
+  uint8_t _failedFetches = 0;  // In a row, while leader
+
+  uint32_t _sequence = 0;      // Newest snapshot sequence seen or sent
+  uint32_t _appliedFrom = 0;   // Sender and sequence of snapshot in use
+  uint32_t _appliedSequence = 0;
+  bool _hasSnapshot = false;
+  bool _applyPending = false;  // _message not yet copied into the model, it was busy
+  SnapshotMessage _message;    // Last snapshot sent or applied, kept for resends
+  uint8_t _packet[sizeof(SnapshotMessage)];  // Receive buffer
+
+  uint32_t _sent = 0;
+  uint32_t _received = 0;
+  uint32_t _rejected = 0;
+
+  void fillHeader(Header& header, MessageType type, uint16_t length, const void* payload) {
+    memcpy(header.magic, "OWFL", 4);
+    header.version = _protocolVersion;
+    header.type = type;
+    header.length = length;
+    header.sender = _id;
+    header.group = _group;
+    header.sequence = _hasSnapshot ? _appliedSequence : 0;
+    header.crc = esp_rom_crc32_le(0, (const uint8_t*)payload, length);
+    memset(header.mac, 0, sizeof(header.mac));
+#ifdef FLEET_KEY
+    sign(header, (const uint8_t*)payload, length, header.mac);
+#endif
+  }
+
+#ifdef FLEET_KEY
+  // HMAC-SHA256 of the header, mac zeroed, and the payload
+  static void sign(const Header& header, const uint8_t* payload, uint16_t length, uint8_t* mac) {
+    Header unsigned_ = header;
+    memset(unsigned_.mac, 0, sizeof(unsigned_.mac));
+    uint8_t hash[32];
+    mbedtls_md_context_t context;
+    mbedtls_md_init(&context);
+    mbedtls_md_setup(&context, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 1);
+    mbedtls_md_hmac_starts(&context, (const uint8_t*)FLEET_KEY, strlen(FLEET_KEY));
+    mbedtls_md_hmac_update(&context, (const uint8_t*)&unsigned_, sizeof(unsigned_));
+    if (length) mbedtls_md_hmac_update(&context, payload, length);
+    mbedtls_md_hmac_finish(&context, hash);
+    mbedtls_md_free(&context);
+    memcpy(mac, hash, sizeof(unsigned_.mac));
+  }
+
+  static bool signedBy(const Header& header, const uint8_t* payload) {
+    uint8_t mac[sizeof(header.mac)];
+    sign(header, payload, header.length, mac);
+    uint8_t difference = 0;  // Same time whichever byte differs
+    for (size_t i = 0; i < sizeof(mac); i++) difference |= mac[i] ^ header.mac[i];
+    return difference == 0;
+  }
+#endif
+
+  // Leader with failing fetches: stays silent so another station takes over
+  bool standingDown() { return isLeader() && _failedFetches >= FLEET_MISSED_FETCHES; }
+
+  void send(const void* packet, size_t size) {
+    _udp.beginMulticastPacket();
+    _udp.write((const uint8_t*)packet, size);
+    _udp.endPacket();
+    _sent++;
+  }
+
+  void announce() {
+    _lastAnnounce = millis();
+    if (standingDown()) return;
+    Header header;
+    fillHeader(header, fleetAnnounce, 0, nullptr);
+    send(&header, sizeof(header));
+  }
+
+  void sendSnapshot() {
+    send(&_message, sizeof(_message));
+    _lastResend = millis();
+    _resendWanted = false;
+  }
+
+  // Record an announce or snapshot, returns true if member was not known
+  bool heard(uint32_t id, uint32_t sequence) {
+    Member* slot = nullptr;
+    for (auto& member : _members) {
+      if (member.id == id) {
+        member.sequence = sequence;
+        member.lastHeard = millis();
+        return false;
+      }
+      if (!slot && (member.id == 0 || millis() - member.lastHeard > FLEET_TIMEOUT_MS)) slot = &member;
+    }
+    if (!slot) return false;
+    *slot = {id, sequence, millis()};
+    return true;
+  }
+
+  void electLeader() {
+    uint32_t leader = _id;
+    for (auto& member : _members) {
+      if (member.id && millis() - member.lastHeard <= FLEET_TIMEOUT_MS && member.id < leader) leader = member.id;
+    }
+    if (leader != _leader) {
+      _leader = leader;
+      if (leader != _id) _failedFetches = 0;
+      LOG_INFO("Fleet: leader %08X%s", leader, leader == _id ? " (this station)" : "");
+    }
+  }
+
+  // Handle datagram loaded by parsePacket(). A new snapshot is kept in _message until poll() applies it.
+  void receive() {
+    const uint8_t* packet = _packet;
+    int len = _udp.read(_packet, sizeof(_packet));
+    if (len < (int)sizeof(Header)) return;
+
+    Header header;
+    memcpy(&header, packet, sizeof(header));
+    if (memcmp(header.magic, "OWFL", 4) != 0 || header.version != _protocolVersion || header.group != _group ||
+        header.sender == _id) {
+      return;
+    }
+    if (header.length != len - sizeof(Header) ||
+        header.crc != esp_rom_crc32_le(0, packet + sizeof(Header), header.length)) {
+      _rejected++;
+      return;
+    }
+#ifdef FLEET_KEY
+    if (!signedBy(header, packet + sizeof(Header))) {
+      _rejected++;
+      return;
+    }
+#endif
+
+    _received++;
+    if (heard(header.sender, header.sequence)) announce();  // Let new member know about us
+    if ((int32_t)(header.sequence - _sequence) > 0) _sequence = header.sequence;
+    electLeader();
+
+    if (header.type == fleetAnnounce) {
+      if (isLeader() && _hasSnapshot && _appliedFrom == _id && _appliedSequence == _sequence &&
+          header.sequence != _appliedSequence) {
+        _resendWanted = true;
+      }
+      return;
+    }
+    // Newer snapshots are taken from any station, e.g. the old leader's last one after a partition heals
+    if (header.type != fleetSnapshot || len != sizeof(SnapshotMessage)) return;
+    if (packet[sizeof(Header)] != WEATHER_SNAPSHOT_VERSION) {
+      _rejected++;
+      return;
+    }
+    if (_hasSnapshot && (int32_t)(header.sequence - _appliedSequence) <= 0) return;  // Not newer
+
+    memcpy(&_message, packet, sizeof(_message));
+    _hasSnapshot = true;
+    _applyPending = true;
+    _appliedFrom = header.sender;
+    _appliedSequence = header.sequence;
+  }
+
+ public:
+  // Join the fleet. lat/lon identify the location, only stations with the same location cooperate.
+  void begin(float lat, float lon) {
+    _id = (uint32_t)(ESP.getEfuseMac() >> 16);  // Last four bytes of MAC
+    int32_t location[2] = {(int32_t)lroundf(lat * 1000), (int32_t)lroundf(lon * 1000)};
+    _group = esp_rom_crc32_le(0, (const uint8_t*)location, sizeof(location));
+    _leader = _id;
+    _active = _udp.beginMulticast(FLEET_GROUP_IP, FLEET_PORT);
+    if (!_active) {
+      LOG_WARN("Fleet: multicast join failed, fetching locally");
+      return;
+    }
+    LOG_INFO("Fleet: station %08X joined", _id);
+    announce();
+  }
+
+  // Listen for other stations for up to waitMs, so a booting station doesn't fetch needlessly
+  void discover(unsigned long waitMs, owmWeather& weather) {
+    unsigned long start = millis();
+    while (_active && millis() - start < waitMs) {
+      poll(&weather);
+      delay(10);
+    }
+  }
+
+  // Call from loop() every pass. Handles announces, elections and resends.
+  // weather is null while its model is busy (being fetched), a new snapshot is then
+  // held until a poll passes the model. Returns true if a snapshot was applied to weather.
+  bool poll(owmWeather* weather) {
+    if (!_active) return false;
+    while (_udp.parsePacket() > 0) receive();
+    if (millis() - _lastAnnounce >= FLEET_HEARTBEAT_MS) announce();
+    electLeader();
+    if (_resendWanted && isLeader() && millis() - _lastResend >= FLEET_HEARTBEAT_MS / 2) sendSnapshot();
+    if (!_applyPending || !weather) return false;
+    weather->fromSnapshot(_message.snapshot);
+    _applyPending = false;
+    return true;
+  }
+
+  // Leader: send freshly fetched weather to followers
+  void publish(owmWeather& weather) {
+    if (!_active || !isLeader()) return;
+    _failedFetches = 0;
+    _sequence++;
+    _appliedFrom = _id;
+    _appliedSequence = _sequence;
+    _hasSnapshot = true;
+    _applyPending = false;  // Our fetch is newer than a snapshot held during it
+    _message.snapshotVersion = WEATHER_SNAPSHOT_VERSION;
+    weather.toSnapshot(_message.snapshot);
+    fillHeader(_message.header, fleetSnapshot, sizeof(_message) - sizeof(Header), &_message.snapshotVersion);
+    sendSnapshot();
+  }
+
+  // Leader: fetch of the shared location failed
+  void fetchFailed() {
+    if (!_active || !isLeader() || _failedFetches == UINT8_MAX) return;
+    if (++_failedFetches == FLEET_MISSED_FETCHES) LOG_WARN("Fleet: fetches failing, standing down");
+  }
+
+  bool isLeader() { return !_active || _leader == _id; }
+  bool active() { return _active; }
+
+  void report() {
+    if (!_active) return;
+    uint8_t members = 0;
+    for (auto& member : _members) members += member.id && millis() - member.lastHeard <= FLEET_TIMEOUT_MS;
+    deferredLog.waitForRoom(2);
+    LOG_INFO("Fleet: %s, leader %08X, %u peers", standingDown() ? "leader standing down" : isLeader() ? "leader" : "follower",
+             _leader, members);
+    LOG_INFO("Fleet: snapshot %u, %u sent, %u received, %u rejected", _appliedSequence, _sent, _received, _rejected);
+  }
+};
+
+#endif  // FLEET_H
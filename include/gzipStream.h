@@ -0,0 +1,205 @@
+#ifndef GZIPSTREAM_H
+#define GZIPSTREAM_H
+
+/*----------------------------------------------------------------
+  GzipStream: inflate a gzip body (RFC 1952) while it is being read
+
+    Wraps the HTTP response stream. Decoded bytes are handed to the reader (e.g.
+    deserializeJson) as they are inflated, the compressed body is never buffered.
+
+    Uses the tinfl inflater in the ESP32 ROM. Deflate may refer back up to 32 KB,
+    so the output window is TINFL_LZ_DICT_SIZE bytes; decoded bytes are read
+    straight out of that window. Window and inflater state (about 43 KB) are
+    allocated by reserve() and freed by release(), so they only exist during a fetch.
+
+    finish() reads to the end of the body and checks the gzip trailer
+    (CRC-32 and length of the decoded data).
+*/
+
+#include <Arduino.h>
+#include <esp32/rom/miniz.h>
+#include <esp_rom_crc.h>
+
+#define GZIP_INPUT_SIZE 512  // Compressed bytes read from the source at a time
+
+class GzipStream : public Stream {
+ private:
+  enum State : uint8_t { gzHeader, gzInflate, gzDone, gzFailed };
+
+  Stream* _source = nullptr;
+  tinfl_decompressor* _inflator = nullptr;
+  uint8_t* _window = nullptr;
+  uint8_t _in[GZIP_INPUT_SIZE];
+  size_t _inPos = 0;
+  size_t _inLen = 0;
+  bool _sourceEnded = false;
+  size_t _windowPos = 0;  // Next inflate position in window
+  size_t _outPos = 0;     // Decoded bytes not yet read: _window[_outPos, _outEnd)
+  size_t _outEnd = 0;
+  State _state = gzFailed;
+  bool _trailerOk = false;
+  uint32_t _crc = 0;
+  uint32_t _wireBytes = 0;
+  uint32_t _decodedBytes = 0;
+
+  // Refill input buffer from the source. Blocks (source timeout) only when nothing is available.
+  bool fillInput() {
+    if (_inPos < _inLen) return true;
+    if (_sourceEnded) return false;
+    int n = _source->available();
+    if (n <= 0) n = 1;
+    if (n > (int)sizeof(_in)) n = sizeof(_in);
+    _inPos = 0;
+    _inLen = _source->readBytes((char*)_in, n);
+    _wireBytes += _inLen;
+    if (_inLen == 0) _sourceEnded = true;
+    return _inLen > 0;
+  }
+
+  int nextInputByte() { return fillInput() ? _in[_inPos++] : -1; }
+
+  bool skipInput(size_t count) {
+    while (count--) {
+      if (nextInputByte() < 0) return false;
+    }
+    return true;
+  }
+
+  bool skipString() {
+    int c;
+    do {
+      c = nextInputByte();
+    } while (c > 0);
+    return c == 0;
+  }
+
+  // Member header: ID1 ID2 CM FLG MTIME(4) XFL OS [FEXTRA] [FNAME] [FCOMMENT] [FHCRC]
+  bool readHeader() {
+    uint8_t header[10];
+    for (auto& b : header) {
+      int c = nextInputByte();
+      if (c < 0) return false;
+      b = c;
+    }
+    if (header[0] != 0x1F || header[1] != 0x8B || header[2] != 8) return false;
+    uint8_t flags = header[3];
+    if (flags & 0x04) {  // FEXTRA
+      int lo = nextInputByte(), hi = nextInputByte();
+      if (lo < 0 || hi < 0 || !skipInput(lo | (hi << 8))) return false;
+    }
+    if ((flags & 0x08) && !skipString()) return false;  // FNAME
+    if ((flags & 0x10) && !skipString()) return false;  // FCOMMENT
+    if ((flags & 0x02) && !skipInput(2)) return false;  // FHCRC
+    return true;
+  }
+
+  // CRC-32 and size of decoded data, little endian
+  void readTrailer() {
+    uint32_t fields[2] = {};
+    for (auto& field : fields) {
+      for (int i = 0; i < 4; i++) {
+        int c = nextInputByte();
+        if (c < 0) return;
+        field |= (uint32_t)c << (8 * i);
+      }
+    }
+    _trailerOk = fields[0] == _crc && fields[1] == _decodedBytes;
+  }
+
+  // Inflate until some decoded bytes are available or the body ends
+  bool inflateMore() {
+    if (_state == gzHeader) _state = readHeader() ? gzInflate : gzFailed;
+    while (_state == gzInflate) {
+      if (_windowPos == TINFL_LZ_DICT_SIZE) _windowPos = 0;  // Window wraps, already read
+      fillInput();
+      size_t inBytes = _inLen - _inPos;
+      size_t outBytes = TINFL_LZ_DICT_SIZE - _windowPos;
+      tinfl_status status = tinfl_decompress(_inflator, _in + _inPos, &inBytes, _window, _window + _windowPos,
+                                             &outBytes, _sourceEnded ? 0 : TINFL_FLAG_HAS_MORE_INPUT);
+      _inPos += inBytes;
+      if (outBytes) {
+        _crc = esp_rom_crc32_le(_crc, _window + _windowPos, outBytes);
+        _decodedBytes += outBytes;
+        _outPos = _windowPos;
+        _outEnd = _windowPos + outBytes;
+        _windowPos += outBytes;
+      }
+      if (status == TINFL_STATUS_DONE) {
+        _state = gzDone;
+        readTrailer();
+      } else if (status < 0 || (status == TINFL_STATUS_NEEDS_MORE_INPUT && _sourceEnded)) {
+        _state = gzFailed;  // Corrupt or truncated
+      }
+      if (outBytes) return true;
+    }
+    return false;
+  }
+
+  bool ensureOutput() { return _outPos < _outEnd || inflateMore(); }
+
+ public:
+  ~GzipStream() { release(); }
+
+  // Allocate window and inflater state. Returns false if there is not enough heap.
+  bool reserve() {
+    if (!_inflator) _inflator = (tinfl_decompressor*)malloc(sizeof(tinfl_decompressor));
+    if (!_window) _window = (uint8_t*)malloc(TINFL_LZ_DICT_SIZE);
+    if (_inflator && _window) return true;
+    release();
+    return false;
+  }
+
+  void release() {
+    free(_inflator);
+    free(_window);
+    _inflator = nullptr;
+    _window = nullptr;
+    _state = gzFailed;
+  }
+
+  // Start decoding a gzip body from source. Call reserve() first.
+  void begin(Stream& source) {
+    _source = &source;
+    _inPos = _inLen = 0;
+    _sourceEnded = false;
+    _windowPos = _outPos = _outEnd = 0;
+    _crc = 0;
+    _wireBytes = _decodedBytes = 0;
+    _trailerOk = false;
+    _state = _inflator && _window ? gzHeader : gzFailed;
+    if (_inflator) tinfl_init(_inflator);
+  }
+
+  // Read and discard the rest of the body. Returns true if it decoded and its trailer matched.
+  bool finish() {
+    while (ensureOutput()) _outPos = _outEnd;
+    return _state == gzDone && _trailerOk;
+  }
+
+  bool failed() { return _state == gzFailed; }
+  uint32_t wireBytes() { return _wireBytes; }
+  uint32_t decodedBytes() { return _decodedBytes; }
+
+  // Stream
+  int available() override {
+    if (_outPos < _outEnd) return _outEnd - _outPos;
+    return (_state == gzHeader || _state == gzInflate) && (_inPos < _inLen || _source->available() > 0);
+  }
+  int read() override { return ensureOutput() ? _window[_outPos++] : -1; }
+  int peek() override { return ensureOutput() ? _window[_outPos] : -1; }
+  using Stream::readBytes;
+  size_t readBytes(char* buffer, size_t length) override {
+    size_t count = 0;
+    while (count < length && ensureOutput()) {
+      size_t n = _outEnd - _outPos;
+      if (n > length - count) n = length - count;
+      memcpy(buffer + count, _window + _outPos, n);
+      _outPos += n;
+      count += n;
+    }
+    return count;
+  }
+  size_t write(uint8_t) override { return 0; }
+};
+
+#endif  // GZIPSTREAM_H
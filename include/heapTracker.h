@@ -0,0 +1,72 @@
+#ifndef HEAPTRACKER_H
+#define HEAPTRACKER_H
+
+/*----------------------------------------------------------------
+  HeapTracker: opt-in allocation tracer with allocation-site attribution
+
+    Enabled by building with -DHEAP_TRACKER and linking with
+    -Wl,--wrap=malloc,--wrap=free,--wrap=realloc,--wrap=calloc,--wrap=heap_caps_free
+    (see [env:ESP32-JSON7-heaptrace] in platformio.ini). Without HEAP_TRACKER
+    nothing is compiled in.
+
+    Every malloc/calloc/realloc/new is tagged with a small header holding the
+    caller's return address and a check word derived from the header's address
+    and size. Pointers without a valid header (allocated before tracking, or with
+    heap_caps_malloc()) are passed straight through. Per-site counts and live
+    bytes are kept in a fixed size table, so the tracker never allocates. Sites are code addresses; decode
+    them with addr2line or the esp32_exception_decoder.
+
+    sample() records free heap, largest free block and fragmentation
+    (1 - largest / free) into a fixed ring, and updates each site's growth streak.
+    A site whose live bytes grew for HEAP_TRACKER_LEAK_STREAK consecutive samples
+    is flagged as a suspected leak.
+
+    report() logs heap history and the tracked sites. siteOf(ptr) returns the
+    site record of a live block, for tests (see test/test_heaptracker).
+
+    Uses ESP-IDF heap_caps_* for heap statistics on the ESP32. On other targets
+    (host builds) free heap figures are reported as zero, site tracking still works.
+*/
+
+#ifdef HEAP_TRACKER
+
+#include <Arduino.h>
+
+#define HEAP_TRACKER_SITES 64       // Max distinct allocation sites, extra sites share slot 0
+#define HEAP_TRACKER_HISTORY 16     // Heap samples kept for report()
+#define HEAP_TRACKER_LEAK_STREAK 6  // Consecutive growing samples before a site is flagged
+
+class HeapTracker {
+ public:
+  struct Site {
+    uintptr_t pc;            // Return address of caller, 0 = unused slot
+    uint32_t allocs;
+    uint32_t frees;
+    int32_t liveBytes;
+    int32_t peakLiveBytes;
+    int32_t sampledLiveBytes;  // liveBytes at previous sample()
+    uint8_t growStreak;        // Consecutive samples with liveBytes growing
+  };
+
+  struct HeapSample {
+    uint32_t uptimeSeconds;
+    uint32_t freeBytes;
+    uint32_t largestFreeBlock;
+    uint32_t minFreeBytes;
+    uint16_t fragmentation;  // Per mille, 1000 * (1 - largest / free)
+  };
+
+  void sample();
+  void report();
+
+  bool isLeakSuspect(const Site& site) { return site.growStreak >= HEAP_TRACKER_LEAK_STREAK; }
+  Site siteOf(void* ptr);  // Site a live tracked block was allocated from, all zero for any other pointer
+  uint32_t totalAllocs();
+  int32_t totalLiveBytes();
+};
+
+extern HeapTracker heapTracker;
+
+#endif  // HEAP_TRACKER
+
+#endif  // HEAPTRACKER_H
@@ -0,0 +1,198 @@
+#ifndef JSONTAP_H
+#define JSONTAP_H
+
+/*----------------------------------------------------------------
+  JsonTap: watch a JSON response as it streams into deserializeJson
+
+    Sits between the HTTP (or gzip) stream and the parser and sees every byte the
+    parser consumes. Listeners name a root array (e.g. "minutely") and are handed
+    the members of each object in it as they go by: numbers as text, strings as
+    beginString(key) then one character at a time. Nothing is buffered, so a
+    listener can fold or truncate data the JSON filter drops, in bounded memory,
+    however long the array or its strings are.
+
+    The scanner only tracks nesting, the last key and the number being read.
+    String escapes are simplified: \n \r \t become a space, \uXXXX becomes '?'.
+*/
+
+#include <Arduino.h>
+
+class JsonTap : public Stream {
+ public:
+  class Listener {
+   public:
+    const char* const array;  // Root member watched
+    explicit Listener(const char* array) : array(array) {}
+    virtual void beginEntry() {}
+    virtual void number(const char*, const char*) {}
+    virtual void beginString(const char*) {}
+    virtual void stringChar(char) {}
+    virtual void endEntry() {}
+  };
+
+ private:
+  static const uint8_t _maxListeners = 2;
+  Stream* _source = nullptr;
+  Listener* _listeners[_maxListeners];
+  uint8_t _listenerCount = 0;
+  Listener* _active = nullptr;  // Listener of the array being read
+  uint8_t _arrayDepth = 0;      // Depth inside its array
+
+  uint8_t _depth = 0;
+  bool _inString = false;
+  bool _escape = false;
+  uint8_t _unicodeSkip = 0;     // Hex digits of \uXXXX still to skip
+  bool _afterColon = false;     // Next value belongs to _key
+  char _key[16];
+  uint8_t _keyLen = 0;
+  bool _keyTruncated = false;
+  char _number[24];
+  uint8_t _numberLen = 0;
+  bool _inNumber = false;
+  uint32_t _scanned = 0;
+
+  // Value directly inside an entry of the watched array
+  bool inEntry() { return _active && _depth == _arrayDepth + 1 && !_keyTruncated; }
+
+  void stringChar(char c) {
+    if (_afterColon) {
+      if (inEntry()) _active->stringChar(c);
+    } else if (_keyLen < sizeof(_key) - 1) {
+      _key[_keyLen++] = c;
+    } else {
+      _keyTruncated = true;
+    }
+  }
+
+  void endNumber() {
+    _inNumber = false;
+    _number[_numberLen] = 0;
+    _numberLen = 0;
+    if (inEntry()) _active->number(_key, _number);
+  }
+
+  void scan(uint8_t c) {
+    _scanned++;
+    if (_inString) {
+      if (_unicodeSkip) {
+        _unicodeSkip--;
+      } else if (_escape) {
+        _escape = false;
+        if (c == 'u') {
+          _unicodeSkip = 4;
+          stringChar('?');
+        } else {
+          stringChar(c == 'n' || c == 'r' || c == 't' ? ' ' : c);
+        }
+      } else if (c == '\\') {
+        _escape = true;
+      } else if (c == '"') {
+        _inString = false;
+        if (!_afterColon) _key[_keyLen] = 0;
+      } else {
+        stringChar(c);
+      }
+      return;
+    }
+    if (_inNumber) {
+      if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+        if (_numberLen < sizeof(_number) - 1) _number[_numberLen++] = c;
+        return;
+      }
+      endNumber();
+    }
+    switch (c) {
+      case '"':
+        _inString = true;
+        if (!_afterColon) {
+          _keyLen = 0;
+          _keyTruncated = false;
+        } else if (inEntry()) {
+          _active->beginString(_key);
+        }
+        break;
+      case ':':
+        _key[_keyLen] = 0;
+        _afterColon = true;
+        break;
+      case ',':
+        _afterColon = false;
+        break;
+      case '{':
+        _afterColon = false;
+        _depth++;
+        if (_active && _depth == _arrayDepth + 1) _active->beginEntry();
+        break;
+      case '[':
+        // Root object is depth 1
+        if (_afterColon && _depth == 1 && !_keyTruncated) {
+          for (uint8_t i = 0; i < _listenerCount; i++) {
+            if (strcmp(_key, _listeners[i]->array) == 0) {
+              _active = _listeners[i];
+              _arrayDepth = _depth + 1;
+            }
+          }
+        }
+        _afterColon = false;
+        _depth++;
+        break;
+      case '}':
+        if (_active && _depth == _arrayDepth + 1) _active->endEntry();
+        if (_depth) _depth--;
+        _afterColon = false;
+        break;
+      case ']':
+        if (_active && _depth == _arrayDepth) _active = nullptr;
+        if (_depth) _depth--;
+        _afterColon = false;
+        break;
+      default:
+        if (_afterColon && ((c >= '0' && c <= '9') || c == '-')) {
+          _inNumber = true;
+          _number[_numberLen++] = c;
+        }
+        break;
+    }
+  }
+
+ public:
+  // Start watching a response read from source. Listeners are cleared.
+  void begin(Stream& source) {
+    _source = &source;
+    _listenerCount = 0;
+    _active = nullptr;
+    _depth = _arrayDepth = 0;
+    _inString = _escape = _afterColon = _inNumber = false;
+    _unicodeSkip = 0;
+    _keyLen = _numberLen = 0;
+    _keyTruncated = false;
+    _scanned = 0;
+  }
+
+  // Add a listener, up to two per response
+  bool watch(Listener& listener) {
+    if (_listenerCount == _maxListeners) return false;
+    _listeners[_listenerCount++] = &listener;
+    return true;
+  }
+
+  uint32_t scannedBytes() { return _scanned; }
+
+  // Stream, bytes are scanned as the reader consumes them
+  int available() override { return _source->available(); }
+  int peek() override { return _source->peek(); }
+  int read() override {
+    int c = _source->read();
+    if (c >= 0) scan(c);
+    return c;
+  }
+  using Stream::readBytes;
+  size_t readBytes(char* buffer, size_t length) override {
+    size_t count = _source->readBytes(buffer, length);
+    for (size_t i = 0; i < count; i++) scan(buffer[i]);
+    return count;
+  }
+  size_t write(uint8_t) override { return 0; }
+};
+
+#endif  // JSONTAP_H
@@ -9,6 +9,9 @@
 
     begin() must be called once, after WiFi is initialized.
 
+    syncCount() counts SNTP synchronizations (from the SNTP sync callback). Zero until
+    the first sync. lastSync() returns the epoch of the most recent sync.
+
     now(*timeinfo_p) fills in struct tm with current time. Doesn't update stored time.
     now(String &time) updates String with asciitime(). Doe not update stored time.
     storeCurrentTime() saves current time in private tm struct.
@@ -20,15 +23,354 @@
 #include <Arduino.h>
 #include <WiFi.h>
 
+#include "esp_sntp.h"
+
+/*----------------------------------------------------------------
+  Cached local time conversion
+
+    Parses a POSIX TZ string (TZ_STRING) once and caches the DST transition times for
+    the current year. Converting an epoch to local time is then a range check plus
+    days-to-civil arithmetic, with no TZ rule evaluation. The cache is refreshed only
+    when a time outside the cached year is converted.
+
+    Replaces localtime()/strftime() on display paths. localtime() is not reentrant and
+    is called from more than one task.
+
+    toLocal(t, &lt) fills in LocalTm for epoch t.
+    format(buf, len, t, fmt) is a reentrant, allocation free strftime() subset:
+      %a %b %d %e %H %I %M %S %p %m %y %Y %%
+    transitionAfter(t) returns the next DST change after t (0 if no DST)
+
+    Supports Mm.w.d, Jn and n transition rules, e.g. "CST6CDT,M3.2.0,M11.1.0".
+    Malformed strings fall back to UTC.
+*/
+
+struct LocalTm {
+  int16_t year;    // e.g. 2024
+  uint8_t month;   // 1-12
+  uint8_t mday;    // 1-31
+  uint8_t wday;    // 0-6, Sunday = 0
+  uint8_t hour;    // 0-23
+  uint8_t minute;  // 0-59
+  uint8_t second;  // 0-59
+  bool isDst;
+};
+
+class TzConverter {
+ private:
+  // One transition rule (",M3.2.0/2")
+  struct Rule {
+    char type = 0;     // 'M', 'J' or 'D' (zero based day)
+    int16_t day = 0;   // J/D: day number, M: day of week
+    uint8_t month = 0;
+    uint8_t week = 0;
+    int32_t time = 7200;  // Seconds after local midnight
+  };
+
+  // Conversion context for one UTC year
+  struct Context {
+    time_t yearStart = 1;  // UTC range this context is valid for; empty until first refresh
+    time_t yearEnd = 0;
+    time_t dstStart = 0;  // UTC transition times in this year
+    time_t dstEnd = 0;
+  };
+
+  int32_t _stdOffset = 0;  // Seconds east of UTC
+  int32_t _dstOffset = 0;
+  bool _hasDst = false;
+  bool _valid = false;
+  Rule _start, _end;
+  Context _ctx;
+  portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+  static const char *skipName(const char *p) {
+    if (*p == '<') {
+      while (*p && *p != '>') p++;
+      return *p ? p + 1 : nullptr;
+    }
+    const char *begin = p;
+    while (isalpha((unsigned char)*p)) p++;
+    return (p - begin) >= 3 ? p : nullptr;
+  }
+
+  // [+-]hh[:mm[:ss]] in seconds
+  static const char *parseTime(const char *p, int32_t *seconds) {
+    int sign = 1;
+    if (*p == '+' || *p == '-') sign = (*p++ == '-') ? -1 : 1;
+    if (!isdigit((unsigned char)*p)) return nullptr;
+    int32_t fields[3] = {0, 0, 0};
+    for (int i = 0; i < 3; i++) {
+      while (isdigit((unsigned char)*p)) fields[i] = fields[i] * 10 + (*p++ - '0');
+      if (i < 2 && *p == ':' && isdigit((unsigned char)p[1]))
+        p++;
+      else
+        break;
+    }
+    *seconds = sign * (fields[0] * 3600 + fields[1] * 60 + fields[2]);
+    return p;
+  }
+
+  static const char *parseNumber(const char *p, int16_t *value) {
+    if (!isdigit((unsigned char)*p)) return nullptr;
+    *value = 0;
+    while (isdigit((unsigned char)*p)) *value = *value * 10 + (*p++ - '0');
+    return p;
+  }
+
+  static const char *parseRule(const char *p, Rule *rule) {
+    int16_t n;
+    if (*p == 'M') {
+      rule->type = 'M';
+      if (!(p = parseNumber(p + 1, &n)) || n < 1 || n > 12 || *p != '.') return nullptr;
+      rule->month = n;
+      if (!(p = parseNumber(p + 1, &n)) || n < 1 || n > 5 || *p != '.') return nullptr;
+      rule->week = n;
+      if (!(p = parseNumber(p + 1, &n)) || n > 6) return nullptr;
+      rule->day = n;
+    } else if (*p == 'J') {
+      rule->type = 'J';
+      if (!(p = parseNumber(p + 1, &rule->day)) || rule->day < 1 || rule->day > 365) return nullptr;
+    } else {
+      rule->type = 'D';
+      if (!(p = parseNumber(p, &rule->day)) || rule->day > 365) return nullptr;
+    }
+    rule->time = 7200;
+    if (*p == '/') p = parseTime(p + 1, &rule->time);
+    return p;
+  }
+
+  static bool isLeap(int32_t y) { return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0; }
+
+  static void civilFromDays(int32_t z, int32_t *y, uint8_t *m, uint8_t *d) {
+    z += 719468;
+    const int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const uint32_t doe = (uint32_t)(z - era * 146097);
+    const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const uint32_t mp = (5 * doy + 2) / 153;
+    *d = doy - (153 * mp + 2) / 5 + 1;
+    *m = mp < 10 ? mp + 3 : mp - 9;
+    *y = (int32_t)yoe + era * 400 + (*m <= 2);
+  }
+
+  // Local midnight (as days since epoch) of the day a rule fires in year y
+  static int32_t ruleDay(const Rule &rule, int32_t y) {
+    int32_t jan1 = daysFromCivil(y, 1, 1);
+    if (rule.type == 'J') return jan1 + rule.day - 1 + ((isLeap(y) && rule.day >= 60) ? 1 : 0);
+    if (rule.type == 'D') return jan1 + rule.day;
+    // Mm.w.d: day d of week w of month m, week 5 means last
+    int32_t first = daysFromCivil(y, rule.month, 1);
+    int32_t firstWday = ((first % 7) + 11) % 7;  // 1970-01-01 was a Thursday
+    int32_t day = first + (rule.day - firstWday + 7) % 7 + (rule.week - 1) * 7;
+    static const uint8_t monthDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    int32_t lastDay = first + monthDays[rule.month - 1] + ((rule.month == 2 && isLeap(y)) ? 1 : 0) - 1;
+    while (day > lastDay) day -= 7;
+    return day;
+  }
+
+  // Build conversion context for the UTC year containing t
+  Context buildContext(time_t t) const {
+    Context ctx;
+    int32_t y;
+    uint8_t m, d;
+    int32_t days = (int32_t)(t >= 0 ? t / 86400 : (t - 86399) / 86400);
+    civilFromDays(days, &y, &m, &d);
+    ctx.yearStart = (time_t)daysFromCivil(y, 1, 1) * 86400;
+    ctx.yearEnd = (time_t)daysFromCivil(y + 1, 1, 1) * 86400;
+    if (_hasDst) {
+      // Start rule time is in standard time, end rule time is in daylight time
+      ctx.dstStart = (time_t)ruleDay(_start, y) * 86400 + _start.time - _stdOffset;
+      ctx.dstEnd = (time_t)ruleDay(_end, y) * 86400 + _end.time - _dstOffset;
+    }
+    return ctx;
+  }
+
+  Context context(time_t t) {
+    portENTER_CRITICAL(&_mux);
+    Context ctx = _ctx;
+    portEXIT_CRITICAL(&_mux);
+    if (t < ctx.yearStart || t >= ctx.yearEnd) {
+      ctx = buildContext(t);
+      portENTER_CRITICAL(&_mux);
+      _ctx = ctx;
+      portEXIT_CRITICAL(&_mux);
+    }
+    return ctx;
+  }
+
+  static bool inDst(const Context &ctx, time_t t) {
+    if (ctx.dstStart < ctx.dstEnd) return t >= ctx.dstStart && t < ctx.dstEnd;
+    return t >= ctx.dstStart || t < ctx.dstEnd;  // Southern hemisphere
+  }
+
+  static char *put2(char *out, char *end, int v, char pad = '0') {
+    if (end - out >= 2) {
+      *out++ = v >= 10 ? '0' + v / 10 : pad;
+      *out++ = '0' + v % 10;
+    }
+    return out;
+  }
+
+ public:
+  TzConverter(const char *tz) { setTz(tz); }
+
+  // Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's algorithm)
+  static int32_t daysFromCivil(int32_t y, uint32_t m, uint32_t d) {
+    y -= m <= 2;
+    const int32_t era = (y >= 0 ? y : y - 399) / 400;
+    const uint32_t yoe = (uint32_t)(y - era * 400);
+    const uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+  }
+
+  // Parse POSIX TZ string. Returns false (and uses UTC) if malformed.
+  bool setTz(const char *tz) {
+    const char *p = skipName(tz);
+    int32_t offset = 0;
+    bool hasDst = false;
+    Rule start, end;
+    if (p) p = parseTime(p, &offset);
+    int32_t dstOffset = -offset + 3600;
+    if (p && *p) {
+      hasDst = true;
+      p = skipName(p);
+      if (p && *p && *p != ',') {
+        int32_t o;
+        p = parseTime(p, &o);
+        dstOffset = -o;
+      }
+      if (p && *p == ',') p = parseRule(p + 1, &start);
+      else p = nullptr;
+      if (p && *p == ',') p = parseRule(p + 1, &end);
+      else p = nullptr;
+      if (p && *p) p = nullptr;
+    }
+
+    portENTER_CRITICAL(&_mux);
+    _valid = (p != nullptr);
+    _stdOffset = _valid ? -offset : 0;
+    _dstOffset = _valid ? dstOffset : 0;
+    _hasDst = _valid && hasDst;
+    _start = start;
+    _end = end;
+    _ctx = Context();
+    portEXIT_CRITICAL(&_mux);
+    return _valid;
+  }
+
+  bool valid() { return _valid; }
+
+  // Seconds east of UTC in effect at time t
+  int32_t utcOffset(time_t t) {
+    if (!_hasDst) return _stdOffset;
+    return inDst(context(t), t) ? _dstOffset : _stdOffset;
+  }
+
+  // Next DST transition strictly after t. Returns 0 if zone has no DST.
+  time_t transitionAfter(time_t t) {
+    if (!_hasDst) return 0;
+    time_t year = t;
+    for (int i = 0; i < 2; i++) {
+      Context ctx = buildContext(year);
+      time_t first = ctx.dstStart < ctx.dstEnd ? ctx.dstStart : ctx.dstEnd;
+      time_t second = ctx.dstStart < ctx.dstEnd ? ctx.dstEnd : ctx.dstStart;
+      if (first > t) return first;
+      if (second > t) return second;
+      year = ctx.yearEnd;  // Check next year
+    }
+    return 0;
+  }
+
+  void toLocal(time_t t, LocalTm *lt) {
+    lt->isDst = _hasDst && inDst(context(t), t);
+    time_t local = t + (lt->isDst ? _dstOffset : _stdOffset);
+    int32_t days = (int32_t)(local >= 0 ? local / 86400 : (local - 86399) / 86400);
+    int32_t secs = (int32_t)(local - (time_t)days * 86400);
+    int32_t y;
+    civilFromDays(days, &y, &lt->month, &lt->mday);
+    lt->year = y;
+    lt->wday = ((days % 7) + 11) % 7;
+    lt->hour = secs / 3600;
+    lt->minute = (secs / 60) % 60;
+    lt->second = secs % 60;
+  }
+
+  // Reentrant strftime() subset. Returns number of chars written, excluding terminator.
+  size_t format(char *buf, size_t len, time_t t, const char *fmt) {
+    static const char days[] = "SunMonTueWedThuFriSat";
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    if (len == 0) return 0;
+    LocalTm lt;
+    toLocal(t, &lt);
+    char *out = buf;
+    char *end = buf + len - 1;
+    for (; *fmt && out < end; fmt++) {
+      if (*fmt != '%') {
+        *out++ = *fmt;
+        continue;
+      }
+      switch (*++fmt) {
+        case 'a':
+          for (int i = 0; i < 3 && out < end; i++) *out++ = days[lt.wday * 3 + i];
+          break;
+        case 'b':
+          for (int i = 0; i < 3 && out < end; i++) *out++ = months[(lt.month - 1) * 3 + i];
+          break;
+        case 'd': out = put2(out, end, lt.mday); break;
+        case 'e': out = put2(out, end, lt.mday, ' '); break;
+        case 'H': out = put2(out, end, lt.hour); break;
+        case 'I': out = put2(out, end, lt.hour % 12 ? lt.hour % 12 : 12); break;
+        case 'M': out = put2(out, end, lt.minute); break;
+        case 'S': out = put2(out, end, lt.second); break;
+        case 'm': out = put2(out, end, lt.month); break;
+        case 'y': out = put2(out, end, lt.year % 100); break;
+        case 'Y':
+          out = put2(out, end, lt.year / 100);
+          out = put2(out, end, lt.year % 100);
+          break;
+        case 'p':
+          if (end - out >= 2) {
+            *out++ = lt.hour < 12 ? 'A' : 'P';
+            *out++ = 'M';
+          }
+          break;
+        case '%': *out++ = '%'; break;
+        case '\0': fmt--; break;
+        default: break;
+      }
+    }
+    *out = '\0';
+    return out - buf;
+  }
+};
+
+// Shared converter for display code. Safe to use from any task.
+TzConverter localTz(TZ_STRING);
+
 class Time {
  private:
   tm storedTime;  // Stores the last time from storeCurrentTime function
 
+  // Updated from SNTP task
+  static volatile uint32_t _syncCount;
+  static volatile time_t _lastSync;
+  static void onTimeSync(struct timeval *tv) {
+    _lastSync = tv->tv_sec;
+    _syncCount = _syncCount + 1;
+  }
+
  public:
   bool isTimeSet = false;  // Flag to check if time is set
 
   // Call once, after WiFi is initialized.
-  void begin() { configTzTime(TZ_STRING, NTP_SERVER_1, NTP_SERVER_2); }
+  void begin() {
+    sntp_set_time_sync_notification_cb(onTimeSync);
+    configTzTime(TZ_STRING, NTP_SERVER_1, NTP_SERVER_2);
+  }
+
+  uint32_t syncCount() { return _syncCount; }
+  time_t lastSync() { return _lastSync; }
 
   // Pass struct tm. Fill in struct with current time.
   bool now(tm *timeinfo_p) { return getLocalTime(timeinfo_p); }
@@ -113,4 +455,7 @@ class Time {
   }
 };
 
+volatile uint32_t Time::_syncCount = 0;
+volatile time_t Time::_lastSync = 0;
+
 #endif  // LOCALTIME_H
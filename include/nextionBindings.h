@@ -0,0 +1,265 @@
+#ifndef NEXTIONBINDINGS_H
+#define NEXTIONBINDINGS_H
+
+/*----------------------------------------------------------------
+  Nextion bindings: declarative map from owmWeather model fields to Nextion components
+
+    Each row binds one component attribute (a string literal built at compile time)
+    to a value encoder and a model slot (forecast day or hour), so no component
+    names are built at runtime.
+
+    To display another field, or a new page, add rows (or a NEX_* row macro) to a
+    table. Rows are written in table order.
+
+    renderChanged() walks a table with every slot shifted by an offset (e.g. the
+    first hour of a scrolled window), writing the rows whose value changed since
+    the last write. The last values are kept in a BindingShadow, one per table.
+    A row is recorded only once its write went out; a refused write is tried
+    again on the next render. Writes abandoned later (see lostWrites()) are
+    covered by a full repaint from loop().
+
+    Encoders:
+      NumEncoder - returns the value for a 'val'/'pic' attribute (writeNum)
+      TxtEncoder - returns text for a 'txt' attribute (writeStr), may format into buf
+*/
+
+#include "nextionInterface.h"
+#include "weather.h"
+
+typedef int32_t (*NumEncoder)(owmWeather&, uint8_t slot);
+typedef const char* (*TxtEncoder)(owmWeather&, uint8_t slot, char* buf, size_t size);
+
+struct NextionBinding {
+  const char* component;  // e.g. "page0.forecastMin1.val"
+  NumEncoder num;         // Exactly one of num / txt is set
+  TxtEncoder txt;
+  uint8_t slot;           // Forecast day / hour index passed to encoder
+};
+
+// Map openweathermap icon strings to Nextion picture ID's
+// See: https://openweathermap.org/weather-conditions
+struct WeatherIcon {
+  char code[4];   // Openweathermap icon
+  uint8_t large;  // Large Icons (Daily display)
+  uint8_t small;  // Small Icons (hourly display)
+};
+
+const WeatherIcon weatherIcons[] = {
+    {"01d", 14, 1},   // Clear day
+    {"01n", 11, 2},   // Clear Night
+    {"02d", 13, 8},   // Partly Cloudy Day
+    {"02n", 15, 9},   // Party Cloudy Night
+    {"03d", 5, 20},   // Cloudy Day
+    {"03n", 5, 20},   // Cloudy Night
+    {"04d", 10, 21},  // Cloudy Daylight
+    {"04n", 10, 21},  // Cloudy Night
+    {"09d", 4, 22},   // Showers Day
+    {"09n", 4, 22},   // Showers Night
+    {"10d", 4, 22},   // Rain Day
+    {"10n", 4, 22},   // Rain Night
+    {"11d", 12, 23},  // Thunderstorm Day
+    {"11n", 12, 23},  // Thunderstorm Night
+    {"13d", 7, 24},   // Snow Day
+    {"13n", 7, 24},   // Snow Night
+    {"50d", 0, 25},   // Mist Day
+    {"50n", 0, 25},   // Mist Night
+};
+
+inline const WeatherIcon* findWeatherIcon(const char* iconTxt) {
+  for (const auto& icon : weatherIcons) {
+    if (strcmp(icon.code, iconTxt) == 0) return &icon;
+  }
+  return nullptr;
+}
+
+// Large Icons (Daily display)
+inline int weatherIconToNextionPictureLarge(const char* iconTxt) {
+  const WeatherIcon* icon = findWeatherIcon(iconTxt);
+  return icon ? icon->large : 0;
+}
+
+// Small Icons (hourly display)
+inline int weatherIconToNextionPictureSmall(const char* iconTxt) {
+  const WeatherIcon* icon = findWeatherIcon(iconTxt);
+  return icon ? icon->small : 0;
+}
+
+// Value encoders
+namespace nexEncode {
+
+// Current conditions
+inline int32_t humidity(owmWeather& w, uint8_t) { return w.currentHumidity(); }
+inline int32_t windSpeed(owmWeather& w, uint8_t) { return w.currentWindSpeed(); }
+inline int32_t windDirection(owmWeather& w, uint8_t) { return w.currentWindDirection(); }
+inline int32_t currentIcon(owmWeather& w, uint8_t) { return weatherIconToNextionPictureLarge(w.currentWeatherIcon()); }
+inline const char* description(owmWeather& w, uint8_t, char*, size_t) { return w.currentWeatherDescription(); }
+inline const char* cityName(owmWeather& w, uint8_t, char*, size_t) { return w.cityName(); }
+// Time of the data shown, or why the last fetch for this location failed
+inline const char* weatherStatus(owmWeather& w, uint8_t, char* buf, size_t size) {
+  if (w.fetchStatus() == -1) return "Wifi Disconnected";
+  if (w.fetchStatus() != 200) return "OW Call Fail";
+  localTz.format(buf, size, w.observationTime(), "OW: %a %H:%M");
+  return buf;
+}
+
+// Next hour precipitation, e.g. "Rain in 12 min, up to 2.5 mm/h"
+inline const char* nowcast(owmWeather& w, uint8_t, char* buf, size_t size) {
+  return w.nowcast().describe(buf, size, time(nullptr));
+}
+
+// Alert in force (or next), e.g. "Tornado Warning until Tue 18:45 (+1)"
+inline const char* alertBanner(owmWeather& w, uint8_t, char* buf, size_t size) {
+  const AlertStore& alerts = w.alerts();
+  const WeatherAlert* alert = alerts.current(time(nullptr));
+  if (!alert) return "";
+  char until[16] = "";
+  if (alert->end) localTz.format(until, sizeof(until), alert->end, " until %a %H:%M");
+  uint8_t others = alerts.count - 1 + alerts.dropped;
+  if (others)
+    snprintf(buf, size, "%s%s (+%u)", alert->event, until, others);
+  else
+    snprintf(buf, size, "%s%s", alert->event, until);
+  return buf;
+}
+// Kept for resend like any other write, see NEXTION_CMD_MAX
+static_assert(sizeof("page0.alertText.txt=\"\"") - 1 + ALERT_DESCRIPTION_SIZE - 1 <= NEXTION_CMD_MAX,
+              "alert description too long for the ack window");
+inline const char* alertDetail(owmWeather& w, uint8_t, char* buf, size_t) {
+  const WeatherAlert* alert = w.alerts().current(time(nullptr));
+  return alert ? alert->description : "";
+}
+
+// Daily forecast
+inline const char* dayOfWeek(owmWeather& w, uint8_t i, char* buf, size_t size) {
+  return w.forecastDayofWeek(i, buf, size);
+}
+inline const char* forecastText(owmWeather& w, uint8_t i, char*, size_t) { return w.forecastDescription(i); }
+inline int32_t forecastMin(owmWeather& w, uint8_t i) { return w.forecastTempMin(i); }
+inline int32_t forecastMax(owmWeather& w, uint8_t i) { return w.forecastTempMax(i); }
+inline int32_t forecastIcon(owmWeather& w, uint8_t i) { return weatherIconToNextionPictureLarge(w.forecastIcon(i)); }
+
+// Hourly forecast
+inline const char* hourText(owmWeather& w, uint8_t i, char* buf, size_t size) {
+  return w.hourlyHourofDayText(i, buf, size);
+}
+inline int32_t hourlyTemp(owmWeather& w, uint8_t i) { return w.hourlyTemp(i); }
+inline int32_t hourlyIcon(owmWeather& w, uint8_t i) {
+  char icon[4];
+  return weatherIconToNextionPictureSmall(w.hourlyIcon(i, icon));
+}
+inline int32_t hourlyPop(owmWeather& w, uint8_t i) { return w.hourlyPop(i); }
+
+// Convert rain mm/hr into 0-100 integer for Nextion progress bars
+// Consider 5mm/hr to be full scale
+inline int32_t hourlyRain(owmWeather& w, uint8_t i) {
+  int rain = (int)(w.hourlyPcpt(i) * 20);
+  if (rain > 100) rain = 100;
+  if (rain > 0 && rain <= 5) rain = 5;
+  return rain;
+}
+
+}  // namespace nexEncode
+
+// Row helpers. n is the 1-based Nextion component number, model slot is n - 1.
+#define NEX_NUM(component, encoder) {component, nexEncode::encoder, nullptr, 0}
+#define NEX_TXT(component, encoder) {component, nullptr, nexEncode::encoder, 0}
+
+#define NEX_DAILY(n)                                                         \
+  {"page0.dateTime" #n ".txt", nullptr, nexEncode::dayOfWeek, n - 1},        \
+  {"page0.forecastTxt" #n ".txt", nullptr, nexEncode::forecastText, n - 1},  \
+  {"page0.forecastMin" #n ".val", nexEncode::forecastMin, nullptr, n - 1},   \
+  {"page0.forecastMax" #n ".val", nexEncode::forecastMax, nullptr, n - 1},   \
+  {"page0.forecastIcon" #n ".pic", nexEncode::forecastIcon, nullptr, n - 1}
+
+#define NEX_HOURLY_HEADING(n) {"Hourly.hour" #n ".txt", nullptr, nexEncode::hourText, n - 1}
+
+#define NEX_HOURLY(n)                                                     \
+  {"Hourly.temp" #n ".val", nexEncode::hourlyTemp, nullptr, n - 1},       \
+  {"Hourly.clouds" #n ".pic", nexEncode::hourlyIcon, nullptr, n - 1},     \
+  {"Hourly.pop" #n ".val", nexEncode::hourlyPop, nullptr, n - 1},         \
+  {"Hourly.pcpt" #n ".val", nexEncode::hourlyRain, nullptr, n - 1}
+
+// Everything written after a successful weather update
+const NextionBinding weatherBindings[] = {
+    NEX_NUM("page0.humidity.val", humidity),
+    NEX_TXT("page0.wxDescription.txt", description),
+    NEX_NUM("page0.windSpeed.val", windSpeed),
+    NEX_NUM("page0.windDirection.val", windDirection),
+    NEX_TXT("page0.City.txt", cityName),
+    NEX_NUM("page0.wxIcon.pic", currentIcon),
+    NEX_TXT("page0.statusTxt.txt", weatherStatus),
+    NEX_TXT("Setup.WeatherStatus.txt", weatherStatus),
+#ifdef OW_NOWCAST
+    NEX_TXT("page0.nowcast.txt", nowcast),
+#endif
+#ifdef OW_ALERTS
+    NEX_TXT("page0.alert.txt", alertBanner),
+    NEX_TXT("page0.alertText.txt", alertDetail),
+#endif
+
+    // Five daily forecasts
+    NEX_DAILY(1), NEX_DAILY(2), NEX_DAILY(3), NEX_DAILY(4), NEX_DAILY(5),
+};
+
+// Hourly page, a 12 hour window. Slots are offset by the first hour shown, see renderChanged().
+#define HOURLY_WINDOW 12
+const NextionBinding hourlyBindings[] = {
+    // Hourly forecast heading
+    NEX_HOURLY_HEADING(1), NEX_HOURLY_HEADING(5), NEX_HOURLY_HEADING(9),
+
+    // 12 hourly forecasts
+    NEX_HOURLY(1), NEX_HOURLY(2), NEX_HOURLY(3), NEX_HOURLY(4), NEX_HOURLY(5), NEX_HOURLY(6),
+    NEX_HOURLY(7), NEX_HOURLY(8), NEX_HOURLY(9), NEX_HOURLY(10), NEX_HOURLY(11), NEX_HOURLY(12),
+};
+
+// Last value written for each row of a table (number, or hash of text)
+template <size_t N>
+struct BindingShadow {
+  uint32_t values[N];
+  bool known[N] = {};  // Row's value went out to the display
+  bool valid = false;
+
+  void invalidate() { valid = false; }
+  // Row needs writing: all rows invalid, row never written or its last write refused, or value changed
+  bool changed(size_t row, uint32_t value) const { return !valid || !known[row] || values[row] != value; }
+  void wrote(size_t row, uint32_t value, bool ok) {
+    values[row] = value;
+    known[row] = ok;
+  }
+};
+
+// FNV-1a, to notice changed text without keeping it
+inline uint32_t textHash(const char* text) {
+  uint32_t hash = 2166136261u;
+  while (*text) hash = (hash ^ (uint8_t)*text++) * 16777619u;
+  return hash;
+}
+
+// Write the rows of a table whose value changed, with every slot moved by offset.
+// Returns number of rows written.
+template <size_t N>
+uint16_t renderChanged(myNextionInterface& nex, owmWeather& weather, const NextionBinding (&table)[N],
+                       uint8_t offset, BindingShadow<N>& shadow) {
+  char buf[40];
+  uint16_t written = 0;
+  for (size_t row = 0; row < N; row++) {
+    const NextionBinding& binding = table[row];
+    uint8_t slot = binding.slot + offset;
+    uint32_t value;
+    const char* text = nullptr;
+    if (binding.num) {
+      value = (uint32_t)binding.num(weather, slot);
+    } else {
+      text = binding.txt(weather, slot, buf, sizeof(buf));
+      value = textHash(text);
+    }
+    if (!shadow.changed(row, value)) continue;
+    bool ok = text ? nex.writeStr(binding.component, text) : nex.writeNum(binding.component, (int32_t)value);
+    shadow.wrote(row, value, ok);
+    written++;
+  }
+  shadow.valid = true;
+  return written;
+}
+
+#endif  // NEXTIONBINDINGS_H
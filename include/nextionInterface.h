@@ -4,6 +4,21 @@
 #include <Arduino.h>
 #include "settings.h"
 
+// Acknowledged writes (bkcmd=3), see enableAcks()
+#define NEXTION_ACK_WINDOW 8         // Max commands in flight
+#define NEXTION_ACK_TIMEOUT_MS 250   // Unacknowledged command is resent after this
+#define NEXTION_ACK_RETRIES 2        // Resends per command before giving up
+#define NEXTION_CMD_MAX 192          // Longest command kept for resend, excl. terminator. Fits an alert description.
+#define NEXTION_PRIORITY_SLOTS 2     // Window slots only priority writes may use
+#define NEXTION_PRIORITY_QUEUE 4     // Priority commands waiting for the serial port
+#define NEXTION_REPAINT_MS 10000     // Shortest time between repaints after lost writes, see lostWrites()
+
+#ifndef NEXTION_MAX_BAUD
+#define NEXTION_MAX_BAUD 921600      // Fastest rate begin() tries, see settings-dist.h
+#endif
+
+static_assert(NEXTION_CMD_MAX <= 255, "InFlight::length is a uint8_t");
+
 /// @brief Class to handle communication with Nextion device.
 /// @param serial Serial port to which Nextion is attached
 /// @param baud Baud rate to be used for communication with Nextion
@@ -17,20 +32,150 @@ class myNextionInterface {
   SemaphoreHandle_t _xSerialWriteSemaphore =  NULL;
   SemaphoreHandle_t _xSerialReadSemaphore = NULL;
 
+  bool ping();
+  bool findBaud();
+  void setLocalBaud(unsigned long);
+
+  // Transmit statistics since boot
+  uint32_t _txBytes = 0;
+  uint32_t _txCommands = 0;
+
+  // Receive frame assembly, shared by listen(), getNum() and ack polling. Read semaphore held.
+  uint8_t _rxFrame[64];
+  uint16_t _rxLen = 0;
+  uint8_t _rxTerminators = 0;
+  int readFrame(unsigned long);
+  bool isReturnCode(int);
+
+  // Display state from event frames seen by readFrame()
+  volatile bool _sleeping = false;
+  volatile uint32_t _wakes = 0;    // Auto wake (0x87) events
+  volatile uint32_t _readies = 0;  // Power on / reset (0x88) events
+  void noteEvent(uint8_t);
+
+  // Event frames read while polling for acks, returned by next listen()
+  static const uint8_t _stashSize = 4;
+  uint8_t _stash[_stashSize][16];
+  uint8_t _stashLen[_stashSize];
+  uint8_t _stashCount = 0;
+  void stashFrame(int);
+
+  // Commands in flight. Acks arrive in send order and are matched to the oldest awaiting command.
+  // A matched command stays acked, not free, until every command sent has had its return code:
+  // only then is the match known to be right. A timeout means a command or a return code was
+  // lost somewhere, so the whole window is resynchronised (see checkTimeouts()).
+  enum SlotState : uint8_t { slotFree, slotAwaiting, slotAcked, slotResend, slotResync };
+  struct InFlight {
+    char command[NEXTION_CMD_MAX];
+    uint8_t length;   // 0 if command was too long to keep, can't be resent
+    uint8_t retries;
+    bool superseded;  // Same component written again since, don't resend
+    SlotState state;
+    uint32_t sequence;
+    unsigned long sentMicros;
+  };
+  InFlight _window[NEXTION_ACK_WINDOW + NEXTION_PRIORITY_SLOTS] = {};
+  uint32_t _sequence = 0;
+  volatile bool _acks = false;
+  volatile uint32_t _lostWrites = 0;
+
+  // Resync marker: a 'get' of a constant, its reply ends the return codes of everything sent before it
+  bool _resyncDue = false;     // Marker to be written
+  uint32_t _resyncNonce = 0;   // Value the marker in flight returns, 0 if none
+  uint16_t _markers = 0;
+  uint8_t _resyncTries = 0;
+  unsigned long _resyncMicros = 0;
+  portMUX_TYPE _windowMux = portMUX_INITIALIZER_UNLOCKED;
+
+  // Priority commands, written ahead of any normal command not yet sent
+  char _priority[NEXTION_PRIORITY_QUEUE][NEXTION_CMD_MAX + 1];
+  uint8_t _priorityCount = 0;
+
+  bool send(const char* const[], uint8_t, bool);
+  InFlight* freeSlot(uint8_t);
+  void transmit(const char* const[], uint8_t, InFlight*);
+  bool queuePriority(const char* const[], uint8_t);
+  void sendPriority();
+  void processAck(uint8_t);
+  void retryOrDrop(InFlight&);
+  void releaseAcked();
+  void markResync();
+  void sendMarker();
+  bool takeMarker(int);
+  void checkTimeouts();
+  int pollAcks(TickType_t);
+  void resendPending();
+  bool waitForAcks(unsigned long);
+  void clearWindow();
 
  public:
   myNextionInterface(HardwareSerial&, unsigned long);
 
   bool begin();
+  unsigned long negotiateBaud(unsigned long);
   void flushReads();
+  void flushWrites();
+
+  bool writeNum(const char*, int32_t);
+  bool writeStr(const char*, const char*);
+  bool writeCmd(const char*);
+  bool writeStrPriority(const char*, const char*);
+  bool writeCmdPriority(const char*);
+
+  bool writeNum(const String& name, int32_t val) { return writeNum(name.c_str(), val); }
+  bool writeStr(const String& name, const String& txt) { return writeStr(name.c_str(), txt.c_str()); }
+  bool writeCmd(const String& command) { return writeCmd(command.c_str()); }
 
-  bool writeNum(const String&, uint32_t);
-  bool writeStr(const String&, const String&); 
-  bool writeCmd(const String&);
+  bool getNum(const String&, int32_t&);
 
   bool setRTC(const tm);
+  bool getRTC(tm&);
 
   int listen(std::string&, uint8_t);
+
+  bool enableAcks(bool);
+  bool reinitAcks();
+  bool acksEnabled() { return _acks; }
+
+  // Sleep state, from auto sleep (0x86) / wake (0x87) events. A wake or reset bumps its count.
+  bool sleeping() { return _sleeping; }
+  uint32_t wakeCount() { return _wakes; }
+  uint32_t readyCount() { return _readies; }
+
+  // Writes refused (serial port or window busy too long) or abandoned since boot. When this
+  // moves the display may show stale values, repaint it.
+  uint32_t lostWrites() { return _lostWrites; }
+
+  // Acknowledged write statistics since enableAcks(true)
+  struct AckStats {
+    uint32_t acked;        // Success (0x01) returns
+    uint32_t failed;       // Error returns (invalid component, variable, ...)
+    uint32_t timeouts;     // No return within NEXTION_ACK_TIMEOUT_MS
+    uint32_t resent;       // Commands retransmitted
+    uint32_t abandoned;    // Gave up after NEXTION_ACK_RETRIES
+    uint32_t stray;        // Returns with nothing in flight
+    uint32_t resyncs;      // Windows resent after a timeout
+    uint32_t discarded;    // Returns thrown away while resynchronising
+    uint32_t windowStalls; // Writes that waited for a free window slot
+    uint32_t refused;      // Writes given up with the window full
+    uint32_t priority;     // Priority commands sent
+    uint32_t rttMaxMicros;
+    uint64_t rttTotalMicros;
+    uint8_t lastError;     // Last error return code
+  };
+  AckStats ackStats() {
+    portENTER_CRITICAL(&_windowMux);
+    AckStats stats = _ackStats;
+    portEXIT_CRITICAL(&_windowMux);
+    return stats;
+  }
+
+  uint32_t txBytes() { return _txBytes; }
+  uint32_t txCommands() { return _txCommands; }
+  unsigned long baud() { return _baud; }
+
+ private:
+  AckStats _ackStats = {};
 };
 
 #endif  // NEXTIONINTERFACE_H
\ No newline at end of file
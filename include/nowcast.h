@@ -0,0 +1,92 @@
+#ifndef NOWCAST_H
+#define NOWCAST_H
+
+/*----------------------------------------------------------------
+  Nowcast: minutely precipitation folded into a summary while the response streams by
+
+    OneCall 'minutely' is 60 entries of {"dt": ..., "precipitation": mm/h}. Rather
+    than keep them in the JSON document, the JSON filter drops 'minutely' and
+    NowcastFold, a JsonTap listener, folds each entry into a Nowcast as the parser
+    reads past it:
+
+      onset  - first minute with precipitation (0 if none)
+      stop   - first dry minute after onset (0 if it rains to the end)
+      peak   - highest rate (mm/h)
+      total  - expected amount over the window (mm)
+
+    The fold keeps the summary and the entry being read, independent of response size.
+*/
+
+#include <Arduino.h>
+#include <time.h>
+
+#include "jsonTap.h"
+
+#define NOWCAST_RAIN_THRESHOLD 0.1f  // mm/h counted as precipitation
+
+struct Nowcast {
+  time_t start;   // First minute in the window, 0 if no minutely data
+  time_t onset;   // First wet minute
+  time_t stop;    // First dry minute after onset
+  float peak;     // mm/h
+  float total;    // mm
+  uint8_t minutes;
+
+  // Text for display, e.g. "Rain in 12 min, up to 2.5 mm/h"
+  const char* describe(char* buf, size_t size, time_t now) const {
+    if (!start) {
+      strlcpy(buf, "", size);
+    } else if (!onset) {
+      strlcpy(buf, "No rain next hour", size);
+    } else if (onset > now + 30) {
+      snprintf(buf, size, "Rain in %ld min, up to %.1f mm/h", (long)((onset - now + 30) / 60), peak);
+    } else if (stop) {
+      long minutes = stop > now ? (long)((stop - now + 30) / 60) : 0;
+      snprintf(buf, size, "Rain stopping in %ld min", minutes);
+    } else {
+      snprintf(buf, size, "Rain next hour, %.1f mm", total);
+    }
+    return buf;
+  }
+};
+
+// Folds the "minutely" array of a response, see JsonTap
+class NowcastFold : public JsonTap::Listener {
+ private:
+  Nowcast _nowcast = {};
+  time_t _entryTime = 0;
+  float _entryRate = 0;
+
+ public:
+  NowcastFold() : Listener("minutely") {}
+
+  void reset() { _nowcast = {}; }
+  const Nowcast& result() { return _nowcast; }
+
+  void beginEntry() override {
+    _entryTime = 0;
+    _entryRate = 0;
+  }
+
+  void number(const char* key, const char* text) override {
+    if (strcmp(key, "dt") == 0) {
+      _entryTime = (time_t)atoll(text);
+    } else if (strcmp(key, "precipitation") == 0) {
+      _entryRate = atof(text);
+    }
+  }
+
+  void endEntry() override {
+    if (!_entryTime) return;
+    Nowcast& n = _nowcast;
+    if (!n.start) n.start = _entryTime;
+    n.minutes++;
+    bool wet = _entryRate >= NOWCAST_RAIN_THRESHOLD;
+    if (wet && !n.onset) n.onset = _entryTime;
+    if (!wet && n.onset && !n.stop) n.stop = _entryTime;
+    if (_entryRate > n.peak) n.peak = _entryRate;
+    n.total += _entryRate / 60;
+  }
+};
+
+#endif  // NOWCAST_H
@@ -0,0 +1,53 @@
+#ifndef OWMFILTER_H
+#define OWMFILTER_H
+
+/*----------------------------------------------------------------
+  What a OneCall response is parsed into
+
+    owmFilter(filter) fills in the ArduinoJSON filter document with the fields
+    owmWeather reads. 'minutely' and 'alerts' are left out, JsonTap folds them as
+    they stream past (see jsonTap.h). The filtered document is parsed into a
+    MonotonicArena of WEATHER_ARENA_SIZE bytes (see arena.h).
+
+    Kept apart from weather.h, which needs HTTP and TLS, so the host tests parse
+    with the same filter and arena (see test/test_arena).
+*/
+
+#include <ArduinoJson.h>
+
+// Fixed buffer for parsing one OneCall response, reused every refresh
+#define WEATHER_ARENA_SIZE 24576  // Full response with 48 hourly entries
+
+inline void owmFilter(JsonDocument &filter) {
+  filter["lon"] = true;
+  filter["lat"] = true;
+  filter["current"]["weather"][0]["id"] = true;
+  filter["current"]["weather"][0]["main"] = true;
+  filter["current"]["weather"][0]["icon"] = true;
+  filter["current"]["weather"][0]["description"] = true;
+  filter["current"]["temp"] = true;
+  filter["current"]["feels_like"] = true;
+  filter["current"]["pressure"] = true;
+  filter["current"]["humidity"] = true;
+  filter["current"]["wind_speed"] = true;
+  filter["current"]["wind_deg"] = true;
+  filter["current"]["clouds"] = true;
+  filter["current"]["dt"] = true;
+
+  filter["hourly"][0]["dt"] = true;
+  filter["hourly"][0]["temp"] = true;
+  filter["hourly"][0]["clouds"] = true;
+  filter["hourly"][0]["pop"] = true;
+  filter["hourly"][0]["weather"][0]["icon"] = true;
+  filter["hourly"][0]["rain"]["1h"] = true;
+
+  filter["daily"][0]["dt"] = true;
+  filter["daily"][0]["temp"]["min"] = true;
+  filter["daily"][0]["temp"]["max"] = true;
+  filter["daily"][0]["weather"][0]["id"] = true;
+  filter["daily"][0]["weather"][0]["main"] = true;
+  filter["daily"][0]["weather"][0]["description"] = true;
+  filter["daily"][0]["weather"][0]["icon"] = true;
+}
+
+#endif  // OWMFILTER_H
@@ -0,0 +1,137 @@
+#ifndef POWERMODEL_H
+#define POWERMODEL_H
+
+/*----------------------------------------------------------------
+  Energy model: mAh per day from how a station spends its time
+
+    estimatePower() turns time per state (loop idle, light sleep, BLE scan,
+    fetch, display on) into mAh/day for the station and the display, using the
+    POWER_MA_* currents below. PowerPlan::report() feeds it the time measured on
+    the station (see powerPlan.h).
+
+    simulateDay() builds that time for a configuration instead: display hours,
+    POWER_SAVE, tickless light sleep, scan and fetch schedule. So policies can be
+    compared offline, see test/test_power:
+
+      PowerPolicy policy = PowerPolicy::fromSettings(true);
+      policy.displayOnHours = 2;
+      PowerEstimate mah = estimatePower(simulateDay(policy), policy.scanDutyPermille);
+
+    The currents are typical figures for an ESP32 and a 3.5" Nextion. Measure
+    your own and adjust them. Pure arithmetic, no hardware dependency.
+*/
+
+#include <stdint.h>
+
+#include "settings.h"
+
+#ifndef POWER_SCAN_INTERVAL  // BLE scan with POWER_SAVE, ms, see settings-dist.h
+#define POWER_SCAN_INTERVAL 300
+#define POWER_SCAN_WINDOW 60
+#endif
+#ifndef DISPLAY_SLEEP_SLOWDOWN
+#define DISPLAY_SLEEP_SLOWDOWN 4
+#endif
+
+// Current estimates, mA
+#define POWER_MA_CPU 50             // CPU running, radios idle
+#define POWER_MA_IDLE 20            // CPU idle at 80 MHz, WiFi in modem sleep
+#define POWER_MA_LIGHT_SLEEP 2      // Light sleep, WiFi associated (DTIM wakeups included)
+#define POWER_MA_BLE_RX 95          // Added while a BLE scan window is open
+#define POWER_MA_WIFI 110           // Added while fetching
+#define POWER_MA_DISPLAY_AWAKE 145
+#define POWER_MA_DISPLAY_ASLEEP 15
+
+#define POWER_FETCH_SECONDS 3       // Typical OneCall fetch over TLS, for simulateDay()
+#define POWER_BUSY_PERMILLE 30      // CPU share at work with POWER_SAVE (render, parse), for simulateDay()
+
+#define POWER_SCAN_DUTY_SAVE (POWER_SCAN_WINDOW * 1000 / POWER_SCAN_INTERVAL)
+#define POWER_SCAN_DUTY_DEFAULT (37 * 1000 / 97)  // ruuvi.h defaults
+#ifdef POWER_SAVE
+#define POWER_SCAN_DUTY_PERMILLE POWER_SCAN_DUTY_SAVE
+#else
+#define POWER_SCAN_DUTY_PERMILLE POWER_SCAN_DUTY_DEFAULT
+#endif
+
+// Time per state over a period, microseconds. Radio time is on top of the CPU state.
+struct PowerSpent {
+  uint64_t period;
+  uint64_t idle;       // loop() blocked, CPU idle
+  uint64_t sleep;      // loop() blocked, light sleep
+  uint64_t scan;       // BLE scan running
+  uint64_t fetch;      // WiFi fetch running
+  uint64_t displayOn;
+};
+
+struct PowerEstimate {
+  uint32_t station;  // mAh/day
+  uint32_t display;  // mAh/day
+};
+
+inline PowerEstimate estimatePower(const PowerSpent& s, uint32_t scanDutyPermille) {
+  if (!s.period) return {0, 0};
+  // Charge in mA x microseconds
+  uint64_t resting = s.idle + s.sleep;
+  uint64_t busy = resting < s.period ? s.period - resting : 0;
+  uint64_t station = busy * POWER_MA_CPU + s.idle * POWER_MA_IDLE + s.sleep * POWER_MA_LIGHT_SLEEP +
+                     s.scan * POWER_MA_BLE_RX * scanDutyPermille / 1000 + s.fetch * POWER_MA_WIFI;
+  uint64_t displayOn = s.displayOn < s.period ? s.displayOn : s.period;
+  uint64_t display = displayOn * POWER_MA_DISPLAY_AWAKE + (s.period - displayOn) * POWER_MA_DISPLAY_ASLEEP;
+  return {(uint32_t)(station * 24 / s.period), (uint32_t)(display * 24 / s.period)};
+}
+
+// A station configuration for simulateDay()
+struct PowerPolicy {
+  bool powerSave;              // loop() blocks between jobs (POWER_SAVE)
+  bool lightSleep;             // Framework built with tickless idle, light sleep while the display sleeps
+  uint32_t displayOnHours;     // Of 24
+  uint32_t scanSeconds;        // BLE scan per cycle
+  uint32_t scanPeriodSeconds;  // Scan cycle while the display is on
+  uint32_t fetchSeconds;       // Radio time per fetch
+  uint32_t fetchPeriodSeconds; // Fetch cycle while the display is on, all locations
+  uint32_t sleepSlowdown;      // Scans and fetches this many times rarer while the display sleeps
+  uint32_t scanDutyPermille;   // BLE window / interval
+  uint32_t busyPermille;       // CPU at work with powerSave; without, loop() never idles
+
+  // This build's settings, with or without POWER_SAVE
+  static PowerPolicy fromSettings(bool powerSave) {
+    return {powerSave,
+            powerSave,
+            24,
+            RUUVI_SCAN_TIME,
+            HEARTBEAT_INTERVAL_MILLIS / 1000,
+            POWER_FETCH_SECONDS,
+            OW_SCAN_TIME * 60,
+            DISPLAY_SLEEP_SLOWDOWN,
+            powerSave ? (uint32_t)POWER_SCAN_DUTY_SAVE : (uint32_t)POWER_SCAN_DUTY_DEFAULT,
+            POWER_BUSY_PERMILLE};
+  }
+};
+
+// Time per state over one day under a policy
+inline PowerSpent simulateDay(const PowerPolicy& p) {
+  const uint64_t second = 1000000;
+  uint64_t on = (uint64_t)(p.displayOnHours < 24 ? p.displayOnHours : 24) * 3600 * second;
+  uint64_t off = 24 * 3600 * second - on;
+  uint32_t slowdown = p.sleepSlowdown ? p.sleepSlowdown : 1;
+
+  PowerSpent s = {};
+  s.period = on + off;
+  s.displayOn = on;
+  if (p.scanPeriodSeconds) {
+    uint64_t share = (uint64_t)p.scanSeconds * 1000 / p.scanPeriodSeconds;  // Permille while on
+    s.scan = (on * share + off * share / slowdown) / 1000;
+  }
+  if (p.fetchPeriodSeconds) {
+    uint64_t share = (uint64_t)p.fetchSeconds * 1000 / p.fetchPeriodSeconds;
+    s.fetch = (on * share + off * share / slowdown) / 1000;
+  }
+  if (p.powerSave) {
+    uint32_t rest = p.busyPermille < 1000 ? 1000 - p.busyPermille : 0;
+    s.sleep = p.lightSleep ? off * rest / 1000 : 0;
+    s.idle = s.period * rest / 1000 - s.sleep;
+  }
+  return s;
+}
+
+#endif  // POWERMODEL_H
@@ -0,0 +1,239 @@
+#ifndef POWERPLAN_H
+#define POWERPLAN_H
+
+/*----------------------------------------------------------------
+  PowerPlan: low power mode for battery and solar stations (POWER_SAVE)
+
+    loop() no longer spins. Each pass registers its timers with due(), then
+    idle() blocks until the earliest is due, at most POWER_MAX_IDLE_MS so OTA and
+    fleet packets are still served. The Nextion and weather tasks cut the wait
+    short with wake() when they have something for loop().
+
+    With loop() blocked most tasks are usually waiting, so power management can
+    drop the CPU to 80 MHz. If the framework is built with tickless idle
+    (CONFIG_PM_ENABLE, CONFIG_FREERTOS_USE_TICKLESS_IDLE) the chip also enters
+    light sleep between jobs. Light sleep stops the UART clock, so it is allowed
+    only while the display sleeps. The start bit of the display's wake frame
+    (touch wake: thup=1) wakes the chip through its RX pin. The first byte of that
+    frame can be lost, see readFrame().
+
+    The Ruuvi scan and the weather fetch take turns on the radio (claimRadio()).
+    A fetch waits for a scan in progress and a scan waits for a fetch. WiFi stays
+    in maximum modem sleep except while fetching. BLE scans listen for
+    POWER_SCAN_WINDOW ms of every POWER_SCAN_INTERVAL ms.
+
+    report() logs how the time was spent since the last report, and an
+    estimate in mAh per day from the energy model in powerModel.h. The time
+    accounting also runs without POWER_SAVE, so the two modes can be compared on
+    the same station; simulateDay() compares them offline.
+
+    Without POWER_SAVE, idle() returns at once and claimRadio() always succeeds.
+*/
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_timer.h>
+
+#include <atomic>
+
+#ifdef POWER_SAVE
+#include <driver/gpio.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#endif
+
+#include "deferredLog.h"
+#include "powerModel.h"
+#include "settings.h"
+
+#define POWER_MAX_IDLE_MS 1000           // Longest loop() wait
+#define POWER_NEXTION_SLEEP_POLL_MS 500  // Nextion task poll while the display sleeps, 100 ms otherwise
+
+enum RadioUse : uint8_t { radioFree, radioScan, radioFetch };
+
+class PowerPlan {
+ private:
+  enum Account : uint8_t { accIdle, accSleep, accScan, accFetch, accDisplay, accCount };
+
+  TaskHandle_t _loopTask = NULL;
+  std::atomic<uint8_t> _radio{radioFree};
+  uint32_t _wait = POWER_MAX_IDLE_MS;
+  bool _displayAwake = true;
+  bool _lightSleep = false;  // Light sleep enabled in power management
+#ifdef POWER_SAVE
+  esp_pm_lock_handle_t _displayLock = NULL;
+#endif
+
+  // Time per account since the last report, and start of the open interval (0 = closed)
+  uint64_t _micros[accCount] = {};
+  int64_t _since[accCount] = {};
+  int64_t _reportStart = 0;
+  portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+  void open(Account account) {
+    portENTER_CRITICAL(&_mux);
+    _since[account] = esp_timer_get_time();
+    portEXIT_CRITICAL(&_mux);
+  }
+  void close(Account account) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&_mux);
+    if (_since[account]) _micros[account] += now - _since[account];
+    _since[account] = 0;
+    portEXIT_CRITICAL(&_mux);
+  }
+
+  static uint32_t permille(uint64_t part, uint64_t whole) {
+    return part >= whole ? 1000 : (uint32_t)(part * 1000 / whole);
+  }
+
+ public:
+  // From setup(), on the loop task, once WiFi is started
+  void begin() {
+    _reportStart = esp_timer_get_time();
+    open(accDisplay);
+#ifdef POWER_SAVE
+    _loopTask = xTaskGetCurrentTaskHandle();
+    WiFi.setSleep(WIFI_PS_MAX_MODEM);
+#if CONFIG_PM_ENABLE
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_pm_config_t pm = {};
+#else
+    esp_pm_config_esp32_t pm = {};
+#endif
+    pm.max_freq_mhz = getCpuFrequencyMhz();
+    pm.min_freq_mhz = 80;  // Lowest with WiFi
+    pm.light_sleep_enable = true;
+    esp_err_t err = esp_pm_configure(&pm);
+    if (err == ESP_OK) {
+      _lightSleep = true;
+    } else {
+      pm.light_sleep_enable = false;  // Not built with tickless idle
+      err = esp_pm_configure(&pm);
+    }
+    if (esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "display", &_displayLock) == ESP_OK) {
+      esp_pm_lock_acquire(_displayLock);
+    }
+    gpio_wakeup_enable((gpio_num_t)RXDN, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    if (err == ESP_OK) {
+      LOG_INFO("Power: CPU %d-%d MHz, light sleep %s", pm.min_freq_mhz, pm.max_freq_mhz,
+               _lightSleep ? "while the display sleeps" : "not in this framework build");
+    } else {
+      LOG_WARN("Power: power management failed (%d), loop() idles only", err);
+    }
+#else
+    LOG_INFO("Power: power management not in this framework build, loop() idles only");
+#endif
+#endif
+  }
+
+  // Register a timer for the next idle(): 'interval' ms after 'since'
+  void due(unsigned long since, uint32_t interval) {
+    uint32_t elapsed = millis() - since;
+    uint32_t left = elapsed >= interval ? 0 : interval - elapsed;
+    if (left < _wait) _wait = left;
+  }
+
+  // Block loop() until the earliest registered timer or wake()
+  void idle() {
+    uint32_t wait = _wait;
+    _wait = POWER_MAX_IDLE_MS;
+#ifdef POWER_SAVE
+    if (!wait) return;
+    Account account = _lightSleep && !_displayAwake ? accSleep : accIdle;
+    open(account);
+    ulTaskNotifyTake(pdTRUE, wait / portTICK_PERIOD_MS);
+    close(account);
+#else
+    (void)wait;
+#endif
+  }
+
+  // From any task: loop() has work
+  void wake() {
+    if (_loopTask) xTaskNotifyGive(_loopTask);
+  }
+
+  // From loop(), every pass. Light sleep only while the display sleeps.
+  void display(bool awake) {
+    if (awake == _displayAwake) return;
+    _displayAwake = awake;
+    if (awake)
+      open(accDisplay);
+    else
+      close(accDisplay);
+#ifdef POWER_SAVE
+    if (_displayLock) awake ? esp_pm_lock_acquire(_displayLock) : esp_pm_lock_release(_displayLock);
+#endif
+  }
+
+  TickType_t nextionPoll(bool displaySleeping) {
+#ifdef POWER_SAVE
+    if (displaySleeping) return POWER_NEXTION_SLEEP_POLL_MS / portTICK_PERIOD_MS;
+#else
+    (void)displaySleeping;
+#endif
+    return 100 / portTICK_PERIOD_MS;
+  }
+
+  // Take the radio for a scan or fetch, waiting up to waitMillis for the other to finish
+  bool claimRadio(RadioUse use, uint32_t waitMillis = 0) {
+#ifdef POWER_SAVE
+    unsigned long start = millis();
+    for (;;) {
+      uint8_t free = radioFree;
+      if (_radio.compare_exchange_strong(free, use)) break;
+      if (millis() - start >= waitMillis) return false;
+      vTaskDelay(100 / portTICK_PERIOD_MS);
+    }
+    if (use == radioFetch) WiFi.setSleep(WIFI_PS_MIN_MODEM);  // BLE coexistence needs modem sleep on
+#else
+    (void)waitMillis;
+#endif
+    open(use == radioScan ? accScan : accFetch);
+    return true;
+  }
+
+  void releaseRadio(RadioUse use) {
+    close(use == radioScan ? accScan : accFetch);
+#ifdef POWER_SAVE
+    if (use == radioFetch) WiFi.setSleep(WIFI_PS_MAX_MODEM);
+    _radio = radioFree;
+    wake();  // A fetch may be waiting
+#endif
+  }
+
+  // Time use and energy estimate since the last report
+  void report() {
+    int64_t now = esp_timer_get_time();
+    uint64_t spent[accCount];
+    portENTER_CRITICAL(&_mux);
+    for (uint8_t a = 0; a < accCount; a++) {
+      spent[a] = _micros[a];
+      _micros[a] = 0;
+      if (_since[a]) {
+        spent[a] += now - _since[a];
+        _since[a] = now;
+      }
+    }
+    portEXIT_CRITICAL(&_mux);
+    uint64_t period = now - _reportStart;
+    _reportStart = now;
+    if (!period) return;
+
+    PowerEstimate mah = estimatePower(
+        {period, spent[accIdle], spent[accSleep], spent[accScan], spent[accFetch], spent[accDisplay]},
+        POWER_SCAN_DUTY_PERMILLE);
+    uint32_t idle = permille(spent[accIdle] + spent[accSleep], period), sleep = permille(spent[accSleep], period);
+    uint32_t scan = permille(spent[accScan], period), fetch = permille(spent[accFetch], period);
+    uint32_t on = permille(spent[accDisplay], period);
+    deferredLog.waitForRoom(3);
+    LOG_INFO("Power: loop idle %u.%u%% (light sleep %u.%u%%), scan %u.%u%%", idle / 10, idle % 10, sleep / 10,
+             sleep % 10, scan / 10, scan % 10);
+    LOG_INFO("Power: fetch %u.%u%%, display on %u.%u%%", fetch / 10, fetch % 10, on / 10, on % 10);
+    LOG_INFO("Power: ~%u mAh/day + display %u mAh/day", mah.station, mah.display);
+  }
+};
+
+#endif  // POWERPLAN_H
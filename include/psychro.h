@@ -0,0 +1,236 @@
+#ifndef PSYCHRO_H
+#define PSYCHRO_H
+
+/*----------------------------------------------------------------
+  Derived metrics per Ruuvi tag: dew point, absolute humidity, heat index, wind chill
+
+    The textbook forms need expf/logf (Magnus) and powf (wind chill), too slow to
+    run for every tag on every advert. Here they come from tables in flash with
+    linear interpolation, errors measured against the exact formulas:
+
+      Saturation vapour pressure  Magnus (Alduchov & Eskridge), 1 C steps, -40..60 C
+                                  relative error < 0.13 %
+      Dew point                   inverse of the same table (binary search)
+                                  error < 0.012 C
+      Wind chill V^0.16 term      1 mph steps, 0..100 mph
+                                  error < 0.0017, wind chill < 0.09 F at -40 F
+
+    These are well inside the tag's own resolution (humidity is kept in whole percent,
+    1 % RH moves the dew point 0.15 to 0.3 C). Outside -40..60 C values are clamped.
+    Heat index (NWS: Steadman, Rothfusz regression and its adjustments) and absolute
+    humidity are polynomials and a division, computed directly.
+
+    RuuviMetrics derives a tag's metrics lazily: only when read, and only again
+    once the tag has a new reading or the wind speed has changed. Adverts cost
+    nothing extra however many tags there are.
+
+    With PSYCHRO_BENCHMARK defined, psychroBenchmark() sweeps the table kernels
+    against libm and prints the largest error and the time each takes over the sweep.
+*/
+
+#include <Arduino.h>
+#include <math.h>
+
+#include "ruuvi.h"
+
+// Saturation vapour pressure over water (Pa) at -40, -39, ... 60 C
+static const float psychroSaturationPa[101] = {
+    18.9684f, 21.0347f, 23.3026f, 25.7893f, 28.5134f, 31.4948f, 34.755f, 38.3166f,
+    42.2042f, 46.4439f, 51.0635f, 56.093f, 61.564f, 67.5104f, 73.9683f, 80.9761f,
+    88.5746f, 96.8071f, 105.72f, 115.361f, 125.784f, 137.042f, 149.194f, 162.302f,
+    176.43f, 191.648f, 208.029f, 225.648f, 244.587f, 264.932f, 286.773f, 310.204f,
+    335.325f, 362.242f, 391.064f, 421.908f, 454.896f, 490.156f, 527.821f, 568.033f,
+    610.94f, 656.696f, 705.462f, 757.409f, 812.713f, 871.56f, 934.143f, 1000.66f,
+    1071.34f, 1146.38f, 1226.02f, 1310.5f, 1400.07f, 1495.0f, 1595.54f, 1701.98f,
+    1814.62f, 1933.77f, 2059.73f, 2192.84f, 2333.44f, 2481.89f, 2638.55f, 2803.81f,
+    2978.07f, 3161.74f, 3355.23f, 3559.01f, 3773.52f, 3999.24f, 4236.65f, 4486.27f,
+    4748.62f, 5024.24f, 5313.7f, 5617.57f, 5936.45f, 6270.96f, 6621.73f, 6989.42f,
+    7374.72f, 7778.31f, 8200.93f, 8643.31f, 9106.22f, 9590.45f, 10096.8f, 10626.1f,
+    11179.3f, 11757.1f, 12360.6f, 12990.6f, 13648.1f, 14334.1f, 15049.7f, 15795.8f,
+    16573.5f, 17383.9f, 18228.2f, 19107.5f, 20023.0f};
+
+// V^0.16 at 0, 1, ... 100 mph
+static const float psychroWindFactor[101] = {
+    0.0f, 1.0f, 1.11729f, 1.19217f, 1.24833f, 1.2937f, 1.332f, 1.36526f,
+    1.39474f, 1.42128f, 1.44544f, 1.46765f, 1.48823f, 1.50741f, 1.52539f, 1.54232f,
+    1.55833f, 1.57352f, 1.58797f, 1.60177f, 1.61497f, 1.62763f, 1.63979f, 1.65149f,
+    1.66278f, 1.67367f, 1.68421f, 1.69441f, 1.7043f, 1.71389f, 1.72321f, 1.73228f,
+    1.7411f, 1.74969f, 1.75807f, 1.76624f, 1.77422f, 1.78202f, 1.78964f, 1.79709f,
+    1.80439f, 1.81153f, 1.81853f, 1.82539f, 1.83211f, 1.83871f, 1.84519f, 1.85155f,
+    1.8578f, 1.86394f, 1.86997f, 1.87591f, 1.88174f, 1.88749f, 1.89314f, 1.89871f,
+    1.90419f, 1.90959f, 1.91491f, 1.92016f, 1.92533f, 1.93042f, 1.93545f, 1.94041f,
+    1.94531f, 1.95014f, 1.95491f, 1.95962f, 1.96427f, 1.96886f, 1.9734f, 1.97789f,
+    1.98232f, 1.9867f, 1.99103f, 1.99531f, 1.99954f, 2.00373f, 2.00787f, 2.01196f,
+    2.01602f, 2.02003f, 2.024f, 2.02793f, 2.03182f, 2.03567f, 2.03948f, 2.04326f,
+    2.047f, 2.0507f, 2.05437f, 2.05801f, 2.06161f, 2.06518f, 2.06871f, 2.07222f,
+    2.07569f, 2.07914f, 2.08255f, 2.08594f, 2.0893f};
+
+// Saturation vapour pressure (Pa) at a temperature in centi-degrees C
+inline float saturationPressure(int16_t centiC) {
+  int32_t t = constrain((int32_t)centiC + 4000, 0, 10000);
+  int32_t i = t / 100;
+  if (i == 100) return psychroSaturationPa[100];
+  return psychroSaturationPa[i] + (psychroSaturationPa[i + 1] - psychroSaturationPa[i]) * (t % 100) * 0.01f;
+}
+
+// Temperature (C) at which vapour pressure (Pa) saturates
+inline float dewPointFromPressure(float pa) {
+  if (pa <= psychroSaturationPa[0]) return -40.0f;
+  if (pa >= psychroSaturationPa[100]) return 60.0f;
+  uint8_t lo = 0, hi = 100;
+  while (hi - lo > 1) {
+    uint8_t mid = (lo + hi) / 2;
+    if (psychroSaturationPa[mid] <= pa) lo = mid;
+    else hi = mid;
+  }
+  return lo - 40 + (pa - psychroSaturationPa[lo]) / (psychroSaturationPa[lo + 1] - psychroSaturationPa[lo]);
+}
+
+// Dew point (C)
+inline float dewPoint(int16_t centiC, float humidity) {
+  return dewPointFromPressure(saturationPressure(centiC) * humidity * 0.01f);
+}
+
+// Water vapour density (g/m3)
+inline float absoluteHumidity(int16_t centiC, float humidity) {
+  // e / (Rv * T), Rv = 461.5 J/(kg K)
+  return saturationPressure(centiC) * humidity * 0.01f * 2.1668f / (centiC * 0.01f + 273.15f);
+}
+
+// NWS heat index (F)
+inline float heatIndex(float f, float humidity) {
+  float simple = 0.5f * (f + 61.0f + (f - 68.0f) * 1.2f + humidity * 0.094f);
+  if ((simple + f) * 0.5f < 80.0f) return simple;
+  float hi = -42.379f + 2.04901523f * f + 10.14333127f * humidity - 0.22475541f * f * humidity -
+             0.00683783f * f * f - 0.05481717f * humidity * humidity + 0.00122874f * f * f * humidity +
+             0.00085282f * f * humidity * humidity - 0.00000199f * f * f * humidity * humidity;
+  if (humidity < 13.0f && f >= 80.0f && f <= 112.0f) {
+    hi -= (13.0f - humidity) * 0.25f * sqrtf((17.0f - fabsf(f - 95.0f)) / 17.0f);
+  } else if (humidity > 85.0f && f >= 80.0f && f <= 87.0f) {
+    hi += (humidity - 85.0f) * 0.1f * (87.0f - f) * 0.2f;
+  }
+  return hi;
+}
+
+// NWS wind chill (F), the air temperature above 50 F or below 3 mph
+inline float windChill(float f, float mph) {
+  if (f > 50.0f || mph < 3.0f) return f;
+  float v = fminf(mph, 100.0f);
+  uint8_t i = (uint8_t)v;
+  float factor = i == 100 ? psychroWindFactor[100]
+                          : psychroWindFactor[i] + (psychroWindFactor[i + 1] - psychroWindFactor[i]) * (v - i);
+  return 35.74f + 0.6215f * f - 35.75f * factor + 0.4275f * f * factor;
+}
+
+// Metrics derived from one reading. Temperatures in tenths of a degree F (Nextion XFloat, vvs1=1).
+struct RuuviDerived {
+  int16_t dewPointDeciF;
+  int16_t heatIndexDeciF;
+  int16_t windChillDeciF;
+  uint16_t absoluteHumidity;  // Tenths of a g/m3
+};
+
+inline RuuviDerived deriveMetrics(const RuuviReading& r, float windMph) {
+  float f = r.temperatureInDeciF() * 0.1f;
+  RuuviDerived d;
+  d.dewPointDeciF = (int16_t)lroundf(dewPoint(r.centiC, r.humidity) * 18.0f + 320.0f);
+  d.heatIndexDeciF = (int16_t)lroundf(heatIndex(f, r.humidity) * 10.0f);
+  d.windChillDeciF = (int16_t)lroundf(windChill(f, windMph) * 10.0f);
+  d.absoluteHumidity = (uint16_t)lroundf(absoluteHumidity(r.centiC, r.humidity) * 10.0f);
+  return d;
+}
+
+// Derived metrics of one tag, recomputed only when read after the tag or wind has changed.
+// Not thread safe, read from one task.
+class RuuviMetrics {
+ private:
+  RuuviTag& _tag;
+  RuuviReading _from = {};  // Reading _derived was computed from
+  float _windMph = -1;
+  RuuviDerived _derived = {};
+  uint32_t _reads = 0;
+  uint32_t _derivations = 0;
+
+ public:
+  explicit RuuviMetrics(RuuviTag& tag) : _tag(tag) {}
+
+  const RuuviDerived& get(float windMph) {
+    _reads++;
+    RuuviReading r = _tag.reading();
+    if (r.lastUpdate != _from.lastUpdate || r.centiC != _from.centiC || r.humidity != _from.humidity ||
+        windMph != _windMph) {
+      _derived = deriveMetrics(r, windMph);
+      _from = r;
+      _windMph = windMph;
+      _derivations++;
+    }
+    return _derived;
+  }
+
+  uint32_t reads() { return _reads; }
+  uint32_t derivations() { return _derivations; }
+};
+
+#ifdef PSYCHRO_BENCHMARK
+// Exact forms the tables replace
+inline float dewPointLibm(int16_t centiC, float humidity) {
+  const float a = 610.94f, b = 17.625f, c = 243.04f;
+  float t = centiC * 0.01f;
+  float g = logf(a * expf(b * t / (c + t)) * humidity * 0.01f / a);
+  return c * g / (b - g);
+}
+inline float windChillLibm(float f, float mph) {
+  float factor = powf(mph, 0.16f);
+  return 35.74f + 0.6215f * f - 35.75f * factor + 0.4275f * f * factor;
+}
+
+// Sweep -40..60 C by 1..100 % RH, and -40..50 F by 3..100 mph. Each kernel is timed over a whole sweep.
+inline void psychroBenchmark(Print* out) {
+  volatile float sink = 0;
+  uint32_t calls = 0, start, tableMicros, libmMicros;
+  float error = 0;
+
+  start = micros();
+  for (int16_t centiC = -4000; centiC <= 6000; centiC += 37) {
+    for (uint8_t rh = 1; rh <= 100; rh += 3) sink = sink + dewPoint(centiC, rh);
+  }
+  tableMicros = micros() - start;
+  start = micros();
+  for (int16_t centiC = -4000; centiC <= 6000; centiC += 37) {
+    for (uint8_t rh = 1; rh <= 100; rh += 3) sink = sink + dewPointLibm(centiC, rh);
+  }
+  libmMicros = micros() - start;
+  for (int16_t centiC = -4000; centiC <= 6000; centiC += 37) {
+    for (uint8_t rh = 1; rh <= 100; rh += 3) {
+      float dew = dewPoint(centiC, rh);
+      if (dew > -40.0f) error = fmaxf(error, fabsf(dew - dewPointLibm(centiC, rh)));  // Not clamped
+      calls++;
+    }
+  }
+  out->printf("Psychro: %u dew points, table %u us, libm %u us, largest error %.4f C\n", calls, tableMicros,
+              libmMicros, error);
+
+  calls = 0;
+  error = 0;
+  start = micros();
+  for (int16_t f = -40; f <= 50; f += 5) {
+    for (float mph = 3.0f; mph <= 100.0f; mph += 0.7f) sink = sink + windChill(f, mph);
+  }
+  tableMicros = micros() - start;
+  start = micros();
+  for (int16_t f = -40; f <= 50; f += 5) {
+    for (float mph = 3.0f; mph <= 100.0f; mph += 0.7f) sink = sink + windChillLibm(f, mph);
+  }
+  libmMicros = micros() - start;
+  for (int16_t f = -40; f <= 50; f += 5) {
+    for (float mph = 3.0f; mph <= 100.0f; mph += 0.7f) {
+      error = fmaxf(error, fabsf(windChill(f, mph) - windChillLibm(f, mph)));
+      calls++;
+    }
+  }
+  out->printf("Psychro: %u wind chills, table %u us, libm %u us, largest error %.3f F\n", calls, tableMicros,
+              libmMicros, error);
+}
+#endif
+
+#endif  // PSYCHRO_H
@@ -14,21 +14,65 @@
 
   Listens for Ruuvi Service UUID, mfg. ID 0x0499 and mfg. data version 0x05.
   Ignores all other advertisments
+
+  Raw advertisements can be captured and replayed for benchmarking, see ruuviCapture.h
 */
 
 #include <vector>
 
 #include "NimBLEDevice.h"
+#include "deferredLog.h"
+#include "powerModel.h"
+#include "ruuviCapture.h"
+#include "seqlock.h"
 #include "settings.h"
 
+/*----------------------------------------------------------------
+  Fixed-point temperature kernels
+
+  Temperatures are carried as signed centi-degrees Celsius (int16_t, 0.01 C) from
+  BLE decode through RuuviTag storage to the Nextion display. Integer only, no float
+  or double (the ESP32 FPU is single precision, double math is a software call).
+  All conversions round half away from zero.
+*/
+
+// Ruuvi v5 raw temperature (0.005 C steps) to centi-degrees C
+inline int16_t ruuviRawToCentiC(int16_t raw) { return (int16_t)((raw + (raw >= 0 ? 1 : -1)) / 2); }
+
+// Centi-degrees C to whole degrees C
+inline int centiCToC(int16_t centiC) { return (centiC + (centiC >= 0 ? 50 : -50)) / 100; }
+
+// Centi-degrees C to tenths of a degree F. F * 10 = (C * 100 * 9 + 16000) / 50, rounded
+// about 0 F, so halves between -17.78 C and 0 C go up like the other halves above 0 F
+inline int centiCToDeciF(int16_t centiC) {
+  int32_t scaled = (int32_t)centiC * 9 + 16000;
+  return (int)((scaled + (scaled >= 0 ? 25 : -25)) / 50);
+}
+
+// Tenths of a degree F to whole degrees F
+inline int deciFToF(int deciF) { return (deciF + (deciF >= 0 ? 5 : -5)) / 10; }
+
+// One complete tag reading, published atomically
+struct RuuviReading {
+  time_t lastUpdate;  // When reading was received, 0 if never
+  int32_t pressure;   // Pascal
+  int16_t centiC;     // Temperature in centi-degrees C
+  int16_t humidity;   // Percent
+
+  int temperatureInC() const { return centiCToC(centiC); }
+  int temperatureInF() const { return deciFToF(centiCToDeciF(centiC)); }
+  int temperatureInDeciF() const { return centiCToDeciF(centiC); }  // For Nextion XFloat, vvs1=1
+  int pressureInMmHg() const { return (int)(pressure / 133.3223684f); }
+};
+
+// Written from the NimBLE host task, read from loop().
+// Readings are published through a seqlock so readers always see temperature,
+// humidity, pressure and timestamp from the same advertisement.
 class RuuviTag {
  private:
   std::string _tagname;
   std::string _description;
-  float _temperature = 0;
-  int _humidity = 0;
-  int _pressure = 0;
-  time_t _lastUpdate;
+  Seqlock<RuuviReading> _reading;
 
  public:
   RuuviTag(std::string name, std::string description) {
@@ -36,21 +80,31 @@ class RuuviTag {
     _description = description;
   }
 
-  void setTemperature(float temp) {
-    time(&_lastUpdate);
-    _temperature = temp;
+  // Publish a complete reading. Single writer (BLE host task).
+  void update(int16_t centiC, int humidity, int pressure) {
+    RuuviReading r;
+    time(&r.lastUpdate);
+    r.pressure = pressure;
+    r.centiC = centiC;
+    r.humidity = humidity;
+    _reading.write(r);
   }
-  void setHumidity(int humidity) { _humidity = humidity; }
-  void setPressure(int pressure) { _pressure = pressure; }
 
-  std::string getName() { return _tagname; }
+  // Consistent snapshot of the latest reading
+  RuuviReading reading() const { return _reading.read(); }
+
+  const std::string& getName() { return _tagname; }
   std::string getDescription() { return _description; }
-  int getTemperatureInC() { return (int)(_temperature + (_temperature >= 0 ? .5 : -.5)); }
-  int getTemperatureInF() { return (int)((((9.0f / 5) * (double)_temperature) + 32) + (_temperature >= 0 ? .5 : -.5)); }
-  int getHumidity() { return _humidity; }
-  int getPressureInPascal() { return _pressure; }
-  int getPressureInMmHg() { return (int)(((double)_pressure) / 133.3223684); }
-  time_t lastUpdate() { return _lastUpdate; }
+
+  // Each getter takes its own snapshot. Use reading() when more than one value is needed.
+  int getTemperatureInC() { return reading().temperatureInC(); }
+  int getTemperatureInF() { return reading().temperatureInF(); }
+  int16_t getTemperatureInCentiC() { return reading().centiC; }
+  int getTemperatureInDeciF() { return reading().temperatureInDeciF(); }
+  int getHumidity() { return reading().humidity; }
+  int getPressureInPascal() { return reading().pressure; }
+  int getPressureInMmHg() { return reading().pressureInMmHg(); }
+  time_t lastUpdate() { return reading().lastUpdate; }
 };
 
 // Create Ruuvi objects, two-node vector to help reference objects
@@ -58,69 +112,103 @@ RuuviTag indoorTag((std::string)RUUVI_INDOOR_TAG, RUUVI_INDOOR_DESCRIPTION);
 RuuviTag outdoorTag((std::string)RUUVI_OUTDOOR_TAG, RUUVI_OUTDOOR_DESCRIPTION);
 std::vector<RuuviTag*> ruuviList = {&indoorTag, &outdoorTag};
 
+// Decode one advertisement and update the matching RuuviTag in tags
+// Returns true if a RuuviTag was updated.
+bool decodeRuuviAdvertisement(const std::vector<RuuviTag*>& tags, const char* name, size_t nameLen, bool ruuviService,
+                              const uint8_t* MFRdata, size_t length) {
+  // Look for Ruuvi mfg. ID
+  // Only interested in Ruuvi v5's
+  if (!ruuviService || length < 9 || MFRdata[0] != 0x99 || MFRdata[1] != 0x04) return false;
+
+  int16_t tempInCentiC = 0;
+  float humPct = 0;
+  float atmPressure = 0;
+
+  // Version 5 data format
+  // https://mybeacons.info/packetFormats.html#hiresX
+  //
+  if (MFRdata[2] != 0x05) return false;
+  if (!(MFRdata[3] == 0x80 && MFRdata[4] == 0x00)) {
+    tempInCentiC = ruuviRawToCentiC((int16_t)((MFRdata[4] << 0) | (MFRdata[3]) << 8));
+  }
+  if (!(MFRdata[6] == 0xff && MFRdata[5] == 0xff)) {
+    humPct = ((float)((uint16_t)((MFRdata[6] << 0) | (MFRdata[5]) << 8))) / 400;
+  }
+  if (!(MFRdata[8] == 0xff && MFRdata[7] == 0xff)) {
+    atmPressure = ((float)((uint16_t)((MFRdata[8] << 0) | (MFRdata[7]) << 8)) + 50000);
+  }
+
+  // Populate Ruuvi object(s) with data from advertisement
+  bool updated = false;
+  for (auto element : tags) {
+    const std::string& tagName = element->getName();
+    if (tagName.length() == nameLen && memcmp(tagName.data(), name, nameLen) == 0) {
+      element->update(tempInCentiC, humPct, atmPressure);
+      updated = true;
+    }
+  }
+  return updated;
+}
+
+// Live tags, from the BLE scan callback
+bool processRuuviAdvertisement(const char* name, size_t nameLen, bool ruuviService, const uint8_t* MFRdata,
+                               size_t length) {
+  return decodeRuuviAdvertisement(ruuviList, name, nameLen, ruuviService, MFRdata, length);
+}
+
+#ifdef RUUVI_CAPTURE
+// Capture replay decodes into tags of its own, so a benchmark never shows on the display
+RuuviTag replayIndoorTag((std::string)RUUVI_INDOOR_TAG, RUUVI_INDOOR_DESCRIPTION);
+RuuviTag replayOutdoorTag((std::string)RUUVI_OUTDOOR_TAG, RUUVI_OUTDOOR_DESCRIPTION);
+std::vector<RuuviTag*> replayList = {&replayIndoorTag, &replayOutdoorTag};
+
+bool replayRuuviAdvertisement(const char* name, size_t nameLen, bool ruuviService, const uint8_t* MFRdata,
+                              size_t length) {
+  return decodeRuuviAdvertisement(replayList, name, nameLen, ruuviService, MFRdata, length);
+}
+#endif
+
+// Data of the first AD structure of 'type' in a raw advertisement (with any scan
+// response appended), nullptr if there is none. Points into the payload, nothing is copied.
+inline const uint8_t* findAdvertField(const uint8_t* payload, size_t payloadLen, uint8_t type, size_t* length) {
+  size_t i = 0;
+  while (i + 1 < payloadLen) {
+    uint8_t fieldLen = payload[i];  // Type and data
+    if (fieldLen == 0 || i + 1 + fieldLen > payloadLen) break;
+    if (payload[i + 1] == type) {
+      *length = fieldLen - 1;
+      return payload + i + 2;
+    }
+    i += 1 + fieldLen;
+  }
+  *length = 0;
+  return nullptr;
+}
+
+// Raw advertisement recorder, see RuuviScan::startCapture()
+RuuviCapture ruuviCapture;
+
 // Callback when any BLE device advertisement is received
 class MyAdvertisedDeviceCallbacks : public NimBLEAdvertisedDeviceCallbacks {
   void onResult(NimBLEAdvertisedDevice* advertisedDevice) {
     // Ruuvi v5 serivice UUID
-    NimBLEUUID serviceUuid(RUUVI_5_SERVICE_ID);
-
-    if (advertisedDevice->getServiceUUID() == serviceUuid) {
-      // Serial.printf("Ruuvi Device: %s \n", advertisedDevice->toString().c_str());
-
-      // Look for Ruuvi mfg. ID
-      // Only interested in Ruuvi v5's
-      if (((byte)advertisedDevice->getManufacturerData().data()[0] == 0x99) &&
-          ((byte)advertisedDevice->getManufacturerData().data()[1] == 0x04)) {
-        std::string output = advertisedDevice->getName() + " " + advertisedDevice->getAddress().toString() + " ";
-        // Serial.print(output.c_str());
-
-        char* manufacturerdata =
-            NimBLEUtils::buildHexData(NULL, (uint8_t*)advertisedDevice->getManufacturerData().data(),
-                                      advertisedDevice->getManufacturerData().length());
-        // Serial.println(manufacturerdata);
-        if (manufacturerdata != NULL) {
-          free(manufacturerdata);
-        }
-        uint8_t* MFRdata;
-        float tempInC = 0;
-        float humPct = 0;
-        float atmPressure = 0;
-
-        MFRdata = (uint8_t*)advertisedDevice->getManufacturerData().data();
-
-        // Version 5 data format
-        // https://mybeacons.info/packetFormats.html#hiresX
-        //
-        if (MFRdata[2] == 0x05) {
-          if (!(MFRdata[3] == 0x80 && MFRdata[4] == 0x00)) {
-            tempInC = ((float)((int16_t)((MFRdata[4] << 0) | (MFRdata[3]) << 8)) * .005);
-          }
-          if (!(MFRdata[6] == 0xff && MFRdata[5] == 0xff)) {
-            humPct = ((float)((uint16_t)((MFRdata[6] << 0) | (MFRdata[5]) << 8))) / 400;
-          }
-          if (!(MFRdata[8] == 0xff && MFRdata[7] == 0xff)) {
-            atmPressure = ((float)((uint16_t)((MFRdata[8] << 0) | (MFRdata[7]) << 8)) + 50000);
-          }
-
-          // Populate Ruuvi object(s) with data from advertisement
-          for (auto element : ruuviList) {
-            if (advertisedDevice->getName() == element->getName()) {
-              element->setTemperature(tempInC);
-              element->setHumidity(humPct);
-              element->setPressure(atmPressure);
-              // Serial.print(": ");
-              // Serial.print(element->getDescription().c_str());
-              // Serial.printf(" Temperature (C): %d Temperature (F): %d Humidity(%): %d Atm Pressure: %d\n",
-              //               element->getTemperatureInC(), element->getTemperatureInF(), element->getHumidity(),
-              //               element->getPressureInMmHg());
-            }
-          }
-        }
-      }
-
-    } else {
-      // advertisedDevice->getScan()->erase(advertisedDevice->getAddress());
+    static const NimBLEUUID serviceUuid(RUUVI_5_SERVICE_ID);
+
+    // Name and manufacturer data are read in place from the raw advert, the
+    // std::string getters would allocate for every advert heard
+    const uint8_t* advert = advertisedDevice->getPayload();
+    size_t advertLen = advertisedDevice->getPayloadLength();
+    size_t nameLen, payloadLen;
+    const char* name = (const char*)findAdvertField(advert, advertLen, 0x09, &nameLen);  // Complete local name
+    if (!name) name = (const char*)findAdvertField(advert, advertLen, 0x08, &nameLen);    // Shortened local name
+    const uint8_t* payload = findAdvertField(advert, advertLen, 0xFF, &payloadLen);      // Manufacturer specific
+    bool ruuviService = advertisedDevice->getServiceUUID() == serviceUuid;
+
+    if (ruuviCapture.isRecording()) {
+      ruuviCapture.record(advertisedDevice->getAddress().getNative(), advertisedDevice->getRSSI(), ruuviService, name,
+                          nameLen, payload, payloadLen);
     }
+    processRuuviAdvertisement(name, nameLen, ruuviService, payload, payloadLen);
   }
 };
 
@@ -139,16 +227,24 @@ class RuuviScan {
     pBLEScan->setAdvertisedDeviceCallbacks(new MyAdvertisedDeviceCallbacks(), true);
     pBLEScan->setActiveScan(true);  // Set active scanning, this will get more data from the advertiser.
 
+#ifdef POWER_SAVE
+    pBLEScan->setInterval(POWER_SCAN_INTERVAL);  // Lower duty cycle, see powerPlan.h and powerModel.h
+    pBLEScan->setWindow(POWER_SCAN_WINDOW);
+#else
     // Values taken from NimBLE examples
     pBLEScan->setInterval(97);   // How often the scan occurs / switches channels; in milliseconds,
     pBLEScan->setWindow(37);     // How long to scan during the interval; in milliseconds.
+#endif
     pBLEScan->setMaxResults(0);  // do not store the scan results, use callback only.
   }
 
+  // Record raw advertisements seen by subsequent scans, until capture buffer is full
+  void startCapture() { ruuviCapture.start(); }
+
   // Start BLE scan, block until scanTime timeout.
   void startRuuviScan(int scanTime) {
     if (pBLEScan->isScanning() == false) {
-      Serial.println("Starting Ruuvi Scan");
+      LOG_INFO("Starting Ruuvi Scan");
       NimBLEScanResults foundDevices = pBLEScan->start(scanTime, false);
       pBLEScan->clearResults();
     }
@@ -0,0 +1,199 @@
+#ifndef RUUVICAPTURE_H
+#define RUUVICAPTURE_H
+
+/*----------------------------------------------------------------
+  RuuviCapture: record raw BLE advertisements and replay them through the decoder
+
+    Capture format (little endian), one header followed by packed records:
+
+      Header  : "RADV" magic, uint8_t version (1), uint8_t reserved[3]
+      Record  : uint32_t timestamp   ms since capture start
+                uint8_t  mac[6]
+                int8_t   rssi
+                uint8_t  flags       bit 0: Ruuvi service UUID advertised
+                uint8_t  nameLen
+                uint8_t  payloadLen  manufacturer data length
+                char     name[nameLen]
+                uint8_t  payload[payloadLen]
+
+    Records are written from the BLE host task into a fixed RAM buffer until it is
+    full. dump() prints the capture as hex lines ("RADV:" prefix) for collection
+    from the serial log.
+
+    replay() feeds the captured records to a decode function at a fixed advert rate,
+    mixing Ruuvi and non-Ruuvi adverts as captured. Decode cost is measured for each
+    advert. Arrivals are modelled against a bounded receive queue (like the BLE host's
+    advertisement buffers), giving drop rate and arrival-to-visible latency.
+*/
+
+#include <Arduino.h>
+
+#define RUUVI_CAPTURE_SIZE 8192       // Capture buffer (bytes)
+#define RUUVI_REPLAY_QUEUE_DEPTH 8    // Modelled receive queue depth
+
+// Decode one advertisement, returns true if a RuuviTag was updated
+typedef bool (*RuuviDecodeFn)(const char* name, size_t nameLen, bool ruuviService, const uint8_t* payload, size_t len);
+
+class RuuviCapture {
+ private:
+  static const uint8_t _version = 1;
+  static const size_t _fileHeaderSize = 8;
+  static const size_t _recordHeaderSize = 14;
+
+  uint8_t _buffer[RUUVI_CAPTURE_SIZE];
+  size_t _length = 0;
+  uint32_t _records = 0;
+  uint32_t _overflows = 0;
+  unsigned long _startMillis = 0;
+  volatile bool _recording = false;
+  portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+  static void put32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = v >> (8 * i);
+  }
+  static uint32_t get32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+ public:
+  struct ReplayStats {
+    uint32_t offered;         // Adverts offered to the decoder
+    uint32_t decoded;         // Adverts processed
+    uint32_t dropped;         // Adverts arriving with the queue full
+    uint32_t tagUpdates;      // Adverts that updated a RuuviTag
+    uint32_t avgMicros;       // Decode cost per advert
+    uint32_t maxMicros;
+    uint32_t avgLatencyMicros;  // Arrival to decoded (tag value visible)
+    uint32_t maxLatencyMicros;
+  };
+
+  // Start a new capture, discarding any previous one
+  void start() {
+    portENTER_CRITICAL(&_mux);
+    memcpy(_buffer, "RADV", 4);
+    _buffer[4] = _version;
+    _buffer[5] = _buffer[6] = _buffer[7] = 0;
+    _length = _fileHeaderSize;
+    _records = 0;
+    _overflows = 0;
+    _startMillis = millis();
+    _recording = true;
+    portEXIT_CRITICAL(&_mux);
+  }
+
+  void stop() { _recording = false; }
+  bool isRecording() { return _recording; }
+  uint32_t records() { return _records; }
+  size_t length() { return _length; }
+
+  // Append one advertisement. Called from the BLE host task.
+  void record(const uint8_t* mac, int8_t rssi, bool ruuviService, const char* name, size_t nameLength,
+              const uint8_t* payload, size_t payloadLen) {
+    if (!_recording) return;
+    uint8_t nameLen = nameLength > 255 ? 255 : nameLength;
+    uint8_t dataLen = payloadLen > 255 ? 255 : payloadLen;
+    size_t size = _recordHeaderSize + nameLen + dataLen;
+
+    portENTER_CRITICAL(&_mux);
+    if (_length + size > sizeof(_buffer)) {
+      _overflows++;
+      _recording = false;  // Capture is full
+      portEXIT_CRITICAL(&_mux);
+      return;
+    }
+    uint8_t* p = _buffer + _length;
+    _length += size;
+    _records++;
+    portEXIT_CRITICAL(&_mux);
+
+    put32(p, millis() - _startMillis);
+    memcpy(p + 4, mac, 6);
+    p[10] = (uint8_t)rssi;
+    p[11] = ruuviService ? 0x01 : 0x00;
+    p[12] = nameLen;
+    p[13] = dataLen;
+    if (nameLen) memcpy(p + _recordHeaderSize, name, nameLen);
+    if (dataLen) memcpy(p + _recordHeaderSize + nameLen, payload, dataLen);
+  }
+
+  // Print capture as hex, 32 bytes per line
+  void dump(Print* out) {
+    char line[8 + 64 + 1];
+    for (size_t offset = 0; offset < _length; offset += 32) {
+      int n = snprintf(line, sizeof(line), "RADV:");
+      for (size_t i = offset; i < _length && i < offset + 32; i++) n += snprintf(line + n, sizeof(line) - n, "%02X", _buffer[i]);
+      out->println(line);
+    }
+    out->printf("RADV: %u records, %u bytes\n", _records, _length);
+  }
+
+  // Replay capture through decode() at advertsPerSecond until count adverts have been offered.
+  // Runs in the calling task. Recording is stopped first.
+  ReplayStats replay(RuuviDecodeFn decode, uint32_t advertsPerSecond, uint32_t count) {
+    ReplayStats stats = {};
+    _recording = false;
+    if (_records == 0 || advertsPerSecond == 0) return stats;
+
+    uint32_t intervalMicros = 1000000UL / advertsPerSecond;
+    uint64_t queueFinish[RUUVI_REPLAY_QUEUE_DEPTH] = {};  // Modelled completion time of queued adverts
+    uint64_t busyUntil = 0;
+    uint64_t totalMicros = 0, totalLatency = 0;
+    size_t offset = _fileHeaderSize;
+
+    for (uint32_t n = 0; n < count; n++) {
+      if (offset >= _length) offset = _fileHeaderSize;  // Loop capture
+      const uint8_t* p = _buffer + offset;
+      uint8_t nameLen = p[12];
+      uint8_t dataLen = p[13];
+      offset += _recordHeaderSize + nameLen + dataLen;
+      stats.offered++;
+
+      // Arrival time of this advert, and number of adverts still queued at that time
+      uint64_t arrival = (uint64_t)n * intervalMicros;
+      uint8_t queued = 0;
+      for (auto finish : queueFinish) queued += finish > arrival;
+      if (queued >= RUUVI_REPLAY_QUEUE_DEPTH) {
+        stats.dropped++;
+        continue;
+      }
+
+      unsigned long start = micros();
+      if (decode((const char*)p + _recordHeaderSize, nameLen, p[11] & 0x01, p + _recordHeaderSize + nameLen, dataLen))
+        stats.tagUpdates++;
+      uint32_t cost = micros() - start;
+
+      // Decoding starts when the decoder is free
+      busyUntil = (busyUntil > arrival ? busyUntil : arrival) + cost;
+      for (auto& finish : queueFinish) {
+        if (finish <= arrival) {
+          finish = busyUntil;
+          break;
+        }
+      }
+      uint32_t latency = busyUntil - arrival;
+
+      stats.decoded++;
+      totalMicros += cost;
+      totalLatency += latency;
+      if (cost > stats.maxMicros) stats.maxMicros = cost;
+      if (latency > stats.maxLatencyMicros) stats.maxLatencyMicros = latency;
+    }
+    if (stats.decoded) {
+      stats.avgMicros = totalMicros / stats.decoded;
+      stats.avgLatencyMicros = totalLatency / stats.decoded;
+    }
+    return stats;
+  }
+
+  // Replay at each rate and print a summary line per rate
+  void benchmark(RuuviDecodeFn decode, const uint32_t* rates, size_t rateCount, uint32_t count, Print* out) {
+    for (size_t i = 0; i < rateCount; i++) {
+      ReplayStats s = replay(decode, rates[i], count);
+      out->printf("Replay %5u/s: %u offered, %u dropped (%u.%u%%), %u tag updates, cpu avg %u max %u us, "
+                  "latency avg %u max %u us\n",
+                  rates[i], s.offered, s.dropped, s.offered ? s.dropped * 100 / s.offered : 0,
+                  s.offered ? (s.dropped * 1000 / s.offered) % 10 : 0, s.tagUpdates, s.avgMicros, s.maxMicros,
+                  s.avgLatencyMicros, s.maxLatencyMicros);
+    }
+  }
+};
+
+#endif  // RUUVICAPTURE_H
@@ -0,0 +1,66 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+/*----------------------------------------------------------------
+  Seqlock<T>: wait-free single writer / multi reader snapshot
+
+    The writer bumps the sequence to odd, stores the value and bumps it back to
+    even. Readers copy the value and retry if the sequence was odd or changed while
+    copying, so a reader never sees a half written value. Writers never block.
+
+    The value is held as atomic words (release stores, acquire loads) rather than
+    plain memory behind fences, so concurrent copies are not data races and the
+    ordering is visible to ThreadSanitizer. T must be trivially copyable.
+
+    Only one task may call write().
+*/
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+template <typename T>
+class Seqlock {
+  static_assert(std::is_trivially_copyable<T>::value, "Seqlock value must be trivially copyable");
+
+ private:
+  static const size_t _words = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+  std::atomic<uint32_t> _sequence{0};
+  std::atomic<uint32_t> _data[_words];
+
+ public:
+  Seqlock() {
+    for (auto& word : _data) word.store(0, std::memory_order_relaxed);
+  }
+
+  void write(const T& value) {
+    uint32_t words[_words] = {};
+    memcpy(words, &value, sizeof(T));
+
+    uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    for (size_t i = 0; i < _words; i++) _data[i].store(words[i], std::memory_order_release);
+    _sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  T read() const {
+    uint32_t words[_words];
+    uint32_t before, after;
+    do {
+      before = _sequence.load(std::memory_order_acquire);
+      for (size_t i = 0; i < _words; i++) words[i] = _data[i].load(std::memory_order_acquire);
+      after = _sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    T value;
+    memcpy(&value, words, sizeof(T));
+    return value;
+  }
+
+  // Number of completed writes
+  uint32_t version() const { return _sequence.load(std::memory_order_acquire) / 2; }
+};
+
+#endif  // SEQLOCK_H
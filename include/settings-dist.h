@@ -11,12 +11,31 @@
 #define NTP_SERVER_1 "pool.ntp.org"
 #define NTP_SERVER_2 "time.nist.gov"
 #define TZ_STRING "CST6CDT,M3.2.0,M11.1.0"  // Central time, America/Chicago
+#define RTC_DRIFT_CHECK_MINUTES 60            // Minutes between Nextion RTC drift checks
+#define RTC_DRIFT_THRESHOLD 2                 // Reset Nextion RTC if drift exceeds (seconds)
 
 #define OW_SCAN_TIME 3                        // OpenWeather scan period (minutes)
+#define OW_HOURLY_SCAN_TIME 15                // Hourly forecast refresh period (minutes), other scans fetch less
+#define OW_DAILY_SCAN_TIME 60                 // Daily forecast refresh period (minutes)
+#define OW_NOWCAST                            // "Rain in N min" from minutely precipitation (page0.nowcast)
+#define OW_ALERTS                             // Weather alerts, banner in page0.alert, description in page0.alertText
 #define OW_API_KEY "My Openweather API KEY"   // OpenWeather API Key
 #define OW_LAT 45                             // Location (lat/lon)
 #define OW_LON -92
 #define OW_CITY "Nowhere USA"  // City Name
+// #define OW_LOCATION_2 "Cabin", 46.9, -94.6  // More locations: name, lat, lon (up to OW_LOCATION_4)
+// #define OW_LOCATION_3 "Duluth", 46.8, -92.1
+#define LOCATION_CYCLE_SECONDS 20      // Display time per location when more than one is set
+// #define FLEET_MODE             // Share one OpenWeather fetch with other stations at this location (UDP multicast)
+// #define FLEET_KEY "long random string"  // Same on every station: fleet packets are signed, see fleet.h
+#define OW_GZIP                // Request gzip compressed responses (about 43 KB extra heap during a fetch)
+// #define OW_TLS              // Fetch over HTTPS, keeps the API key off the wire. Needs OW_TLS_CA and/or OW_TLS_PIN
+// SHA-256 of server public key (64 hex digits), the build fails until it is set. From a network you trust:
+//   openssl s_client -connect api.openweathermap.org:443 </dev/null | openssl x509 -pubkey -noout |
+//   openssl pkey -pubin -outform der | openssl dgst -sha256
+// #define OW_TLS_PIN "0000000000000000000000000000000000000000000000000000000000000000"
+// #define OW_TLS_CA "-----BEGIN CERTIFICATE-----\n...\n-----END CERTIFICATE-----\n"  // Pinned CA (PEM)
+// #define OW_HOST "https://192.168.1.10:8443"  // Fetch from a local stand-in server instead of OpenWeather
 
 #define HEARTBEAT_INTERVAL_MILLIS 30000                            // Milliseconds between Ruuvi temp display updates
 #define RUUVI_SCAN_TIME 10                                         //RUUVI tag scan time (seconds)  
@@ -25,11 +44,40 @@
 #define RUUVI_INDOOR_DESCRIPTION "Indoor Device"
 #define RUUVI_OUTDOOR_TAG "Ruuvi YYY"                              // Ruuvi tag name (from BLE broadcast) Set to name of your device
 #define RUUVI_OUTDOOR_DESCRIPTION "Outdoor Device"
+// #define RUUVI_CAPTURE                                           // Capture BLE adverts on first scan, dump & replay benchmark
+// #define PSYCHRO_BENCHMARK                                       // Time dew point & wind chill tables against libm at startup
 
 // Nextion Serial configuration
 #define NEXTION_SERIAL Serial1  // Nextion Device Serial port
 #define NEXTION_BAUD 115200     // Baud as set in Nextion Program startup
+#define NEXTION_MAX_BAUD 921600 // Highest baud to negotiate at startup (set to NEXTION_BAUD to disable)
+#define NEXTION_ACKED_WRITES    // Acknowledge every write (bkcmd=3), resend lost or failed writes
+#define DISPLAY_SLEEP_SLOWDOWN 4  // Ruuvi scans and weather polls are this many times rarer while the display sleeps
 #define RXDN 19                 // Nextion Device Serial port pins
 #define TXDN 21
 
+// Hourly page scrolling: touch events (Send Component ID) from two buttons on the Hourly page
+#define NEXTION_HOURLY_PAGE_ID 2     // Page ID of Hourly page
+#define NEXTION_HOURLY_BACK_ID 60    // Component ID of earlier hours button
+#define NEXTION_HOURLY_FORWARD_ID 61 // Component ID of later hours button
+#define HOURLY_SCROLL_STEP 4         // Hours moved per touch
+
+// Task placement: core (0, 1 or tskNO_AFFINITY) and priority, see taskPlan.h. WiFi is on core 0, loop() on core 1.
+#define TASK_SCAN_CORE 0          // Ruuvi BLE scan cycle
+#define TASK_SCAN_PRIORITY 2
+#define TASK_NEXTION_CORE 1       // Nextion events and acks
+#define TASK_NEXTION_PRIORITY 6
+#define TASK_WEATHER_CORE 0       // OpenWeather fetch and parse
+#define TASK_WEATHER_PRIORITY 3
+#define TASK_LOOP_PRIORITY 1      // loop(): timers and rendering
+#define TASK_LOG_CORE 0           // Deferred log drain to Serial, see deferredLog.h
+#define TASK_LOG_PRIORITY 1
+
+// Low power for battery and solar stations, see powerPlan.h: loop() idles between jobs, light sleep while the display sleeps
+// #define POWER_SAVE
+#define POWER_SCAN_INTERVAL 300  // BLE scan interval and window (ms) with POWER_SAVE: 20 % duty instead of 38 %
+#define POWER_SCAN_WINDOW 60
+
+#define LOG_LEVEL 3  // Serial log records kept: 1 errors, 2 + warnings, 3 + info, 4 + debug. Others are compiled out.
+
 #endif  // SETTINGS_H
\ No newline at end of file
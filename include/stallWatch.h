@@ -0,0 +1,87 @@
+#ifndef STALLWATCH_H
+#define STALLWATCH_H
+
+/*----------------------------------------------------------------
+  StallWatch: software watchdog for sections that can block
+
+    Calls that may block for seconds (WiFi connect, BLE scan, HTTP fetch, Nextion
+    semaphore waits) are wrapped in a StallGuard, which stamps entry and exit:
+
+      {
+        StallGuard guard(stallBleScan);
+        ruuviScan.startRuuviScan(RUUVI_SCAN_TIME);
+      }
+
+    Every section's duration goes into a histogram. A section that outlasts its
+    budget is logged on exit.
+
+    An esp_timer checks open sections every STALL_CHECK_MS. The first time one is
+    over budget, the blocked task's backtrace is taken from its saved registers and
+    stored in a ring of STALL_RING_SIZE records in RTC memory, which survives a
+    reboot (not a power cycle). So a hang that ends in a watchdog reset is still
+    there at the next boot: begin() prints the previous boots' records. Decode the
+    addresses with addr2line or the esp32_exception_decoder.
+
+    Only a task that is blocked or suspended has registers saved to walk from.
+    One caught running or ready, e.g. spinning in a loop, gets a record that only
+    names the section. The task itself is never suspended: the walk holds off the
+    scheduler, and since a task on the other core can still wake meanwhile, its
+    state and saved stack pointer are checked again afterwards. If it ran, the
+    frames are dropped and the next check tries again. Xtensa only.
+
+    All state is fixed size, nothing is allocated.
+*/
+
+#include <Arduino.h>
+
+#define STALL_CHECK_MS 100          // Open sections checked this often
+#define STALL_RING_SIZE 8           // Stall records kept in RTC memory
+#define STALL_BACKTRACE_DEPTH 8     // Frames per record
+#define STALL_ACTIVE_SLOTS 8        // Sections open at once, across all tasks
+#define STALL_BUCKETS 6             // Histogram: <10 ms, <100 ms, <1 s, <5 s, <15 s, longer
+
+enum StallSection : uint8_t {
+  stallWiFiConnect,
+  stallBleScan,
+  stallHttpFetch,  // Request, body read and parse
+  stallNextionLock,
+  stallSectionCount
+};
+
+class StallWatch {
+ public:
+  struct Record {
+    uint32_t boot;      // Boot the stall happened in, see boots()
+    uint32_t uptime;    // Seconds since that boot
+    uint32_t elapsed;   // Milliseconds in section when captured
+    uint8_t section;
+    uint8_t depth;      // Frames in pc
+    char task[12];
+    uint32_t pc[STALL_BACKTRACE_DEPTH];
+  };
+
+  void begin();
+
+  // StallGuard uses these. enter() returns a slot, -1 if all are in use.
+  int8_t enter(StallSection section);
+  void exit(int8_t slot);
+
+  void report();        // Histogram per section
+  void printRecords();  // Stall ring, oldest first. From begin(), before the check timer runs.
+  uint32_t boots();
+};
+
+extern StallWatch stallWatch;
+
+class StallGuard {
+ private:
+  int8_t _slot;
+
+ public:
+  explicit StallGuard(StallSection section) : _slot(stallWatch.enter(section)) {}
+  ~StallGuard() { stallWatch.exit(_slot); }
+  StallGuard(const StallGuard&) = delete;
+  StallGuard& operator=(const StallGuard&) = delete;
+};
+
+#endif  // STALLWATCH_H
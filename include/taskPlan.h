@@ -0,0 +1,157 @@
+#ifndef TASKPLAN_H
+#define TASKPLAN_H
+
+/*----------------------------------------------------------------
+  Task placement across the two ESP32 cores, and per-task / per-core CPU use
+
+    Work and where it runs (cores and priorities are set in settings.h):
+
+      Ruuvi scan      TASK_SCAN_*     Blocking BLE scan cycle. Adverts are decoded in
+                                      the NimBLE host task's callback; that task's core
+                                      is a build option (CONFIG_BT_NIMBLE_PINNED_TO_CORE).
+      Nextion         TASK_NEXTION_*  Reads events and acks from the display
+      Weather         TASK_WEATHER_*  OpenWeather fetch, inflate and parse
+      Log             TASK_LOG_*      Formats deferred log records to Serial, see deferredLog.h
+      Main scheduler  loop()          Timers, fleet, rendering. Arduino runs it on
+                                      ARDUINO_RUNNING_CORE; only its priority is set here.
+
+    WiFi and lwIP run on core 0 at high priority. The default plan keeps the
+    network bound work (scan, fetch) beside them on core 0 and leaves core 1 to
+    loop() and the display, so a long parse doesn't hold up rendering.
+
+    TaskStats::report() logs how busy each core was since the last report, from
+    the idle tasks' run time, and with perTask the share of a core each task used.
+    Needs FreeRTOS run-time stats (CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS and
+    CONFIG_FREERTOS_USE_TRACE_FACILITY); without them only the plan is printed.
+*/
+
+#include <Arduino.h>
+
+#include "deferredLog.h"
+#include "settings.h"
+
+// Defaults for settings.h files made before the task plan, see settings-dist.h
+#ifndef TASK_SCAN_CORE
+#define TASK_SCAN_CORE 0
+#define TASK_SCAN_PRIORITY 2
+#endif
+#ifndef TASK_NEXTION_CORE
+#define TASK_NEXTION_CORE 1
+#define TASK_NEXTION_PRIORITY 6
+#endif
+#ifndef TASK_WEATHER_CORE
+#define TASK_WEATHER_CORE 0
+#define TASK_WEATHER_PRIORITY 3
+#endif
+#ifndef TASK_LOOP_PRIORITY
+#define TASK_LOOP_PRIORITY 1
+#endif
+#ifndef TASK_LOG_CORE
+#define TASK_LOG_CORE 0
+#define TASK_LOG_PRIORITY 1
+#endif
+
+struct TaskPlacement {
+  const char* name;
+  BaseType_t core;  // 0, 1 or tskNO_AFFINITY
+  UBaseType_t priority;
+  uint32_t stack;   // Bytes
+};
+
+static const TaskPlacement scanPlacement = {"Ruuvi Scan", TASK_SCAN_CORE, TASK_SCAN_PRIORITY, 4096};
+static const TaskPlacement nextionPlacement = {"Nextion Handler", TASK_NEXTION_CORE, TASK_NEXTION_PRIORITY, 3000};
+static const TaskPlacement weatherPlacement = {"Weather", TASK_WEATHER_CORE, TASK_WEATHER_PRIORITY, 8192};  // As loop(), TLS
+static const TaskPlacement logPlacement = {"Log", TASK_LOG_CORE, TASK_LOG_PRIORITY, 3072};
+
+inline TaskHandle_t startTask(TaskFunction_t task, const TaskPlacement& placement, void* parameter = nullptr) {
+  TaskHandle_t handle = NULL;
+  if (xTaskCreatePinnedToCore(task, placement.name, placement.stack, parameter, placement.priority, &handle,
+                              placement.core) != pdPASS) {
+    Serial.printf("Task %s not started\n", placement.name);  // Straight out, it may be the Log task
+    return NULL;
+  }
+  return handle;
+}
+
+class TaskStats {
+ private:
+  static const uint8_t _maxTasks = 32;
+  struct Sample {
+    TaskHandle_t handle;
+    uint32_t runTime;
+  };
+#if configGENERATE_RUN_TIME_STATS && configUSE_TRACE_FACILITY
+  TaskStatus_t _status[_maxTasks];
+#endif
+  Sample _last[_maxTasks] = {};
+  uint8_t _lastCount = 0;
+  uint32_t _lastTotal = 0;
+
+  uint32_t previousRunTime(TaskHandle_t handle) {
+    for (uint8_t i = 0; i < _lastCount; i++) {
+      if (_last[i].handle == handle) return _last[i].runTime;
+    }
+    return 0;
+  }
+
+  static uint32_t busyPermille(uint32_t idle, uint32_t elapsed) {
+    return idle >= elapsed ? 0 : 1000 - (uint32_t)((uint64_t)idle * 1000 / elapsed);
+  }
+
+ public:
+  void printPlan() {
+    for (const TaskPlacement* p : {&scanPlacement, &nextionPlacement, &weatherPlacement, &logPlacement}) {
+      if (p->core == tskNO_AFFINITY)
+        LOG_INFO("Task plan: %s any core, priority %u", p->name, p->priority);
+      else
+        LOG_INFO("Task plan: %s core %d, priority %u", p->name, p->core, p->priority);
+    }
+    LOG_INFO("Task plan: loop() core %d, priority %u", xPortGetCoreID(), uxTaskPriorityGet(NULL));
+  }
+
+  // CPU use since the last report
+  void report(bool perTask) {
+#if configGENERATE_RUN_TIME_STATS && configUSE_TRACE_FACILITY
+    uint32_t total;
+    UBaseType_t count = uxTaskGetSystemState(_status, _maxTasks, &total);
+    uint32_t elapsed = total - _lastTotal;
+    if (!count || !elapsed) return;
+
+    uint32_t idle[2] = {};
+    for (UBaseType_t i = 0; i < count; i++) {
+      const TaskStatus_t& t = _status[i];
+      if (strncmp(t.pcTaskName, "IDLE", 4) != 0) continue;
+#if configTASKLIST_INCLUDE_COREID
+      if (t.xCoreID == 0 || t.xCoreID == 1) idle[t.xCoreID] += t.ulRunTimeCounter - previousRunTime(t.xHandle);
+#endif
+    }
+    uint32_t busy[2] = {busyPermille(idle[0], elapsed), busyPermille(idle[1], elapsed)};
+    LOG_INFO("Tasks: core 0 %u.%u%% busy, core 1 %u.%u%% busy, %u tasks", busy[0] / 10, busy[0] % 10, busy[1] / 10,
+             busy[1] % 10, count);
+
+    if (perTask) {
+      for (UBaseType_t i = 0; i < count; i++) {
+        const TaskStatus_t& t = _status[i];
+        uint32_t used = (uint32_t)((uint64_t)(t.ulRunTimeCounter - previousRunTime(t.xHandle)) * 1000 / elapsed);
+        const char* core = "";
+#if configTASKLIST_INCLUDE_COREID
+        core = t.xCoreID == 0 ? " core 0" : t.xCoreID == 1 ? " core 1" : " any   ";
+#endif
+        // The name is in the task's control block, which outlives the record
+        deferredLog.waitForRoom(1);
+        LOG_INFO("  %-16s%s prio %2u %u.%u%%, stack free %u", t.pcTaskName, core, t.uxCurrentPriority, used / 10,
+                 used % 10, t.usStackHighWaterMark);
+      }
+    }
+
+    _lastCount = count;
+    for (UBaseType_t i = 0; i < count; i++) _last[i] = {_status[i].xHandle, _status[i].ulRunTimeCounter};
+    _lastTotal = total;
+#else
+    (void)perTask;
+    LOG_INFO("Tasks: run-time stats not enabled");
+#endif
+  }
+};
+
+#endif  // TASKPLAN_H
@@ -0,0 +1,116 @@
+#ifndef TLSCLIENT_H
+#define TLSCLIENT_H
+
+/*----------------------------------------------------------------
+  ResumableTlsClient: HTTPS client socket that resumes TLS sessions between polls
+
+    Drop-in WiFiClient for HTTPClient::begin(client, "https://..."). Unlike
+    WiFiClientSecure, the TLS configuration, random generator and trust anchor are
+    set up once, and the session (ID or ticket) of the last connection is offered
+    on the next connect. When the server accepts it, the handshake skips the
+    certificate exchange and public key operations.
+
+    Trust, set before the first connect:
+      setCACert(pem)        - chain must verify against this single pinned CA
+      setPublicKeyPin(hex)  - SHA-256 of the server's SubjectPublicKeyInfo (64 hex
+                              digits); may be used alone or together with a CA
+    With neither set, connect() refuses. Take the pin from a network you trust,
+    a mismatch only reports that the key differs.
+
+    The TCP connect gives up after the connect() timeout, and so does the
+    handshake. Builds against mbedtls 2.x (arduino-esp32 2.x) and 3.x (3.x).
+
+    Full and resumed handshakes are counted separately with their time and the heap
+    held by the connection. report() logs them.
+*/
+
+#include <WiFiClient.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/x509_crt.h>
+
+#define TLS_HANDSHAKE_TIMEOUT_MS 10000
+#define TLS_WRITE_TIMEOUT_MS 5000
+
+class ResumableTlsClient : public WiFiClient {
+ public:
+  struct HandshakeStats {
+    uint32_t count;
+    uint32_t maxMicros;
+    uint64_t totalMicros;
+    uint64_t totalHeap;  // Heap held by connection after handshake
+  };
+
+ private:
+  const char* _caPem = nullptr;
+  uint8_t _pin[32];
+  bool _hasPin = false;
+
+  bool _configured = false;
+  mbedtls_entropy_context _entropy;
+  mbedtls_ctr_drbg_context _drbg;
+  mbedtls_ssl_config _conf;
+  mbedtls_x509_crt _ca;
+
+  mbedtls_net_context _net;
+  mbedtls_ssl_context _ssl;
+  bool _connected = false;
+  bool _peerClosed = false;
+  int _peeked = -1;
+
+  mbedtls_ssl_session _session;  // Last negotiated session, offered on next connect
+  bool _hasSession = false;
+
+  HandshakeStats _full = {};
+  HandshakeStats _resumed = {};
+  uint32_t _failures = 0;
+  bool _lastResumed = false;
+  uint32_t _lastMicros = 0;
+  uint32_t _lastTcpMicros = 0;
+  uint32_t _lastHeap = 0;
+
+  bool configure();
+  int connectTcp(const char*, uint16_t, int32_t);
+  bool verifyPeer();
+  void forgetSession();
+  int readRecord(uint8_t*, size_t);
+
+ public:
+  ResumableTlsClient();
+  ~ResumableTlsClient();
+
+  void setCACert(const char* pem) { _caPem = pem; }
+  bool setPublicKeyPin(const char* sha256Hex);
+
+  // For a static_assert on a pin literal: 64 hex digits, not all zero
+  static constexpr bool validPin(const char* hex, size_t i = 0, bool nonZero = false) {
+    return i == 64 ? hex[i] == 0 && nonZero
+                   : ((hex[i] >= '0' && hex[i] <= '9') || (hex[i] >= 'a' && hex[i] <= 'f') ||
+                      (hex[i] >= 'A' && hex[i] <= 'F')) &&
+                         validPin(hex, i + 1, nonZero || hex[i] != '0');
+  }
+
+  int connect(IPAddress ip, uint16_t port) override;
+  int connect(IPAddress ip, uint16_t port, int32_t timeout);
+  int connect(const char* host, uint16_t port) override;
+  int connect(const char* host, uint16_t port, int32_t timeout);
+
+  size_t write(uint8_t data) override { return write(&data, 1); }
+  size_t write(const uint8_t* buf, size_t size) override;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buf, size_t size) override;
+  int peek() override;
+  void flush() override {}
+  void stop() override;
+  uint8_t connected() override;
+
+  const HandshakeStats& fullHandshakes() { return _full; }
+  const HandshakeStats& resumedHandshakes() { return _resumed; }
+  uint32_t failures() { return _failures; }
+  void report();
+};
+
+#endif  // TLSCLIENT_H
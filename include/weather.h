@@ -3,8 +3,21 @@
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 
+#include "alerts.h"
+#include "arena.h"
+#include "deferredLog.h"
+#include "localtime.h"
+#include "nowcast.h"
+#include "owmFilter.h"
 #include "settings.h"
+#include "stallWatch.h"
 #include "time.h"
+#ifdef OW_GZIP
+#include "gzipStream.h"
+#endif
+#ifdef OW_TLS
+#include "tlsClient.h"
+#endif
 
 /*----------------------------------------------------------------
 owmWeather object: Wrapper for OpenWeather API call (onecall API, version 3.0)
@@ -164,13 +177,30 @@ Example:
     }
 */
 
+#ifdef OW_TLS
+#if !defined(OW_TLS_PIN) && !defined(OW_TLS_CA)
+#error "OW_TLS needs OW_TLS_PIN or OW_TLS_CA, see settings-dist.h"
+#endif
+#ifdef OW_TLS_PIN
+static_assert(ResumableTlsClient::validPin(OW_TLS_PIN), "OW_TLS_PIN must be the server key's SHA-256, 64 hex digits");
+#endif
+#endif
+
+#ifndef OW_HOST
+#ifdef OW_TLS
+#define OW_HOST "https://api.openweathermap.org"
+#else
+#define OW_HOST "http://api.openweathermap.org"
+#endif
+#endif
+
 struct CurrentWeather {
   float lon;               // "lon": 8.54,
   float lat;               // "lat": 47.37
   uint16_t weatherId;      // "id": 521,
-  String main;             // "main": "Rain",
-  String description;      // "description": "shower rain",
-  String icon;             // "icon": "09d"
+  char main[16];           // "main": "Rain",
+  char description[40];    // "description": "shower rain",
+  char icon[4];            // "icon": "09d"
   float temp;              // "temp": 290.56,
   uint16_t pressure;       // "pressure": 1013,
   uint8_t humidity;        // "humidity": 87,
@@ -187,19 +217,178 @@ struct DailyForecast {
   float tempMin;           // "temp": 290.56,
   float tempMax;           // "temp": 290.56,
   uint16_t weatherId;      // "id": 521,
-  String main;             // "main": "Rain",
-  String description;      // "description": "shower rain",
-  String icon;             // "icon": "09d"
+  char main[16];           // "main": "Rain",
+  char description[40];    // "description": "shower rain",
+  char icon[4];            // "icon": "09d"
 };
 
-struct HourlyForecast {
-  time_t observationTime;  // "dt": 1527015000,
-  float temp   ;           // "temp": 290.56,
-  uint8_t clouds;          // "clouds": 90,
-  float pop;               // "pop": .2,
-  uint16_t weatherId;      // "id": 521,
-  String icon;             // "icon": "09d"
-  float pcpt;              // "rain "1h" .10
+#define HOURLY_HOURS 48  // Hours in the OneCall hourly forecast
+
+// Hourly forecast, one array per field (8 bytes an hour). Hours are consecutive from start.
+// Fixed width and packed, so it is also sent as is in the fleet snapshot.
+struct __attribute__((packed)) HourlySeries {
+  uint32_t start;                  // "dt" of first hour
+  int16_t temp[HOURLY_HOURS];      // "temp", tenths of a degree
+  uint16_t weatherId[HOURLY_HOURS];
+  uint8_t clouds[HOURLY_HOURS];    // "clouds", %
+  uint8_t pop[HOURLY_HOURS];       // "pop", %
+  uint8_t icon[HOURLY_HOURS];      // "icon", see packIcon()
+  uint8_t rain[HOURLY_HOURS];      // "rain" "1h", tenths of mm/h, saturates at 25.5
+  uint8_t count;                   // Hours filled
+};
+
+// Compact binary copy of the weather model, shared between stations (see fleet.h)
+// Fixed width little endian fields, so stations decode it with plain copies, no JSON.
+// Bump WEATHER_SNAPSHOT_VERSION when the layout changes.
+#define WEATHER_SNAPSHOT_VERSION 4
+
+struct __attribute__((packed)) SnapshotCurrent {
+  float lon;
+  float lat;
+  uint16_t weatherId;
+  char main[16];
+  char description[40];
+  char icon[4];
+  float temp;
+  uint16_t pressure;
+  uint8_t humidity;
+  uint8_t feelsLike;
+  float windSpeed;
+  float windDeg;
+  uint8_t clouds;
+  uint32_t observationTime;
+};
+
+struct __attribute__((packed)) SnapshotDaily {
+  uint32_t observationTime;
+  float tempMin;
+  float tempMax;
+  uint16_t weatherId;
+  char main[16];
+  char description[40];
+  char icon[4];
+};
+
+struct __attribute__((packed)) SnapshotNowcast {
+  uint32_t start;
+  uint32_t onset;
+  uint32_t stop;
+  float peak;
+  float total;
+  uint8_t minutes;
+};
+
+// Alert with description cut short, to keep the datagram unfragmented
+struct __attribute__((packed)) SnapshotAlert {
+  char event[32];
+  uint32_t start;
+  uint32_t end;
+  char description[48];
+};
+
+struct __attribute__((packed)) WeatherSnapshot {
+  SnapshotCurrent current;
+  SnapshotDaily daily[8];
+  HourlySeries hourly;
+  SnapshotNowcast nowcast;
+  uint8_t alertCount;
+  SnapshotAlert alerts[ALERT_CAPACITY];
+};
+
+// Parts of a OneCall response. A fetch names the parts it wants, the rest are excluded
+// (OneCall 'exclude=' parameter) and keep their previous values in the model.
+enum WeatherParts : uint8_t {
+  owCurrent = 0x01,
+  owHourly = 0x02,
+  owDaily = 0x04,
+  owMinutely = 0x08,  // Folded into a Nowcast, never stored
+  owAlerts = 0x10,    // Copied into an AlertStore, descriptions truncated
+  owAllParts = owCurrent | owHourly | owDaily | owMinutely | owAlerts,
+};
+
+#ifndef OW_HOURLY_SCAN_TIME
+#define OW_HOURLY_SCAN_TIME OW_SCAN_TIME  // Minutes between hourly forecast refreshes
+#endif
+#ifndef OW_DAILY_SCAN_TIME
+#define OW_DAILY_SCAN_TIME OW_SCAN_TIME  // Minutes between daily forecast refreshes
+#endif
+
+// Resources shared by all locations: HTTP client, JSON filter, parse arena, inflater and TLS session.
+// Locations are fetched one at a time through it, so only one response is ever in memory.
+class owmFetcher {
+ public:
+  HTTPClient http;
+  JsonDocument filter;                        // ArduinoJSON Filter Document
+  MonotonicArena<WEATHER_ARENA_SIZE> arena;   // Parse buffer, reset after each refresh
+#ifdef OW_GZIP
+  GzipStream gzip;                            // Inflates gzip responses as they are parsed
+#endif
+#ifdef OW_TLS
+  ResumableTlsClient tls;                     // Keeps TLS session between polls and locations
+#endif
+  JsonTap tap;                                // Sees arrays the filter drops, for the folds below
+  NowcastFold nowcastFold;                    // 'minutely' into a Nowcast
+  AlertFold alertFold;                        // 'alerts' into an AlertStore
+  uint32_t minFreeHeap = UINT32_MAX;          // Lowest free heap seen while a response was open
+
+  // Cost of each fetch tier, named by the largest part fetched
+  enum Tier : uint8_t { tierCurrent, tierHourly, tierFull, tierCount };
+  struct TierStats {
+    uint32_t count;
+    uint32_t maxParseMicros;
+    uint64_t totalParseMicros;
+    uint64_t wireBytes;
+    uint64_t decodedBytes;
+  };
+  TierStats tiers[tierCount] = {};
+
+  static Tier tierOf(uint8_t parts) {
+    if (parts & owDaily) return tierFull;
+    return parts & owHourly ? tierHourly : tierCurrent;
+  }
+
+  void recordFetch(uint8_t parts, uint32_t parseMicros, uint32_t wireBytes, uint32_t decodedBytes) {
+    TierStats &t = tiers[tierOf(parts)];
+    t.count++;
+    t.totalParseMicros += parseMicros;
+    if (parseMicros > t.maxParseMicros) t.maxParseMicros = parseMicros;
+    t.wireBytes += wireBytes;
+    t.decodedBytes += decodedBytes;
+  }
+
+  void reportTiers() {
+    static const char *names[tierCount] = {"current", "+hourly", "full"};
+    deferredLog.waitForRoom(tierCount * 2);
+    for (int i = 0; i < tierCount; i++) {
+      const TierStats &t = tiers[i];
+      if (!t.count) continue;
+      LOG_INFO("  %-7s %4u fetches, avg %u bytes on wire, %u decoded", names[i], t.count,
+               (uint32_t)(t.wireBytes / t.count), (uint32_t)(t.decodedBytes / t.count));
+      LOG_INFO("  %-7s parse avg %u ms, max %u ms", names[i], (uint32_t)(t.totalParseMicros / t.count / 1000),
+               t.maxParseMicros / 1000);
+    }
+  }
+
+  owmFetcher() {
+#ifdef OW_TLS
+#ifdef OW_TLS_CA
+    tls.setCACert(OW_TLS_CA);
+#endif
+#ifdef OW_TLS_PIN
+    tls.setPublicKeyPin(OW_TLS_PIN);
+#endif
+#endif
+
+    owmFilter(filter);
+    // serializeJsonPretty(filter, Serial);
+  }
+
+  // Heap low water mark since last call
+  uint32_t takeMinFreeHeap() {
+    uint32_t heap = minFreeHeap;
+    minFreeHeap = UINT32_MAX;
+    return heap;
+  }
 };
 
 class owmWeather {
@@ -207,76 +396,154 @@ class owmWeather {
   String _cityName;
   float _latitude;
   float _longitude;
-  HTTPClient http;
+  owmFetcher &_fetcher;
   CurrentWeather weatherNow;            // Current Weather via API 3.0
   DailyForecast dailyForecast[8];       // Forecast - Eight day daily forecast availabe in API 3.0
-  HourlyForecast hourlyForecast[24];    // Forecast - 48 hour hourly forecast availabe in API 3.0
-  JsonDocument filter;                  // ArduinoJSON Filter Document
+  HourlySeries hourlyForecast = {};     // Forecast - 48 hour hourly forecast availabe in API 3.0
+  Nowcast _nowcast = {};                // Next hour precipitation summary
+  AlertStore _alerts = {};              // Alerts in force or announced
+  bool _alertsChanged = false;          // Alerts differ from those last taken by takeAlertsChanged()
+  int _fetchStatus = 200;               // Last fetch result, see setFetchStatus()
 
   String currentWeatherHost;
+  uint8_t _fetchedParts = 0;             // Parts fetched at least once
+  unsigned long _hourlyMillis = 0;       // Time of last hourly / daily refresh
+  unsigned long _dailyMillis = 0;
+
+  // True if a part refreshed every 'minutes' is due. Half a poll of slack, so polls don't overshoot by one.
+  bool due(uint8_t part, unsigned long lastMillis, unsigned long minutes) {
+    return !(_fetchedParts & part) || millis() - lastMillis + OW_SCAN_TIME * 30000UL >= minutes * 60000UL;
+  }
+
+  // Route the response body through the tap when minutely or alerts are wanted
+  Stream &watchArrays(Stream &body, uint8_t parts) {
+    if (!(parts & (owMinutely | owAlerts))) return body;
+    _fetcher.tap.begin(body);
+    if (parts & owMinutely) {
+      _fetcher.nowcastFold.reset();
+      _fetcher.tap.watch(_fetcher.nowcastFold);
+    }
+    if (parts & owAlerts) {
+      _fetcher.alertFold.reset();
+      _fetcher.tap.watch(_fetcher.alertFold);
+    }
+    return _fetcher.tap;
+  }
 
  public:
   TaskHandle_t xhandlegetWeatherHandle = NULL;
 
-  owmWeather(String cityName, float lat, float lon, String owAPIKey) {
+  owmWeather(String cityName, float lat, float lon, String owAPIKey, owmFetcher &fetcher) : _fetcher(fetcher) {
     _cityName = cityName;
     _latitude = lat;
     _longitude = lon;
-    currentWeatherHost = "http://api.openweathermap.org/data/3.0/onecall?appid=" + owAPIKey + "&lat=" + _latitude +
+    currentWeatherHost = OW_HOST "/data/3.0/onecall?appid=" + owAPIKey + "&lat=" + _latitude +
                          "&lon=" + _longitude + "&units=imperial";
+    weatherNow.observationTime = 0;
+  }
 
-    // Populate ArduinoJSON filter document
-    // Reduce size of ArduinoJSON 'doc' document
-    filter["lon"] = true;
-    filter["lat"] = true;
-    filter["current"]["weather"][0]["id"] = true;
-    filter["current"]["weather"][0]["main"] = true;
-    filter["current"]["weather"][0]["icon"] = true;
-    filter["current"]["weather"][0]["description"] = true;
-    filter["current"]["temp"] = true;
-    filter["current"]["feels_like"] = true;
-    filter["current"]["pressure"] = true;
-    filter["current"]["humidity"] = true;
-    filter["current"]["wind_speed"] = true;
-    filter["current"]["wind_deg"] = true;
-    filter["current"]["clouds"] = true;
-    filter["current"]["dt"] = true;
-
-    filter["hourly"][0]["dt"] = true;
-    filter["hourly"][0]["temp"] = true;
-    filter["hourly"][0]["clouds"] = true;
-    filter["hourly"][0]["pop"] = true;
-    filter["hourly"][0]["weather"][0]["icon"] = true;
-    filter["hourly"][0]["rain"]["1h"] = true;
-
-    filter["daily"][0]["dt"] = true;
-    filter["daily"][0]["temp"]["min"] = true;
-    filter["daily"][0]["temp"]["max"] = true;
-    filter["daily"][0]["weather"][0]["id"] = true;
-    filter["daily"][0]["weather"][0]["main"] = true;
-    filter["daily"][0]["weather"][0]["description"] = true;
-    filter["daily"][0]["weather"][0]["icon"] = true;
+  // Copy JSON string into fixed size struct field
+  static void copyString(char *dest, size_t size, const char *src) { strlcpy(dest, src ? src : "", size); }
 
-    // serializeJsonPretty(filter, Serial);
+  // OpenWeather icon "nnd" / "nnn" as one byte: number * 2, plus 1 for night. 0 if unknown.
+  static uint8_t packIcon(const char *icon) {
+    if (!icon || !isdigit(icon[0]) || !isdigit(icon[1])) return 0;
+    return ((icon[0] - '0') * 10 + (icon[1] - '0')) * 2 + (icon[2] == 'n');
+  }
+  static const char *unpackIcon(uint8_t code, char (&buffer)[4]) {
+    if (code < 2) return "";
+    snprintf(buffer, sizeof(buffer), "%02u%c", code / 2, code & 1 ? 'n' : 'd');
+    return buffer;
+  }
+
+  // Copy fixed size snapshot field, which may not be terminated
+  template <size_t N>
+  static void copyFixed(char (&dest)[N], const char (&src)[N]) {
+    memcpy(dest, src, N);
+    dest[N - 1] = 0;
+  }
+
+  // Parts to ask for on this poll: current (minutely with OW_NOWCAST, alerts with OW_ALERTS) always,
+  // hourly and daily when their refresh period is up
+  uint8_t dueParts() {
+    uint8_t parts = owCurrent;
+#ifdef OW_NOWCAST
+    parts |= owMinutely;
+#endif
+#ifdef OW_ALERTS
+    parts |= owAlerts;
+#endif
+    if (due(owHourly, _hourlyMillis, OW_HOURLY_SCAN_TIME)) parts |= owHourly;
+    if (due(owDaily, _dailyMillis, OW_DAILY_SCAN_TIME)) parts |= owDaily;
+    return parts;
   }
 
   // Call Openweather API
-  // Populate CurrentWeather and DailyForecast structs
-  int updateWeather() {
-    http.useHTTP10(true);
-    Serial.println(currentWeatherHost);
-    http.begin(currentWeatherHost);
-    // Send HTTP GET request
-    int httpResponseCode = http.GET();
-    Serial.print("HTTP Response code: ");
-    Serial.println(httpResponseCode);
+  // Populate CurrentWeather, HourlyForecast and DailyForecast structs for the requested parts,
+  // other parts are excluded from the response and left as they are
+  // JSON document is parsed into _arena, no general heap allocation for parsing
+  // With OW_GZIP, a gzip response is inflated while it is parsed
+  int updateWeather(uint8_t parts = owAllParts) {
+    static const char *responseHeaders[] = {"Content-Encoding"};
+    unsigned long fetchStart = millis();
+    String exclude;
+    if (!(parts & owMinutely)) exclude += ",minutely";
+    if (!(parts & owHourly)) exclude += ",hourly";
+    if (!(parts & owDaily)) exclude += ",daily";
+    if (!(parts & owAlerts)) exclude += ",alerts";
+    String url = currentWeatherHost;
+    if (exclude.length()) url += "&exclude=" + exclude.substring(1);
+    _fetcher.http.useHTTP10(true);
+    LOG_INFO("OW: fetching %s, parts 0x%02x", _cityName.c_str(), parts);  // Not the URL, it holds the API key
+#ifdef OW_TLS
+    _fetcher.http.begin(_fetcher.tls, url);
+#else
+    _fetcher.http.begin(url);
+#endif
+    _fetcher.http.collectHeaders(responseHeaders, 1);
+#ifdef OW_GZIP
+    bool acceptGzip = _fetcher.gzip.reserve();  // Only ask for gzip if there is heap to inflate it
+    if (acceptGzip) _fetcher.http.addHeader("Accept-Encoding", "gzip");
+#endif
+    // Send HTTP GET request. The body is read while it is parsed, so the guard covers both.
+    StallGuard guard(stallHttpFetch);
+    int httpResponseCode = _fetcher.http.GET();
+    LOG_INFO("HTTP Response code: %d", httpResponseCode);
 
     if (httpResponseCode == 200) {
-      JsonDocument doc;
-      DeserializationError err = deserializeJson(doc, http.getStream(), DeserializationOption::Filter(filter));
+      _fetcher.arena.reset();  // Empty already, starts this refresh's peak
+      JsonDocument doc(&_fetcher.arena);
+      DeserializationError err;
+      uint32_t wireBytes = 0, decodedBytes = 0;
+      bool gzipped = _fetcher.http.header("Content-Encoding") == "gzip";
+      unsigned long parseStart = micros();
+#ifdef OW_GZIP
+      if (gzipped && acceptGzip) {
+        _fetcher.gzip.begin(_fetcher.http.getStream());
+        err = deserializeJson(doc, watchArrays(_fetcher.gzip, parts), DeserializationOption::Filter(_fetcher.filter));
+        if (!err && !_fetcher.gzip.finish()) LOG_ERROR("gzip: body corrupt or truncated");
+        wireBytes = _fetcher.gzip.wireBytes();
+        decodedBytes = _fetcher.gzip.decodedBytes();
+      } else
+#endif
+      if (gzipped) {
+        err = DeserializationError::InvalidInput;  // Not requested, can't decode
+      } else {
+        err = deserializeJson(doc, watchArrays(_fetcher.http.getStream(), parts),
+                              DeserializationOption::Filter(_fetcher.filter));
+        wireBytes = decodedBytes = _fetcher.http.getSize() > 0 ? _fetcher.http.getSize() : 0;
+      }
+      uint32_t parseMicros = micros() - parseStart;
+      uint32_t freeHeap = esp_get_free_heap_size();  // Response, TLS and inflater all held here
+      if (freeHeap < _fetcher.minFreeHeap) _fetcher.minFreeHeap = freeHeap;
+      if (!err) _fetcher.recordFetch(parts, parseMicros, wireBytes, decodedBytes);
+      LOG_INFO("Fetch: %lu ms (parse %u ms), %s, %u bytes on wire, %u bytes decoded", millis() - fetchStart,
+               parseMicros / 1000, gzipped ? "gzip" : "identity", wireBytes, decodedBytes);
+#ifdef OW_TLS
+      _fetcher.tls.report();
+#endif
       if (err) {
-        Serial.print("deserializeJson() failed: ");
-        Serial.println(err.c_str());
+        LOG_ERROR("deserializeJson() failed: %s", err.c_str());
       } else {
         if (!doc.overflowed()) {
           // Serial.println("JSON DOC:");
@@ -286,9 +553,10 @@ class owmWeather {
           weatherNow.lon = doc["lon"].as<float>();
           weatherNow.lat = doc["lat"].as<float>();
           weatherNow.weatherId = doc["current"]["weather"][0]["id"].as<unsigned int>();
-          weatherNow.main = doc["current"]["weather"][0]["main"].as<String>();
-          weatherNow.description = doc["current"]["weather"][0]["description"].as<String>();
-          weatherNow.icon = doc["current"]["weather"][0]["icon"].as<String>();
+          copyString(weatherNow.main, sizeof(weatherNow.main), doc["current"]["weather"][0]["main"].as<const char *>());
+          copyString(weatherNow.description, sizeof(weatherNow.description),
+                     doc["current"]["weather"][0]["description"].as<const char *>());
+          copyString(weatherNow.icon, sizeof(weatherNow.icon), doc["current"]["weather"][0]["icon"].as<const char *>());
           weatherNow.temp = doc["current"]["temp"].as<float>();
           weatherNow.feelsLike = doc["current"]["feels_like"].as<float>();
           weatherNow.pressure = doc["current"]["pressure"].as<unsigned int>();
@@ -297,90 +565,239 @@ class owmWeather {
           weatherNow.windDeg = doc["current"]["wind_deg"].as<float>();
           weatherNow.clouds = doc["current"]["clouds"].as<unsigned int>();
           weatherNow.observationTime = doc["current"]["dt"].as<time_t>();
+          _fetchedParts |= owCurrent;
+          if (parts & owMinutely) {
+            _nowcast = _fetcher.nowcastFold.result();
+            _fetchedParts |= owMinutely;
+            // Times rather than describe()'s text, a log argument can't point at a local buffer
+            LOG_INFO("Nowcast: %u minutes, rain %u to %u, peak %.1f mm/h (%u bytes scanned)", _nowcast.minutes,
+                     (uint32_t)_nowcast.onset, (uint32_t)_nowcast.stop, _nowcast.peak, _fetcher.tap.scannedBytes());
+          }
+          if (parts & owAlerts) {
+            const AlertStore &alerts = _fetcher.alertFold.result();
+            if (!alerts.sameAs(_alerts)) {
+              _alerts = alerts;
+              _alertsChanged = true;
+            }
+            _fetchedParts |= owAlerts;
+            LOG_INFO("Alerts: %u kept, %u dropped%s", _alerts.count, _alerts.dropped, _alertsChanged ? ", changed" : "");
+          }
           // Populate 8-day forecast
-          for (int i = 0; i < 8; i++) {
-            dailyForecast[i].observationTime = doc["daily"][i]["dt"].as<time_t>();
-            dailyForecast[i].tempMin = doc["daily"][i]["temp"]["min"].as<float>();
-            dailyForecast[i].tempMax = doc["daily"][i]["temp"]["max"].as<float>();
-            dailyForecast[i].weatherId = doc["daily"][i]["weather"][0]["id"].as<unsigned int>();
-            dailyForecast[i].main = doc["daily"][i]["weather"][0]["main"].as<String>();
-            dailyForecast[i].description = doc["daily"][i]["weather"][0]["description"].as<String>();
-            dailyForecast[i].icon = doc["daily"][i]["weather"][0]["icon"].as<String>();
+          if ((parts & owDaily) && !doc["daily"].isNull()) {
+            for (int i = 0; i < 8; i++) {
+              dailyForecast[i].observationTime = doc["daily"][i]["dt"].as<time_t>();
+              dailyForecast[i].tempMin = doc["daily"][i]["temp"]["min"].as<float>();
+              dailyForecast[i].tempMax = doc["daily"][i]["temp"]["max"].as<float>();
+              dailyForecast[i].weatherId = doc["daily"][i]["weather"][0]["id"].as<unsigned int>();
+              copyString(dailyForecast[i].main, sizeof(dailyForecast[i].main),
+                         doc["daily"][i]["weather"][0]["main"].as<const char *>());
+              copyString(dailyForecast[i].description, sizeof(dailyForecast[i].description),
+                         doc["daily"][i]["weather"][0]["description"].as<const char *>());
+              copyString(dailyForecast[i].icon, sizeof(dailyForecast[i].icon),
+                         doc["daily"][i]["weather"][0]["icon"].as<const char *>());
+            }
+            _fetchedParts |= owDaily;
+            _dailyMillis = millis();
           }
 
           // Populate hourly forecast
-          for (int i = 0; i < 24; i++) {
-            hourlyForecast[i].observationTime = doc["hourly"][i]["dt"].as<time_t>();
-            hourlyForecast[i].temp = doc["hourly"][i]["temp"].as<float>();
-            hourlyForecast[i].clouds = doc["hourly"][i]["clouds"].as<unsigned int>();
-            hourlyForecast[i].weatherId = doc["hourly"][i]["weather"][0]["id"].as<unsigned int>();
-            hourlyForecast[i].icon = doc["hourly"][i]["weather"][0]["icon"].as<String>();
-            hourlyForecast[i].pop = doc["hourly"][i]["pop"].as<float>();
-            if (doc["hourly"][i]["pop"].isNull() )
-                hourlyForecast[i].pcpt = 0.0;
-              else
-                hourlyForecast[i].pcpt = doc["hourly"][i]["rain"]["1h"].as<float>();
+          if ((parts & owHourly) && !doc["hourly"].isNull()) {
+            JsonArrayConst hours = doc["hourly"];
+            HourlySeries &h = hourlyForecast;
+            h.start = hours[0]["dt"].as<uint32_t>();
+            h.count = 0;
+            for (JsonObjectConst hour : hours) {
+              if (h.count == HOURLY_HOURS) break;
+              uint8_t i = h.count++;
+              h.temp[i] = (int16_t)lroundf(hour["temp"].as<float>() * 10);
+              h.clouds[i] = hour["clouds"].as<uint8_t>();
+              h.weatherId[i] = hour["weather"][0]["id"].as<uint16_t>();
+              h.icon[i] = packIcon(hour["weather"][0]["icon"].as<const char *>());
+              h.pop[i] = (uint8_t)lroundf(hour["pop"].as<float>() * 100);
+              float rain = hour["pop"].isNull() ? 0.0f : hour["rain"]["1h"].as<float>();
+              h.rain[i] = rain >= 25.5f ? 255 : (uint8_t)lroundf(rain * 10);
+            }
+            _fetchedParts |= owHourly;
+            _hourlyMillis = millis();
           }
         } else {
-          Serial.println("ERROR: not enough memory to store the entire document");
+          LOG_ERROR("Not enough memory to store the entire document");
         }
       }
+      LOG_INFO("Arena peak: %u of %u (max %u), heap fallbacks: %u", _fetcher.arena.peak(), _fetcher.arena.capacity(),
+               _fetcher.arena.maxPeak(), _fetcher.arena.heapFallbacks());
     } else {
-      Serial.print("Error code: ");
-      Serial.println(httpResponseCode);
+      LOG_ERROR("Error code: %d", httpResponseCode);
     }
+    _fetcher.arena.reset();  // 'doc' is out of scope
     // Free resources
-    http.end();
+#ifdef OW_GZIP
+    _fetcher.gzip.release();
+#endif
+    _fetcher.http.end();
     return httpResponseCode;
   }
 
-  String currentWeatherDescription() { return weatherNow.description; }
+  // Copy weather model into a snapshot for other stations
+  void toSnapshot(WeatherSnapshot &snap) {
+    SnapshotCurrent &c = snap.current;
+    c.lon = weatherNow.lon;
+    c.lat = weatherNow.lat;
+    c.weatherId = weatherNow.weatherId;
+    memcpy(c.main, weatherNow.main, sizeof(c.main));
+    memcpy(c.description, weatherNow.description, sizeof(c.description));
+    memcpy(c.icon, weatherNow.icon, sizeof(c.icon));
+    c.temp = weatherNow.temp;
+    c.pressure = weatherNow.pressure;
+    c.humidity = weatherNow.humidity;
+    c.feelsLike = weatherNow.feelsLike;
+    c.windSpeed = weatherNow.windSpeed;
+    c.windDeg = weatherNow.windDeg;
+    c.clouds = weatherNow.clouds;
+    c.observationTime = weatherNow.observationTime;
+    for (int i = 0; i < 8; i++) {
+      SnapshotDaily &d = snap.daily[i];
+      d.observationTime = dailyForecast[i].observationTime;
+      d.tempMin = dailyForecast[i].tempMin;
+      d.tempMax = dailyForecast[i].tempMax;
+      d.weatherId = dailyForecast[i].weatherId;
+      memcpy(d.main, dailyForecast[i].main, sizeof(d.main));
+      memcpy(d.description, dailyForecast[i].description, sizeof(d.description));
+      memcpy(d.icon, dailyForecast[i].icon, sizeof(d.icon));
+    }
+    snap.hourly = hourlyForecast;
+    SnapshotNowcast &n = snap.nowcast;
+    n.start = _nowcast.start;
+    n.onset = _nowcast.onset;
+    n.stop = _nowcast.stop;
+    n.peak = _nowcast.peak;
+    n.total = _nowcast.total;
+    n.minutes = _nowcast.minutes;
+    snap.alertCount = _alerts.count;
+    for (int i = 0; i < ALERT_CAPACITY; i++) {
+      SnapshotAlert &a = snap.alerts[i];
+      const WeatherAlert &alert = _alerts.alerts[i];
+      memset(&a, 0, sizeof(a));
+      if (i >= _alerts.count) continue;
+      strncpy(a.event, alert.event, sizeof(a.event));
+      a.start = alert.start;
+      a.end = alert.end;
+      strncpy(a.description, alert.description, sizeof(a.description));
+    }
+  }
+
+  // Replace weather model with a snapshot received from another station
+  void fromSnapshot(const WeatherSnapshot &snap) {
+    const SnapshotCurrent &c = snap.current;
+    weatherNow.lon = c.lon;
+    weatherNow.lat = c.lat;
+    weatherNow.weatherId = c.weatherId;
+    copyFixed(weatherNow.main, c.main);
+    copyFixed(weatherNow.description, c.description);
+    copyFixed(weatherNow.icon, c.icon);
+    weatherNow.temp = c.temp;
+    weatherNow.pressure = c.pressure;
+    weatherNow.humidity = c.humidity;
+    weatherNow.feelsLike = c.feelsLike;
+    weatherNow.windSpeed = c.windSpeed;
+    weatherNow.windDeg = c.windDeg;
+    weatherNow.clouds = c.clouds;
+    weatherNow.observationTime = c.observationTime;
+    for (int i = 0; i < 8; i++) {
+      const SnapshotDaily &d = snap.daily[i];
+      dailyForecast[i].observationTime = d.observationTime;
+      dailyForecast[i].tempMin = d.tempMin;
+      dailyForecast[i].tempMax = d.tempMax;
+      dailyForecast[i].weatherId = d.weatherId;
+      copyFixed(dailyForecast[i].main, d.main);
+      copyFixed(dailyForecast[i].description, d.description);
+      copyFixed(dailyForecast[i].icon, d.icon);
+    }
+    hourlyForecast = snap.hourly;
+    if (hourlyForecast.count > HOURLY_HOURS) hourlyForecast.count = HOURLY_HOURS;
+    const SnapshotNowcast &n = snap.nowcast;
+    _nowcast.start = n.start;
+    _nowcast.onset = n.onset;
+    _nowcast.stop = n.stop;
+    _nowcast.peak = n.peak;
+    _nowcast.total = n.total;
+    _nowcast.minutes = n.minutes;
+    AlertStore alerts = {};
+    alerts.count = snap.alertCount < ALERT_CAPACITY ? snap.alertCount : ALERT_CAPACITY;
+    for (int i = 0; i < alerts.count; i++) {
+      const SnapshotAlert &a = snap.alerts[i];
+      WeatherAlert &alert = alerts.alerts[i];
+      copyFixed(alert.event, a.event);
+      alert.start = a.start;
+      alert.end = a.end;
+      memcpy(alert.description, a.description, sizeof(a.description));
+      alert.description[sizeof(a.description) - 1] = 0;
+      alert.truncated = strlen(alert.description) == sizeof(a.description) - 1;
+    }
+    if (!alerts.sameAs(_alerts)) {
+      _alerts = alerts;
+      _alertsChanged = true;
+    }
+  }
+
+  const char *currentWeatherDescription() { return weatherNow.description; }
   int currentOutdoorTemp() { return (int)weatherNow.temp; }
   int currentHumidity() { return (int)weatherNow.humidity; }
   int currentAtmPressure() { return (int)weatherNow.pressure; }
-  String currentWeatherIcon() { return weatherNow.icon; }
+  const char *currentWeatherIcon() { return weatherNow.icon; }
   int currentWindSpeed() { return (int)weatherNow.windSpeed; }
   int currentWindDirection() { return (int)weatherNow.windDeg; }
-  String cityName() { return _cityName; }
+  const char *cityName() { return _cityName.c_str(); }
+  const Nowcast &nowcast() { return _nowcast; }
+  const AlertStore &alerts() { return _alerts; }
+  // True once after alerts change, e.g. to show them ahead of the rest of the display
+  bool takeAlertsChanged() {
+    bool changed = _alertsChanged;
+    _alertsChanged = false;
+    return changed;
+  }
   time_t observationTime() { return weatherNow.observationTime; }
+  // Result of the last fetch for this location: HTTP status, -1 if WiFi was down. Set by loop().
+  void setFetchStatus(int status) { _fetchStatus = status; }
+  int fetchStatus() { return _fetchStatus; }
 
   // Methods to get daily forecast data
   time_t forecastObservationTime(int i) { return dailyForecast[i].observationTime; }
-  String forecastDayofWeek(int i) {
-    char buffer[20];
-    struct tm *timeinfo;
-    timeinfo = localtime(&dailyForecast[i].observationTime);
-    strftime(buffer, 20, "%a %d", timeinfo);
-    return (String)buffer;
+  // Fill buffer with day of week and day of month, e.g. "Tue 05"
+  const char *forecastDayofWeek(int i, char *buffer, size_t size) {
+    localTz.format(buffer, size, dailyForecast[i].observationTime, "%a %d");
+    return buffer;
   }
-  String forecastDescription(int i) { return dailyForecast[i].description; }
+  const char *forecastDescription(int i) { return dailyForecast[i].description; }
   int forecastTempMin(int i) { return (int)(dailyForecast[i].tempMin + (dailyForecast[i].tempMin >= 0 ? .5 : -.5)); }
   int forecastTempMax(int i) { return (int)(dailyForecast[i].tempMax + (dailyForecast[i].tempMax >= 0 ? .5 : -.5)); }
   int forecastWeatherId(int i) { return (int)dailyForecast[i].weatherId; }
-  String forecastIcon(int i) { return dailyForecast[i].icon; }
-  String getForecastMain(int i) { return dailyForecast[i].main; }
+  const char *forecastIcon(int i) { return dailyForecast[i].icon; }
+  const char *getForecastMain(int i) { return dailyForecast[i].main; }
 
-  // Methods to get Hourly forecast data
-  time_t hourlyObservationTime(int i) { return hourlyForecast[i].observationTime; }
+  // Methods to get Hourly forecast data, i = 0 .. hourlyCount() - 1
+  uint8_t hourlyCount() { return hourlyForecast.count; }
+  time_t hourlyObservationTime(int i) { return (time_t)hourlyForecast.start + i * 3600; }
   int hourlyHourofDay(int i) {
-    struct tm *timeinfo;
-    timeinfo = localtime(&hourlyForecast[i].observationTime);
-    return (int)timeinfo->tm_hour;
+    LocalTm timeinfo;
+    localTz.toLocal(hourlyObservationTime(i), &timeinfo);
+    return (int)timeinfo.hour;
   }
-  String hourlyHourofDayText(int i) {
-    char buffer[20];
-    struct tm *timeinfo;
-    timeinfo = localtime(&hourlyForecast[i].observationTime);
-    strftime(buffer, 20, "%I %p", timeinfo);
-    return (String)buffer;
+  // Fill buffer with 12 hour time, e.g. "03 PM"
+  const char *hourlyHourofDayText(int i, char *buffer, size_t size) {
+    if (i >= hourlyForecast.count) return "";
+    localTz.format(buffer, size, hourlyObservationTime(i), "%I %p");
+    return buffer;
   }
-  int hourlyTemp(int i) { return (int)(hourlyForecast[i].temp + (hourlyForecast[i].temp >= 0 ? .5 : -.5)); }
-  int hourlyClouds(int i) { return (int)hourlyForecast[i].clouds; }
-  int hourlyWeatherId(int i) { return (int)hourlyForecast[i].weatherId; }
-  String hourlyIcon(int i) { return hourlyForecast[i].icon; }
-  int hourlyPop(int i) { return (int)(hourlyForecast[i].pop * 100);}
-  float hourlyPcpt(int i) { return hourlyForecast[i].pcpt;}
-
+  int hourlyTemp(int i) {
+    int16_t t = hourlyForecast.temp[i];
+    return (t + (t >= 0 ? 5 : -5)) / 10;
+  }
+  int hourlyClouds(int i) { return (int)hourlyForecast.clouds[i]; }
+  int hourlyWeatherId(int i) { return (int)hourlyForecast.weatherId[i]; }
+  const char *hourlyIcon(int i, char (&buffer)[4]) { return unpackIcon(hourlyForecast.icon[i], buffer); }
+  int hourlyPop(int i) { return (int)hourlyForecast.pop[i]; }
+  float hourlyPcpt(int i) { return hourlyForecast.rain[i] / 10.0f; }
 
   void dumpCurrentWeather(Stream *_stream) {
     char scratch[26];
@@ -388,9 +805,9 @@ class owmWeather {
     _stream->println("lon : " + (String)weatherNow.lon);
     _stream->println("lat : " + (String)weatherNow.lat);
     _stream->println("id : " + (String)weatherNow.weatherId);
-    _stream->println("main : " + weatherNow.main);
-    _stream->println("description : " + weatherNow.description);
-    _stream->println("icon : " + weatherNow.icon);
+    _stream->println("main : " + (String)weatherNow.main);
+    _stream->println("description : " + (String)weatherNow.description);
+    _stream->println("icon : " + (String)weatherNow.icon);
     _stream->println("temp : " + (String)weatherNow.temp);
     _stream->println("feelsLike : " + (String)weatherNow.feelsLike);
     _stream->println("pressure : " + (String)weatherNow.pressure);
@@ -399,7 +816,7 @@ class owmWeather {
     _stream->println("wind dir : " + (String)weatherNow.windDeg);
     _stream->println("clouds : " + (String)weatherNow.clouds);
     _stream->print("timestamp : " + (String)ctime_r(&weatherNow.observationTime, scratch));
-    _stream->println("city : " + (String)OW_CITY);
+    _stream->println("city : " + _cityName);
     _stream->println();
     for (int i = 0; i < 8; i++) {
       _stream->print("timestamp: " + (String)ctime_r(&dailyForecast[i].observationTime, scratch));
@@ -412,14 +829,16 @@ class owmWeather {
       _stream->println();
     }
 
-    for (int i = 0; i < 24; i++) {
-      _stream->print("timestamp: " + (String)ctime_r(&hourlyForecast[i].observationTime, scratch));
-      _stream->println("temp: " + (String)hourlyForecast[i].temp);
-      _stream->println("id: " + (String)hourlyForecast[i].weatherId);
-      _stream->println("clouds: " + (String)hourlyForecast[i].clouds);
-      _stream->println("icon: " + (String)hourlyForecast[i].icon);
-      _stream->println("pop: " + (String)hourlyForecast[i].pop);
-      _stream->println("pcpt: " + (String)hourlyForecast[i].pcpt);
+    for (int i = 0; i < hourlyForecast.count; i++) {
+      char icon[4];
+      time_t observationTime = hourlyObservationTime(i);
+      _stream->print("timestamp: " + (String)ctime_r(&observationTime, scratch));
+      _stream->println("temp: " + (String)(hourlyForecast.temp[i] / 10.0f));
+      _stream->println("id: " + (String)hourlyForecast.weatherId[i]);
+      _stream->println("clouds: " + (String)hourlyForecast.clouds[i]);
+      _stream->println("icon: " + (String)hourlyIcon(i, icon));
+      _stream->println("pop: " + (String)hourlyForecast.pop[i]);
+      _stream->println("pcpt: " + (String)hourlyPcpt(i));
       _stream->println();
     }
   }
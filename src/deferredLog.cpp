@@ -0,0 +1,146 @@
+#include "deferredLog.h"
+
+#include "taskPlan.h"
+
+DeferredLog deferredLog;
+
+namespace {
+
+// A cell is free for the lap starting at ring position 'lap' when its sequence is
+// lap, and holds that lap's record when it is lap + 1. Zero filled is all free.
+struct Cell {
+  std::atomic<uint32_t> sequence;
+  DeferredLog::Record record;
+};
+
+Cell cells[LOG_RING_SIZE];
+std::atomic<uint32_t> head{0};     // Next position to claim
+std::atomic<uint32_t> tail{0};     // Next position to drain, written by the Log task only
+std::atomic<uint32_t> lost{0};     // Dropped since the last drain
+
+const char levelTags[] = "?EWID";
+
+uint32_t lapOf(uint32_t position) { return position - position % LOG_RING_SIZE; }
+
+void printRecord(Print* out, const DeferredLog::Record& r) {
+  out->printf("%6u.%03u %c ", r.millis / 1000, r.millis % 1000, levelTags[r.level < 5 ? r.level : 0]);
+  char spec[16];
+  uint8_t arg = 0;
+  const char* p = r.format;
+  while (*p) {
+    const char* percent = strchr(p, '%');
+    if (!percent) {
+      out->print(p);
+      break;
+    }
+    out->write((const uint8_t*)p, percent - p);
+    p = percent + 1;
+    if (*p == '%') {
+      out->write('%');
+      p++;
+      continue;
+    }
+    // One conversion at a time, with the argument cast back to the type printf expects
+    size_t n = 0;
+    spec[n++] = '%';
+    while (*p && !strchr("diouxXcsfFeEgG", *p) && n < sizeof(spec) - 2) spec[n++] = *p++;
+    if (!*p) break;
+    char conversion = *p++;
+    spec[n++] = conversion;
+    spec[n] = 0;
+    if (arg >= r.argc) {
+      out->print(spec);
+      continue;
+    }
+    uintptr_t pointer = r.args[arg];
+    uint32_t word = (uint32_t)pointer;
+    DeferredLog::ArgType type = (DeferredLog::ArgType)((r.types >> (2 * arg)) & 3);
+    arg++;
+    float f;
+    memcpy(&f, &word, sizeof(f));
+    switch (conversion) {
+      case 's':
+        out->printf(spec, type == DeferredLog::argString && pointer ? (const char*)pointer : "?");
+        break;
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+        out->printf(spec, type == DeferredLog::argFloat    ? (double)f
+                          : type == DeferredLog::argSigned ? (double)(int32_t)word
+                                                           : (double)word);
+        break;
+      default:
+        out->printf(spec, type == DeferredLog::argFloat ? (uint32_t)(int32_t)f : word);
+    }
+  }
+  out->println();
+}
+
+void logTask(void*) {
+  for (;;) {
+    deferredLog.drain(&Serial);
+    vTaskDelay(LOG_DRAIN_MS / portTICK_PERIOD_MS);
+  }
+}
+
+}  // namespace
+
+void DeferredLog::push(uint8_t level, const char* format, const Arg* args, uint8_t argc) {
+  uint32_t position = head.load(std::memory_order_relaxed);
+  Cell* cell;
+  for (;;) {
+    cell = &cells[position % LOG_RING_SIZE];
+    int32_t lag = (int32_t)(cell->sequence.load(std::memory_order_acquire) - lapOf(position));
+    if (lag == 0) {
+      // Free, claim it. On failure position is reloaded.
+      if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+    } else if (lag < 0) {
+      // Still holds the previous lap's record: full
+      lost.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } else {
+      position = head.load(std::memory_order_relaxed);  // Claimed by another task
+    }
+  }
+
+  Record& r = cell->record;
+  r.format = format;
+  r.millis = xTaskGetTickCount() * portTICK_PERIOD_MS;
+  r.level = level;
+  r.argc = argc;
+  r.types = 0;
+  for (uint8_t i = 0; i < argc; i++) {
+    r.args[i] = args[i].word;
+    r.types |= args[i].type << (2 * i);
+  }
+  cell->sequence.store(lapOf(position) + 1, std::memory_order_release);
+}
+
+void DeferredLog::begin() { startTask(logTask, logPlacement); }
+
+void DeferredLog::drain(Print* out) {
+  for (;;) {
+    uint32_t position = tail.load(std::memory_order_relaxed);
+    Cell& cell = cells[position % LOG_RING_SIZE];
+    if (cell.sequence.load(std::memory_order_acquire) != lapOf(position) + 1) break;
+    Record r = cell.record;
+    cell.sequence.store(lapOf(position) + LOG_RING_SIZE, std::memory_order_release);
+    tail.store(position + 1, std::memory_order_relaxed);
+    printRecord(out, r);
+  }
+  uint32_t dropped = lost.exchange(0, std::memory_order_relaxed);
+  if (dropped) out->printf("Log: %u records dropped\n", dropped);
+}
+
+bool DeferredLog::waitForRoom(uint8_t records, uint32_t maxMs) {
+  if (records > LOG_RING_SIZE) records = LOG_RING_SIZE;
+  unsigned long start = millis();
+  while (head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed) > (uint32_t)(LOG_RING_SIZE - records)) {
+    if (millis() - start >= maxMs) return false;
+    vTaskDelay(LOG_DRAIN_MS / portTICK_PERIOD_MS);
+  }
+  return true;
+}
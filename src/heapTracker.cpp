@@ -0,0 +1,306 @@
+#include "heapTracker.h"
+
+#ifdef HEAP_TRACKER
+
+#include <stddef.h>
+
+#include <new>
+
+#ifdef ESP_PLATFORM
+#include <esp_heap_caps.h>
+#if __has_include(<esp_memory_utils.h>)
+#include <esp_memory_utils.h>
+#else
+#include <soc/soc_memory_layout.h>
+#endif
+#else
+#include <atomic>
+#endif
+
+#include "deferredLog.h"
+
+extern "C" {
+void* __real_malloc(size_t);
+void __real_free(void*);
+void* __real_realloc(void*, size_t);
+void* __real_calloc(size_t, size_t);
+#ifdef ESP_PLATFORM
+void __real_heap_caps_free(void*);
+#endif
+}
+
+HeapTracker heapTracker;
+
+namespace {
+
+using Site = HeapTracker::Site;
+
+const uint32_t blockMagic = 0x48545243;  // "HTRC"
+
+// Placed in front of every tracked block, keeps the block maximally aligned.
+// check ties the header to its own address and size, so stray bytes in front of
+// an untracked block are not taken for a header.
+union BlockHeader {
+  struct {
+    uint32_t magic;
+    uint16_t site;
+    uint32_t size;
+    uint32_t check;
+  } info;
+  max_align_t align;
+};
+
+Site sites[HEAP_TRACKER_SITES];
+HeapTracker::HeapSample history[HEAP_TRACKER_HISTORY];
+uint8_t historyHead = 0;
+uint8_t historyCount = 0;
+
+#ifdef ESP_PLATFORM
+portMUX_TYPE trackerMux = portMUX_INITIALIZER_UNLOCKED;
+void lock() { portENTER_CRITICAL(&trackerMux); }
+void unlock() { portEXIT_CRITICAL(&trackerMux); }
+#else
+std::atomic_flag trackerFlag = ATOMIC_FLAG_INIT;
+void lock() {
+  while (trackerFlag.test_and_set(std::memory_order_acquire)) {
+  }
+}
+void unlock() { trackerFlag.clear(std::memory_order_release); }
+#endif
+
+// Find or claim a slot for caller address. Call with lock held.
+uint16_t findSite(uintptr_t pc) {
+  uint16_t start = (uint16_t)(((pc >> 2) * 2654435761u) % (HEAP_TRACKER_SITES - 1)) + 1;
+  uint16_t i = start;
+  do {
+    if (sites[i].pc == pc) return i;
+    if (sites[i].pc == 0) {
+      sites[i].pc = pc;
+      return i;
+    }
+    i = (i % (HEAP_TRACKER_SITES - 1)) + 1;  // Slot 0 is the overflow slot
+  } while (i != start);
+  return 0;
+}
+
+uint32_t checkOf(const BlockHeader* header, uint32_t size) {
+  return blockMagic ^ (uint32_t)(uintptr_t)header ^ (size * 2654435761u);
+}
+
+// Header of a block from trackedMalloc(), nullptr for any other pointer: blocks
+// allocated before tracking started, by heap_caps_malloc() or by the ROM.
+BlockHeader* headerOf(void* ptr) {
+  if ((uintptr_t)ptr % alignof(BlockHeader) != 0) return nullptr;  // Not from malloc()
+  BlockHeader* header = (BlockHeader*)ptr - 1;
+#ifdef ESP_PLATFORM
+  // Don't read in front of a block at the start of a memory region
+  if (!esp_ptr_byte_accessible(header)) return nullptr;
+#endif
+  if (header->info.magic != blockMagic) return nullptr;
+  return header->info.check == checkOf(header, header->info.size) ? header : nullptr;
+}
+
+void recordAlloc(BlockHeader* header, size_t size, uintptr_t pc) {
+  lock();
+  uint16_t site = findSite(pc);
+  Site& s = sites[site];
+  s.allocs++;
+  s.liveBytes += size;
+  if (s.liveBytes > s.peakLiveBytes) s.peakLiveBytes = s.liveBytes;
+  unlock();
+  header->info.magic = blockMagic;
+  header->info.site = site;
+  header->info.size = size;
+  header->info.check = checkOf(header, size);
+}
+
+void recordFree(BlockHeader* header) {
+  lock();
+  Site& s = sites[header->info.site];
+  s.frees++;
+  s.liveBytes -= header->info.size;
+  unlock();
+  header->info.magic = 0;
+  header->info.check = 0;
+}
+
+void* trackedMalloc(size_t size, uintptr_t pc) {
+  BlockHeader* header = (BlockHeader*)__real_malloc(sizeof(BlockHeader) + size);
+  if (header == nullptr) return nullptr;
+  recordAlloc(header, size, pc);
+  return header + 1;
+}
+
+void trackedFree(void* ptr) {
+  if (ptr == nullptr) return;
+  BlockHeader* header = headerOf(ptr);
+  if (header == nullptr) {
+    __real_free(ptr);  // Allocated before tracking or via heap_caps_malloc()
+    return;
+  }
+  recordFree(header);
+  __real_free(header);
+}
+
+}  // namespace
+
+// Linker wrapped allocation functions
+extern "C" {
+
+void* __wrap_malloc(size_t size) { return trackedMalloc(size, (uintptr_t)__builtin_return_address(0)); }
+
+void* __wrap_calloc(size_t count, size_t size) {
+  size_t total = count * size;
+  if (size != 0 && total / size != count) return nullptr;
+  void* ptr = trackedMalloc(total, (uintptr_t)__builtin_return_address(0));
+  if (ptr) memset(ptr, 0, total);
+  return ptr;
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+  uintptr_t pc = (uintptr_t)__builtin_return_address(0);
+  if (ptr == nullptr) return trackedMalloc(size, pc);
+  if (size == 0) {
+    trackedFree(ptr);
+    return nullptr;
+  }
+  BlockHeader* header = headerOf(ptr);
+  if (header == nullptr) return __real_realloc(ptr, size);
+
+  // Resized block is attributed to the caller of realloc()
+  BlockHeader saved = *header;
+  recordFree(header);
+  BlockHeader* newHeader = (BlockHeader*)__real_realloc(header, sizeof(BlockHeader) + size);
+  if (newHeader == nullptr) {
+    // Original block is untouched, restore its accounting
+    *header = saved;
+    lock();
+    sites[saved.info.site].frees--;
+    sites[saved.info.site].liveBytes += saved.info.size;
+    unlock();
+    return nullptr;
+  }
+  recordAlloc(newHeader, size, pc);
+  return newHeader + 1;
+}
+
+void __wrap_free(void* ptr) { trackedFree(ptr); }
+
+#ifdef ESP_PLATFORM
+// free() ends in heap_caps_free() with the real block, which is never a tracked
+// pointer. A tracked block handed straight to heap_caps_free() is unwrapped here.
+void __wrap_heap_caps_free(void* ptr) {
+  BlockHeader* header = ptr ? headerOf(ptr) : nullptr;
+  if (header == nullptr) {
+    __real_heap_caps_free(ptr);
+    return;
+  }
+  recordFree(header);
+  __real_heap_caps_free(header);
+}
+#endif
+
+}  // extern "C"
+
+// C++ allocations are attributed to the caller of new, not to operator new itself
+void* operator new(size_t size) {
+  void* ptr = trackedMalloc(size, (uintptr_t)__builtin_return_address(0));
+  if (ptr == nullptr) abort();
+  return ptr;
+}
+void* operator new[](size_t size) {
+  void* ptr = trackedMalloc(size, (uintptr_t)__builtin_return_address(0));
+  if (ptr == nullptr) abort();
+  return ptr;
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return trackedMalloc(size, (uintptr_t)__builtin_return_address(0));
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return trackedMalloc(size, (uintptr_t)__builtin_return_address(0));
+}
+void operator delete(void* ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { trackedFree(ptr); }
+
+/// @brief Record heap statistics and update per-site growth streaks
+///        Call periodically, e.g. from heartbeat()
+void HeapTracker::sample() {
+  HeapSample s = {};
+  s.uptimeSeconds = millis() / 1000;
+#ifdef ESP_PLATFORM
+  s.freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  s.largestFreeBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  s.minFreeBytes = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+#endif
+  s.fragmentation = s.freeBytes ? 1000 - (uint16_t)((uint64_t)s.largestFreeBlock * 1000 / s.freeBytes) : 0;
+  history[historyHead] = s;
+  historyHead = (historyHead + 1) % HEAP_TRACKER_HISTORY;
+  if (historyCount < HEAP_TRACKER_HISTORY) historyCount++;
+
+  lock();
+  for (auto& site : sites) {
+    if (site.pc == 0 && site.allocs == 0) continue;
+    if (site.liveBytes > site.sampledLiveBytes) {
+      if (site.growStreak < 255) site.growStreak++;
+    } else {
+      site.growStreak = 0;
+    }
+    site.sampledLiveBytes = site.liveBytes;
+  }
+  unlock();
+}
+
+/// @brief Log heap history and allocation sites
+void HeapTracker::report() {
+  deferredLog.waitForRoom(2);
+  LOG_INFO("Heap history (uptime s, free, largest, min free, frag %%):");
+  for (uint8_t i = 0; i < historyCount; i++) {
+    const HeapSample& s = history[(historyHead + HEAP_TRACKER_HISTORY - historyCount + i) % HEAP_TRACKER_HISTORY];
+    deferredLog.waitForRoom(1);
+    LOG_INFO("  %8u %7u %7u %7u %3u.%u", s.uptimeSeconds, s.freeBytes, s.largestFreeBlock, s.minFreeBytes,
+             s.fragmentation / 10, s.fragmentation % 10);
+  }
+
+  deferredLog.waitForRoom(1);
+  LOG_INFO("Allocation sites (pc, allocs, frees, live, peak):");
+  for (uint16_t i = 0; i < HEAP_TRACKER_SITES; i++) {
+    lock();
+    Site site = sites[i];
+    unlock();
+    if (site.allocs == 0) continue;
+    deferredLog.waitForRoom(1);
+    LOG_INFO("  0x%08x %7u %7u %7d %7d%s", (unsigned)site.pc, site.allocs, site.frees, site.liveBytes,
+             site.peakLiveBytes, isLeakSuspect(site) ? "  LEAK?" : "");
+  }
+  deferredLog.waitForRoom(1);
+  LOG_INFO("Total allocs: %u, live bytes: %d", totalAllocs(), totalLiveBytes());
+}
+
+HeapTracker::Site HeapTracker::siteOf(void* ptr) {
+  BlockHeader* header = ptr ? headerOf(ptr) : nullptr;
+  if (header == nullptr) return {};
+  lock();
+  Site site = sites[header->info.site];
+  unlock();
+  return site;
+}
+
+uint32_t HeapTracker::totalAllocs() {
+  uint32_t total = 0;
+  lock();
+  for (auto& site : sites) total += site.allocs;
+  unlock();
+  return total;
+}
+
+int32_t HeapTracker::totalLiveBytes() {
+  int32_t total = 0;
+  lock();
+  for (auto& site : sites) total += site.liveBytes;
+  unlock();
+  return total;
+}
+
+#endif  // HEAP_TRACKER
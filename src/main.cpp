@@ -7,17 +7,80 @@
 #include <ArduinoOTA.h>
 #include <WiFi.h>
 
+#include "deferredLog.h"
+#include "fleet.h"
+#include "heapTracker.h"
 #include "localtime.h"
+#include "nextionBindings.h"
 #include "nextionInterface.h"
+#include "powerPlan.h"
+#include "psychro.h"
 #include "ruuvi.h"
+#include "stallWatch.h"
+#include "taskPlan.h"
 #include "weather.h"
 
-RuuviScan ruuviScan;
+// Defaults for settings.h files made before these settings, see settings-dist.h
+#ifndef LOCATION_CYCLE_SECONDS
+#define LOCATION_CYCLE_SECONDS 20
+#endif
+#ifndef NEXTION_HOURLY_PAGE_ID
+#define NEXTION_HOURLY_PAGE_ID 2
+#define NEXTION_HOURLY_BACK_ID 60
+#define NEXTION_HOURLY_FORWARD_ID 61
+#endif
+#ifndef HOURLY_SCROLL_STEP
+#define HOURLY_SCROLL_STEP 4
+#endif
+#ifndef RTC_DRIFT_CHECK_MINUTES
+#define RTC_DRIFT_CHECK_MINUTES 60
+#define RTC_DRIFT_THRESHOLD 2
+#endif
 
-owmWeather currentWeather((String)OW_CITY, (float)OW_LAT, (float)OW_LON, (String)OW_API_KEY);
-void getWeather();
-int weatherIconToNextionPictureLarge(String);
-int weatherIconToNextionPictureSmall(String);
+RuuviScan ruuviScan;
+RuuviMetrics indoorMetrics(indoorTag);  // Dew point, heat index... derived when read, see psychro.h
+RuuviMetrics outdoorMetrics(outdoorTag);
+void scanRuuvi(void*);
+TaskHandle_t xhandleScanHandle = NULL;
+
+owmFetcher weatherFetcher;  // HTTP, parser, inflater and TLS session shared by all locations
+owmWeather weatherLocations[] = {
+    {OW_CITY, OW_LAT, OW_LON, OW_API_KEY, weatherFetcher},
+#ifdef OW_LOCATION_2
+    {OW_LOCATION_2, OW_API_KEY, weatherFetcher},
+#endif
+#ifdef OW_LOCATION_3
+    {OW_LOCATION_3, OW_API_KEY, weatherFetcher},
+#endif
+#ifdef OW_LOCATION_4
+    {OW_LOCATION_4, OW_API_KEY, weatherFetcher},
+#endif
+};
+const uint8_t locationCount = sizeof(weatherLocations) / sizeof(weatherLocations[0]);
+owmWeather& currentWeather = weatherLocations[0];  // Primary location, the one shared with the fleet
+uint8_t shownLocation = 0;                         // Location on the display
+void requestWeather();
+void fetchWeather(void*);
+void weatherFetched(uint8_t location, int status);
+TaskHandle_t xhandleWeatherHandle = NULL;
+QueueHandle_t weatherRequests;  // Location to fetch, loop() to weather task
+QueueHandle_t weatherResults;   // Location fetched and HTTP status, weather task to loop()
+struct WeatherResult {
+  uint8_t location;
+  int status;
+};
+int8_t fetchingLocation = -1;   // Location being fetched, its model belongs to the weather task until the result is in
+uint8_t weatherPending = 0;     // Locations waiting to be fetched, one bit each
+void renderWeather();
+void renderHourly();
+void renderAlertBanner();
+BindingShadow<sizeof(weatherBindings) / sizeof(weatherBindings[0])> weatherShadow;  // Main page as last written
+BindingShadow<sizeof(hourlyBindings) / sizeof(hourlyBindings[0])> hourlyShadow;  // Hourly page as last written
+uint8_t hourlyOffset = 0;        // First hour on the Hourly page
+volatile int8_t hourlyScroll = 0;  // Scroll request from a touch event, -1 back / +1 forward
+Fleet fleet;  // Stations at this location share one fetch, see fleet.h
+TaskStats taskStats;  // CPU use per core and task, see taskPlan.h
+PowerPlan powerPlan;  // Loop idling, radio turns and energy estimate, see powerPlan.h
 
 Time currentTime;
 void uptime();
@@ -29,22 +92,40 @@ TaskHandle_t xhandleNextionHandle = NULL;
 
 void heartbeat();
 void readRuuvi();
+void renderRuuvi();
+void renderWake();
+BindingShadow<6> ruuviShadow;  // Ruuvi temperatures, colours and status as last written, see renderRuuvi()
+void setNextionRTC();
+void checkNextionRTCDrift();
 
 void setup() {
   Serial.begin(115200);
   delay(2000);
+  deferredLog.begin();  // LOG_* records go out from here on
+  stallWatch.begin();   // Logs stalls recorded before the last reset
   // Start Nextion task
   myNex.begin();  // Initialize Nextion interface
-  xTaskCreate(handleNextion, "Nextion Handler", 3000, NULL, 6, &xhandleNextionHandle);
+#ifdef NEXTION_ACKED_WRITES
+  myNex.enableAcks(true);
+#endif
+  xhandleNextionHandle = startTask(handleNextion, nextionPlacement);
 
   // Initialize Ruuvi BLE scanner
   ruuviScan.begin();
+#ifdef RUUVI_CAPTURE
+  ruuviScan.startCapture();
+#endif
+#ifdef PSYCHRO_BENCHMARK
+  psychroBenchmark(&Serial);
+#endif
+  xhandleScanHandle = startTask(scanRuuvi, scanPlacement);
   delay(1000);
 
   WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
   WiFi.setHostname(DEVICE_NAME);
   WiFi.setAutoReconnect(true);
   vTaskDelay(5000 / portTICK_PERIOD_MS);
+  powerPlan.begin();
 
   // Initialize OTA Update libraries
   ArduinoOTA.setHostname(DEVICE_NAME);
@@ -53,19 +134,51 @@ void setup() {
   // Start SNTP task
   currentTime.begin();
 
-  Serial.println(DEVICE_NAME + (String) " is Woke");
+  LOG_INFO("%s is Woke", DEVICE_NAME);
 
-  // First run - update weather
-  getWeather();
+#ifdef FLEET_MODE
+  fleet.begin(OW_LAT, OW_LON);
+  if (fleet.active()) {
+    fleet.discover(2000, currentWeather);  // Find leader before fetching
+  }
+#endif
+
+  // First run - update weather, one location at a time (followers wait for the leader's snapshot)
+  weatherRequests = xQueueCreate(1, sizeof(uint8_t));
+  weatherResults = xQueueCreate(1, sizeof(WeatherResult));
+  xhandleWeatherHandle = startTask(fetchWeather, weatherPlacement);
+  for (uint8_t i = 0; i < locationCount; i++) {
+    if (i > 0 || fleet.isLeader()) weatherPending |= 1 << i;
+  }
 
+  vTaskPrioritySet(NULL, TASK_LOOP_PRIORITY);
+  taskStats.printPlan();
 }
 
 unsigned long heartbeatMillis = millis();
 unsigned long weatherTimerMillis = millis();
+unsigned long locationCycleMillis = millis();
+uint8_t nextLocation = 0;  // Next location to fetch. Fetches are spread evenly over OW_SCAN_TIME.
 unsigned long RTCClockTimerMillis = millis();
-bool setRTC = true;  // Track if just rebooted
+
+// Loop latency, UART occupancy and heap trend, reported and reset each heartbeat
+struct LoopStats {
+  uint32_t iterations = 0;
+  uint32_t maxMicros = 0;
+  uint64_t totalMicros = 0;
+  uint32_t txBytes = 0;      // myNex.txBytes() at last report
+  uint32_t txCommands = 0;   // myNex.txCommands() at last report
+  uint32_t freeHeap = 0;     // Free heap at last report
+  unsigned long millis = 0;  // Time of last report
+} loopStats;
+void reportLoopStats();
+uint32_t rtcSyncCount = 0;  // SNTP sync count when Nextion RTC was last set, zero until first sync
+time_t nextRTCSet = 0;      // Next DST transition, Nextion RTC is reset then
+uint32_t rtcRetryMillis = 0;  // After a failed set: wait before the next try, doubles up to the drift check interval
+unsigned long rtcFailedMillis = 0;
 
 void loop() {
+  unsigned long loopStartMicros = micros();
   ArduinoOTA.handle();
   // Every 30 seconds
   if ((millis() - heartbeatMillis) >= HEARTBEAT_INTERVAL_MILLIS) {
@@ -73,212 +186,448 @@ void loop() {
     readRuuvi();
     heartbeatMillis = millis();
   }
-  // Every OW_SCAN_TIME minutes
-  if ((millis() - weatherTimerMillis) >= OW_SCAN_TIME * 60000)
-  {
-    getWeather();
+  // Weather from fleet leader, held by the fleet while the primary location is being fetched here
+  if (fleet.poll(fetchingLocation != 0 ? &currentWeather : nullptr)) {
+    currentWeather.setFetchStatus(200);
+    if (shownLocation == 0 && currentWeather.takeAlertsChanged()) renderAlertBanner();
+    if (shownLocation == 0) renderWeather();
+    if (nextLocation == 0) weatherTimerMillis = millis();
+  }
+  // Every OW_SCAN_TIME minutes for each location, staggered so only one response is in memory at a time.
+  // The primary location is skipped when another station fetches it for us. Slower while the display sleeps.
+  uint32_t weatherInterval = OW_SCAN_TIME * 60000 / locationCount * (myNex.sleeping() ? DISPLAY_SLEEP_SLOWDOWN : 1);
+  if ((millis() - weatherTimerMillis) >= weatherInterval) {
+    if (nextLocation > 0 || fleet.isLeader()) weatherPending |= 1 << nextLocation;
+    nextLocation = (nextLocation + 1) % locationCount;
     weatherTimerMillis = millis();
     // currentWeather.dumpCurrentWeather(&Serial);
   }
-  // Set Nextion Real Time Clock on bootup
-  tm localTime;
-  if (setRTC && WiFi.isConnected() && currentTime.now(&localTime)) {
-    myNex.setRTC(localTime);
-    setRTC = false;
-    Serial.println("RTC set");
+  // Fetches run in the weather task, results are displayed here
+  WeatherResult result;
+  if (fetchingLocation >= 0 && xQueueReceive(weatherResults, &result, 0) == pdTRUE) {
+    fetchingLocation = -1;
+    weatherFetched(result.location, result.status);
   }
-
-  // Every hour, check if 3am, if so set NextionRTC
-  // RTC drift is minor - this could be called less often
-  // The reason for a 3am check is to handle daylight savings time
-  if ((millis() - RTCClockTimerMillis) >= 60 * 60 * 1000) {
-    tm localTime;
-    if (WiFi.isConnected() && currentTime.now(&localTime)) {
-      if (localTime.tm_hour == 3) {
-        myNex.setRTC(localTime);
-        setRTC = false;
-        Serial.println("RTC set");
+  if (fetchingLocation < 0 && weatherPending) requestWeather();
+  // Scroll Hourly page, only the slots that change are written. Waits while the shown location is being fetched.
+  if (hourlyScroll && shownLocation != fetchingLocation) {
+    int step = hourlyScroll * HOURLY_SCROLL_STEP;
+    hourlyScroll = 0;
+    hourlyOffset = constrain((int)hourlyOffset + step, 0, HOURLY_HOURS - HOURLY_WINDOW);
+    renderHourly();
+  }
+  // Display woke, or restarted and lost what it showed: one burst of what changed meanwhile
+  static uint32_t wakesSeen = 0, readiesSeen = 0;
+  if (myNex.readyCount() != readiesSeen) {
+    readiesSeen = myNex.readyCount();
+    wakesSeen = myNex.wakeCount();
+    myNex.reinitAcks();  // The reset turned them off and lost what was in flight
+    weatherShadow.invalidate();
+    hourlyShadow.invalidate();
+    ruuviShadow.invalidate();
+    renderWake();
+  } else if (myNex.wakeCount() != wakesSeen) {
+    wakesSeen = myNex.wakeCount();
+    renderWake();
+  }
+  // Writes refused or abandoned: the display may show anything, repaint it all once the link answers again
+  static uint32_t lostSeen = 0;
+  static unsigned long repaintMillis = 0;
+  if (myNex.lostWrites() != lostSeen && !myNex.sleeping() && (millis() - repaintMillis) >= NEXTION_REPAINT_MS) {
+    LOG_WARN("Display: %u writes lost, repainting", myNex.lostWrites() - lostSeen);
+    lostSeen = myNex.lostWrites();
+    repaintMillis = millis();
+    weatherShadow.invalidate();
+    hourlyShadow.invalidate();
+    ruuviShadow.invalidate();
+    renderRuuvi();
+    if (shownLocation != fetchingLocation) renderWeather();  // Else rendered when the fetch completes
+  }
+  // Cycle the display through locations that have weather
+  if (locationCount > 1 && !myNex.sleeping() && (millis() - locationCycleMillis) >= LOCATION_CYCLE_SECONDS * 1000) {
+    for (uint8_t i = 1; i < locationCount; i++) {
+      uint8_t location = (shownLocation + i) % locationCount;
+      if (location != fetchingLocation && weatherLocations[location].observationTime()) {
+        shownLocation = location;
+        renderWeather();
+        break;
       }
     }
+    locationCycleMillis = millis();
+  }
+  // Set Nextion Real Time Clock after first SNTP sync and on each DST transition
+  if (((rtcSyncCount == 0 && currentTime.syncCount() > 0) || (nextRTCSet && time(nullptr) >= nextRTCSet)) &&
+      (millis() - rtcFailedMillis) >= rtcRetryMillis) {
+    setNextionRTC();
+  }
+
+  // Every RTC_DRIFT_CHECK_MINUTES, read Nextion RTC back and correct if drifted
+  if ((millis() - RTCClockTimerMillis) >= RTC_DRIFT_CHECK_MINUTES * 60000) {
+    if (rtcSyncCount > 0 && !myNex.sleeping()) checkNextionRTCDrift();
     RTCClockTimerMillis = millis();
   }
+
+  uint32_t loopMicros = micros() - loopStartMicros;
+  loopStats.iterations++;
+  loopStats.totalMicros += loopMicros;
+  if (loopMicros > loopStats.maxMicros) loopStats.maxMicros = loopMicros;
+
+  // Sleep until the next timer is due, Nextion events and fetch results wake loop() sooner
+  powerPlan.display(!myNex.sleeping());
+  powerPlan.due(heartbeatMillis, HEARTBEAT_INTERVAL_MILLIS);
+  powerPlan.due(weatherTimerMillis, weatherInterval);
+  if (locationCount > 1 && !myNex.sleeping()) powerPlan.due(locationCycleMillis, LOCATION_CYCLE_SECONDS * 1000);
+  powerPlan.due(RTCClockTimerMillis, RTC_DRIFT_CHECK_MINUTES * 60000);
+  powerPlan.idle();
 }
 
-//Get weather from OpenWeatherMap
-void getWeather() {
-  int status = 0;
-  if (WiFi.isConnected()) {
-    Serial.println("Calling currentWeather()");
-    status = currentWeather.updateWeather();
-    if (status == 200) {
-      // currentWeather.dumpCurrentWeather(&Serial);
-      myNex.writeNum((String) "page0.humidity.val", currentWeather.currentHumidity());
-      myNex.writeStr((String) "page0.wxDescription.txt", currentWeather.currentWeatherDescription());
-      myNex.writeNum((String) "page0.windSpeed.val", currentWeather.currentWindSpeed());
-      myNex.writeNum((String) "page0.windDirection.val", currentWeather.currentWindDirection());
-      myNex.writeStr((String) "page0.City.txt", currentWeather.cityName());
-      myNex.writeCmd((String) "page0.wxIcon.pic=" +
-                      (String)weatherIconToNextionPictureLarge(currentWeather.currentWeatherIcon()));
-
-      time_t now = currentWeather.observationTime();
-      char str[20];
-      strftime(str, sizeof(str), "OW: %a %H:%M", localtime(&now));
-      myNex.writeStr("page0.statusTxt.txt", str);
-      myNex.writeStr("Setup.WeatherStatus.txt", str);
-
-      // Five daily forecasts
-      for (int i = 0; i < 5; i++) {
-        myNex.writeStr((String) "page0.dateTime" + (String)(i + 1) + ".txt", currentWeather.forecastDayofWeek(i));
-        myNex.writeStr((String) "page0.forecastTxt" + (String)(i + 1) + ".txt",
-                        (String)currentWeather.forecastDescription(i));
-        myNex.writeNum((String) "page0.forecastMin" + (String)(i + 1) + ".val", currentWeather.forecastTempMin(i));
-        myNex.writeNum((String) "page0.forecastMax" + (String)(i + 1) + ".val", currentWeather.forecastTempMax(i));
-        myNex.writeCmd((String) "page0.forecastIcon" + (String)(i + 1) +
-                        ".pic=" + (String)weatherIconToNextionPictureLarge(currentWeather.forecastIcon(i)));
-      }
-      // Hourly forecast heading
-      for (int i = 0; i < 12; i+=4) {
-        myNex.writeStr((String) "Hourly.hour" + (String)(i + 1) + ".txt", currentWeather.hourlyHourofDayText(i));
-      }
-      // 12 hourly forecasts
-      for (int i = 0; i < 12; i++) {
-        myNex.writeNum((String) "Hourly.temp" + (String)(i + 1) + ".val", currentWeather.hourlyTemp(i));
-        myNex.writeCmd((String) "Hourly.clouds" + (String)(i + 1) +
-                        ".pic=" + (String)weatherIconToNextionPictureSmall(currentWeather.hourlyIcon(i)));
-        myNex.writeNum((String) "Hourly.pop" + (String)(i + 1) + ".val", currentWeather.hourlyPop(i));
-
-        // Convert rain mm/hr into 0-100 integer for Nextion progress bars
-        // Consider 5mm/hr to be full scale
-        int rain = (int)(currentWeather.hourlyPcpt(i) * 20);
-        // Serial.printf("%i : %2.2f\n",rain,currentWeather.hourlyPcpt(i));
-        if (rain > 100)
-          rain = 100;
-        if(rain > 0 && rain <= 5)
-          rain=5;
-        myNex.writeNum((String) "Hourly.pcpt" + (String)(i + 1) + ".val", rain);
-      }
-    } else {
-      myNex.writeStr("page0.statusTxt.txt", "OW Call Fail");
-      myNex.writeStr("Setup.WeatherStatus.txt", "OW Call Fail");
-    }
+// Log loop latency, Nextion UART occupancy and heap trend since last report
+void reportLoopStats() {
+  unsigned long elapsed = millis() - loopStats.millis;
+  uint32_t txBytes = myNex.txBytes() - loopStats.txBytes;
+  uint32_t txCommands = myNex.txCommands() - loopStats.txCommands;
+  uint32_t txBusyMillis = (uint32_t)((uint64_t)txBytes * 10 * 1000 / myNex.baud());  // 8N1, 10 bits per byte
+  uint32_t freeHeap = esp_get_free_heap_size();
+
+  deferredLog.waitForRoom(5);
+  LOG_INFO("Loop: %u iter, avg %u us, max %u us", loopStats.iterations,
+           loopStats.iterations ? (uint32_t)(loopStats.totalMicros / loopStats.iterations) : 0, loopStats.maxMicros);
+  uint32_t busyPermille = elapsed ? (uint32_t)(txBusyMillis * 1000 / elapsed) : 0;
+  LOG_INFO("UART: %u cmds, %u bytes, %u.%u%% busy | Heap: %u (%+d)", txCommands, txBytes, busyPermille / 10,
+           busyPermille % 10, freeHeap, loopStats.freeHeap ? (int)(freeHeap - loopStats.freeHeap) : 0);
+
+  if (myNex.acksEnabled()) {
+    myNextionInterface::AckStats acks = myNex.ackStats();
+    LOG_INFO("Acks: %u ok, %u failed (last 0x%02X), %u timeouts, %u resyncs, %u resent", acks.acked, acks.failed,
+             acks.lastError, acks.timeouts, acks.resyncs, acks.resent);
+    LOG_INFO("Acks: %u abandoned, %u stray, %u discarded, %u window stalls, %u refused, %u priority", acks.abandoned,
+             acks.stray, acks.discarded, acks.windowStalls, acks.refused, acks.priority);
+    LOG_INFO("Acks: RTT avg %u us, max %u us", acks.acked ? (uint32_t)(acks.rttTotalMicros / acks.acked) : 0,
+             acks.rttMaxMicros);
+  }
+
+  loopStats.iterations = 0;
+  loopStats.maxMicros = 0;
+  loopStats.totalMicros = 0;
+  loopStats.txBytes += txBytes;
+  loopStats.txCommands += txCommands;
+  loopStats.freeHeap = freeHeap;
+  loopStats.millis += elapsed;
+}
+
+// Set Nextion RTC to current local time, schedule next set for upcoming DST transition
+void setNextionRTC() {
+  time_t now = time(nullptr);
+  LocalTm lt;
+  localTz.toLocal(now, &lt);
+  tm localTime = {};
+  localTime.tm_year = lt.year - 1900;
+  localTime.tm_mon = lt.month - 1;
+  localTime.tm_mday = lt.mday;
+  localTime.tm_hour = lt.hour;
+  localTime.tm_min = lt.minute;
+  localTime.tm_sec = lt.second;
+  if (myNex.setRTC(localTime)) {
+    rtcSyncCount = currentTime.syncCount();
+    nextRTCSet = localTz.transitionAfter(now);
+    rtcRetryMillis = 0;
+    LOG_INFO("RTC set");
   } else {
-    myNex.writeStr("page0.statusTxt.txt", "Wifi Disconnected");
-    myNex.writeStr("Setup.WiFiStatus.txt", "Wifi Disconnected");
+    rtcRetryMillis = rtcRetryMillis ? rtcRetryMillis * 2 : 10000;
+    if (rtcRetryMillis > RTC_DRIFT_CHECK_MINUTES * 60000UL) rtcRetryMillis = RTC_DRIFT_CHECK_MINUTES * 60000UL;
+    rtcFailedMillis = millis();
+    LOG_WARN("RTC set failed, next try in %u s", rtcRetryMillis / 1000);
   }
 }
 
-// Map openweathermap icon strings to Nextion picture ID's
-// See: https://openweathermap.org/weather-conditions
-// Large Icons (Daily display)
-int weatherIconToNextionPictureLarge(String iconTxt) {
-  std::map<String, int> iconMap = {
-      {"01d", 14},  // Clear day
-      {"01n", 11},  // Clear Night
-      {"02d", 13},  // Partly Cloudy Day
-      {"02n", 15},  // Party Cloudy Night
-      {"03d", 5},   // Cloudy Day
-      {"03n", 5},   // Cloudy Night
-      {"04d", 10},   // Cloudy Daylight
-      {"04n", 10},   // Cloudy Night
-      {"09d", 4},   // Showers Day
-      {"09n", 4},   // Showers Night
-      {"10d", 4},   // Rain Day
-      {"10n", 4},   // Rain Night
-      {"11d", 12},  // Thunderstorm Day
-      {"11n", 12},  // Thunderstorm Night
-      {"13d", 7},   // Snow Day
-      {"13n", 7},   // Snow Night
-      {"50d", 0},   // Mist Day
-      {"50n", 0},   // Mist Night
-  };
-
-  return iconMap[iconTxt];
+// Compare Nextion RTC with local time, reset RTC if drift exceeds RTC_DRIFT_THRESHOLD seconds
+void checkNextionRTCDrift() {
+  tm nexTime;
+  if (!myNex.getRTC(nexTime)) {
+    LOG_WARN("RTC read failed");
+    return;
+  }
+  LocalTm lt;
+  localTz.toLocal(time(nullptr), &lt);
+  int64_t nexSeconds = (int64_t)TzConverter::daysFromCivil(nexTime.tm_year + 1900, nexTime.tm_mon + 1, nexTime.tm_mday) * 86400 +
+                       nexTime.tm_hour * 3600 + nexTime.tm_min * 60 + nexTime.tm_sec;
+  int64_t localSeconds = (int64_t)TzConverter::daysFromCivil(lt.year, lt.month, lt.mday) * 86400 + lt.hour * 3600 +
+                         lt.minute * 60 + lt.second;
+  int32_t drift = (int32_t)(nexSeconds - localSeconds);
+  LOG_INFO("RTC drift: %d s", drift);
+  if (abs(drift) > RTC_DRIFT_THRESHOLD) {
+    setNextionRTC();
+  }
 }
 
-//Small Icons (hourly display)
-int weatherIconToNextionPictureSmall(String iconTxt) {
-  std::map<String, int> iconMap = {
-      {"01d", 1},    // Clear day
-      {"01n", 2},    // Clear Night
-      {"02d", 8},    // Partly Cloudy Day
-      {"02n", 9},    // Party Cloudy Night
-      {"03d", 20},   // Cloudy Day
-      {"03n", 20},   // Cloudy Night
-      {"04d", 21},   // Cloudy Daylight
-      {"04n", 21},   // Cloudy Night
-      {"09d", 22},   // Showers Day
-      {"09n", 22},   // Showers Night
-      {"10d", 22},   // Rain Day
-      {"10n", 22},   // Rain Night
-      {"11d", 23},   // Thunderstorm Day
-      {"11n", 23},   // Thunderstorm Night
-      {"13d", 24},   // Snow Day
-      {"13n", 24},   // Snow Night
-      {"50d", 25},   // Mist Day
-      {"50n", 25},   // Mist Night
-  };
-
-  return iconMap[iconTxt];
+// Fetch time for the current round of locations
+struct WeatherRound {
+  uint8_t fetched = 0;
+  uint32_t totalMillis = 0;
+} weatherRound;
+
+// Hand the first pending location to the weather task
+void requestWeather() {
+  uint8_t location = 0;
+  while (!(weatherPending & (1 << location))) location++;
+  weatherPending &= ~(1 << location);
+  if (!WiFi.isConnected()) {
+    weatherFetched(location, -1);
+    return;
+  }
+  if (!powerPlan.claimRadio(radioFetch)) {
+    weatherPending |= 1 << location;  // Ruuvi scan in progress, retried when it ends
+    return;
+  }
+  LOG_INFO("Calling updateWeather() for %s", weatherLocations[location].cityName());
+  fetchingLocation = location;
+  xQueueSend(weatherRequests, &location, portMAX_DELAY);
 }
 
-void readRuuvi() {
-  tm timei;
-  time_t now = time(&now);
-  currentTime.now(&timei);
-  Serial.println(asctime(&timei));
+// Weather task: get weather from OpenWeatherMap, one location per request
+void fetchWeather(void* parameter) {
+  uint8_t location;
+  for (;;) {
+    if (xQueueReceive(weatherRequests, &location, portMAX_DELAY) != pdTRUE) continue;
+    unsigned long fetchStart = millis();
+    WeatherResult result = {location, weatherLocations[location].updateWeather(weatherLocations[location].dueParts())};
+    powerPlan.releaseRadio(radioFetch);
+    weatherRound.totalMillis += millis() - fetchStart;
+    weatherRound.fetched++;
+    xQueueSend(weatherResults, &result, portMAX_DELAY);
+    powerPlan.wake();
+  }
+}
 
-  // Start blocking BLE scan
-  // Scan results handled by callback
-  ruuviScan.startRuuviScan(RUUVI_SCAN_TIME);
+// Display a fetch result. status is the HTTP status, -1 if WiFi was down.
+// The status is kept with the location: the status line shows it while that location is on the display.
+// Display updates are driven by weatherBindings, see nextionBindings.h
+void weatherFetched(uint8_t location, int status) {
+  weatherLocations[location].setFetchStatus(status);
+  if (status == 200) {
+    // currentWeather.dumpCurrentWeather(&Serial);
+    if (location == shownLocation && weatherLocations[location].takeAlertsChanged()) renderAlertBanner();
+    if (location == 0) fleet.publish(currentWeather);
+  } else {
+    LOG_WARN("Weather for %s failed (%d)", weatherLocations[location].cityName(), status);
+    if (location == 0) fleet.fetchFailed();
+    if (status == -1 && !myNex.sleeping()) myNex.writeStr("Setup.WiFiStatus.txt", "Wifi Disconnected");
+  }
+  if (location == shownLocation) renderWeather();
+  if (location == locationCount - 1) {
+    LOG_INFO("Weather round: %u of %u locations, %u ms fetching, min free heap %u", weatherRound.fetched, locationCount,
+             weatherRound.totalMillis, weatherFetcher.takeMinFreeHeap());
+    weatherFetcher.reportTiers();
+    weatherRound = WeatherRound();
+  }
+}
 
-  // Update Nextion screen
-  // Dim screen objects if more than 10 minutes between Ruuvi reads
-  if ((now - indoorTag.lastUpdate()) < 600) {
-    myNex.writeNum((String) "page0.indoorTemp.val", indoorTag.getTemperatureInF());
-    myNex.writeCmd("page0.indoorTemp.pco=65535");
-    vTaskDelay(100 / portTICK_PERIOD_MS);
+// Write weather model to display, only components whose value changed.
+// Nothing is written while the display sleeps, the model keeps up and the changes go out on wake.
+void renderWeather() {
+  if (myNex.sleeping()) return;
+  unsigned long renderStart = micros();
+  uint32_t txBytes = myNex.txBytes();
+  uint32_t txCommands = myNex.txCommands();
+  uint16_t written = renderChanged(myNex, weatherLocations[shownLocation], weatherBindings, 0, weatherShadow);
+  LOG_DEBUG("Weather: %u of %u components written", written, sizeof(weatherBindings) / sizeof(weatherBindings[0]));
+  renderHourly();
+  myNex.flushWrites();  // Include time on the wire
+
+  // Link throughput for the repaint
+  uint32_t renderMicros = micros() - renderStart;
+  txBytes = myNex.txBytes() - txBytes;
+  txCommands = myNex.txCommands() - txCommands;
+  uint32_t bytesPerSecond = renderMicros ? (uint32_t)((uint64_t)txBytes * 1000000 / renderMicros) : 0;
+  uint32_t cmdsPerSecond = renderMicros ? (uint32_t)((uint64_t)txCommands * 1000000 / renderMicros) : 0;
+  LOG_INFO("Render: %u cmds, %u bytes in %u ms at %lu baud (%u bytes/s, %u cmds/s)", txCommands, txBytes,
+           renderMicros / 1000, myNex.baud(), bytesPerSecond, cmdsPerSecond);
+}
 
+// New or changed alerts: banner goes out ahead of any display traffic already waiting
+void renderAlertBanner() {
+#ifdef OW_ALERTS
+  if (myNex.sleeping()) return;  // Goes out with the wake burst
+  owmWeather& weather = weatherLocations[shownLocation];
+  char buffer[48];
+  const char* banner = nexEncode::alertBanner(weather, 0, buffer, sizeof(buffer));
+  if (!myNex.writeStrPriority("page0.alert.txt", banner)) myNex.writeStr("page0.alert.txt", banner);
+  // Numbers only: the event name is in the model, which the next fetch rewrites before the record is drained
+  const AlertStore& alerts = weather.alerts();
+  const WeatherAlert* alert = alerts.current(time(nullptr));
+  if (alert) {
+    LOG_INFO("Alert banner: alert %u of %u until %u, %u dropped", (unsigned)(alert - alerts.alerts) + 1, alerts.count,
+             alert->end, alerts.dropped);
   } else {
-    myNex.writeCmd("page0.indoorTemp.pco=19049");
+    LOG_INFO("Alert banner: cleared, %u alerts, %u dropped", alerts.count, alerts.dropped);
   }
-  if ((now - outdoorTag.lastUpdate()) < 600) {
-    myNex.writeNum((String) "page0.outdoorTemp.val", outdoorTag.getTemperatureInF());
-    myNex.writeCmd("page0.outdoorTemp.pco=65535");
-    vTaskDelay(100 / portTICK_PERIOD_MS);
+#endif
+}
 
-  } else {
-    myNex.writeCmd("page0.outdoorTemp.pco=19049");
+// Write the visible 12 hours of the Hourly page, skipping components that already show the right value
+void renderHourly() {
+  if (myNex.sleeping()) return;
+  owmWeather& weather = weatherLocations[shownLocation];
+  int lastOffset = weather.hourlyCount() > HOURLY_WINDOW ? weather.hourlyCount() - HOURLY_WINDOW : 0;
+  if (hourlyOffset > lastOffset) hourlyOffset = lastOffset;
+  uint16_t written = renderChanged(myNex, weather, hourlyBindings, hourlyOffset, hourlyShadow);
+  LOG_DEBUG("Hourly: hours %u-%u, %u of %u components written", hourlyOffset, hourlyOffset + HOURLY_WINDOW - 1, written,
+            sizeof(hourlyBindings) / sizeof(hourlyBindings[0]));
+}
+
+void readRuuvi() {
+  // Derived metrics, once per display tick rather than per advert.
+  // Wind from the last complete fetch, the model is the weather task's while it fetches.
+  static int windSpeed = 0;
+  if (fetchingLocation != 0) windSpeed = currentWeather.currentWindSpeed();
+  const RuuviDerived& indoorDerived = indoorMetrics.get(0);
+  const RuuviDerived& outdoorDerived = outdoorMetrics.get(windSpeed);
+  LOG_INFO("Indoor: dew point %.1f F, %.1f g/m3 | Outdoor: dew point %.1f F, %.1f g/m3, heat index %.1f F, "
+           "wind chill %.1f F",
+           indoorDerived.dewPointDeciF * 0.1f, indoorDerived.absoluteHumidity * 0.1f,
+           outdoorDerived.dewPointDeciF * 0.1f, outdoorDerived.absoluteHumidity * 0.1f,
+           outdoorDerived.heatIndexDeciF * 0.1f, outdoorDerived.windChillDeciF * 0.1f);
+
+  renderRuuvi();
+}
+
+// Write a number if it differs from the shadow row, returns 1 if written
+uint16_t writeNumChanged(const char* component, int32_t value, uint8_t row) {
+  if (!ruuviShadow.changed(row, (uint32_t)value)) return 0;
+  ruuviShadow.wrote(row, (uint32_t)value, myNex.writeNum(component, value));
+  return 1;
+}
+
+uint16_t writeStrChanged(const char* component, const char* text, uint8_t row) {
+  uint32_t hash = textHash(text);
+  if (!ruuviShadow.changed(row, hash)) return 0;
+  ruuviShadow.wrote(row, hash, myNex.writeStr(component, text));
+  return 1;
+}
+
+// Ruuvi temperatures and status on Nextion, only components whose value changed
+void renderRuuvi() {
+  if (myNex.sleeping()) return;
+  time_t now = time(nullptr);
+  RuuviReading indoor = indoorTag.reading();
+  RuuviReading outdoor = outdoorTag.reading();
+  char str[32];
+  char status[48];
+  uint16_t written = 0;
+
+  if (!ruuviShadow.valid) {
+    // XFloat: value in tenths of a degree, one decimal place
+    myNex.writeCmd("page0.indoorTemp.vvs1=1");
+    myNex.writeCmd("page0.outdoorTemp.vvs1=1");
   }
+  // Dim screen objects if more than 10 minutes between Ruuvi reads
+  bool indoorFresh = (now - indoor.lastUpdate) < 600;
+  if (indoorFresh) written += writeNumChanged("page0.indoorTemp.val", indoor.temperatureInDeciF(), 0);
+  written += writeNumChanged("page0.indoorTemp.pco", indoorFresh ? 65535 : 19049, 1);
+  bool outdoorFresh = (now - outdoor.lastUpdate) < 600;
+  if (outdoorFresh) written += writeNumChanged("page0.outdoorTemp.val", outdoor.temperatureInDeciF(), 2);
+  written += writeNumChanged("page0.outdoorTemp.pco", outdoorFresh ? 65535 : 19049, 3);
 
   // Update status text on Nextion
-  char str[10];
-  time_t ot = outdoorTag.lastUpdate();
-  strftime(str, sizeof(str), "%a %H:%M", localtime(&ot));
-  myNex.writeStr("Setup.OutdoorStatus.txt", (String)str + " T: " + outdoorTag.getTemperatureInF());
-  time_t it = indoorTag.lastUpdate();
-  strftime(str, sizeof(str), "%a %H:%M", localtime(&it));
-  myNex.writeStr("Setup.IndoorStatus.txt", (String)str + " T: " + indoorTag.getTemperatureInF());
+  localTz.format(str, sizeof(str), outdoor.lastUpdate, "%a %H:%M");
+  snprintf(status, sizeof(status), "%s T: %d", str, outdoor.temperatureInF());
+  written += writeStrChanged("Setup.OutdoorStatus.txt", status, 4);
+  localTz.format(str, sizeof(str), indoor.lastUpdate, "%a %H:%M");
+  snprintf(status, sizeof(status), "%s T: %d", str, indoor.temperatureInF());
+  written += writeStrChanged("Setup.IndoorStatus.txt", status, 5);
+  ruuviShadow.valid = true;
+  if (written) LOG_DEBUG("Ruuvi: %u components written", written);
+}
+
+// Display awake again: what changed while it slept, in one burst
+void renderWake() {
+  LOG_INFO("Display awake");
+  renderRuuvi();
+  if (shownLocation != fetchingLocation) renderWeather();  // Else rendered when the fetch completes
+  myNex.flushWrites();
+}
+
+// Ruuvi scan task: one blocking BLE scan per heartbeat. Scan results handled by callback.
+void scanRuuvi(void* parameter) {
+  TickType_t lastWake = xTaskGetTickCount();
+  uint8_t sleepingTicks = 0;
+  for (;;) {
+    // While the display sleeps, scan every DISPLAY_SLEEP_SLOWDOWN heartbeats
+    sleepingTicks = myNex.sleeping() ? sleepingTicks + 1 : 0;
+    // Scan and weather fetch take turns on the radio with POWER_SAVE, a fetch takes a few seconds
+    if (sleepingTicks % DISPLAY_SLEEP_SLOWDOWN == 0 && powerPlan.claimRadio(radioScan, 20000)) {
+      {
+        StallGuard guard(stallBleScan);
+        ruuviScan.startRuuviScan(RUUVI_SCAN_TIME);
+      }
+      powerPlan.releaseRadio(radioScan);
+    }
+
+#ifdef RUUVI_CAPTURE
+    // After first scan, dump capture and replay it at increasing advert rates
+    static bool captureReplayed = false;
+    if (!captureReplayed) {
+      static const uint32_t rates[] = {100, 500, 1000, 2000, 5000};
+      ruuviCapture.stop();
+      ruuviCapture.dump(&Serial);
+      ruuviCapture.benchmark(replayRuuviAdvertisement, rates, sizeof(rates) / sizeof(rates[0]), 5000, &Serial);
+      captureReplayed = true;
+    }
+#endif
+    vTaskDelayUntil(&lastWake, HEARTBEAT_INTERVAL_MILLIS / portTICK_PERIOD_MS);
+  }
 }
 
 void heartbeat() {
   uptime();
+  bool awake = !myNex.sleeping();  // Nothing is written to a sleeping display
   // Send heartbeat counter to Nextion
-  myNex.writeNum("heartbeat", 1);
+  if (awake) myNex.writeNum("heartbeat", 1);
 
   // Send stack/heap infor to Nextion & Serial port
-  String status = (String)uptimeBuffer + 
-                  " N: " + (String)uxTaskGetStackHighWaterMark(xhandleNextionHandle) +
-                  // " W: " + (String)uxTaskGetStackHighWaterMark(currentWeather.xhandlegetWeatherHandle) +
-                  " H: " + (String)esp_get_minimum_free_heap_size();
-  Serial.println(status);
-  myNex.writeStr("Setup.Heartbeat.txt", status);
+  UBaseType_t nextionStack = uxTaskGetStackHighWaterMark(xhandleNextionHandle);
+  uint32_t minFreeHeap = esp_get_minimum_free_heap_size();
+  // Uptime as numbers, uptimeBuffer may be rewritten before the record is drained
+  uint32_t minutesUp = millis() / 60000;
+  LOG_INFO("Heartbeat: %2ud%2uh%2um N: %u H: %u", minutesUp / 1440, minutesUp / 60 % 24, minutesUp % 60, nextionStack,
+           minFreeHeap);
+  char text[40];
+  if (awake) {
+    snprintf(text, sizeof(text), "%s N: %u H: %u", uptimeBuffer, nextionStack, minFreeHeap);
+    myNex.writeStr("Setup.Heartbeat.txt", text);
+  }
+  reportLoopStats();
+  fleet.report();
+
+  // Core use every heartbeat, per task and stall histograms every 10th
+  static uint8_t taskReports = 0;
+  bool fullReport = ++taskReports % 10 == 0;
+  taskStats.report(fullReport);
+  if (fullReport) {
+    stallWatch.report();
+    powerPlan.report();
+  }
+
+#ifdef HEAP_TRACKER
+  // Sample heap every heartbeat, print full report every 10th
+  static uint8_t heapSamples = 0;
+  heapTracker.sample();
+  if (++heapSamples % 10 == 0) heapTracker.report();
+#endif
 
   // Check WiFi
-  myNex.writeStr("Setup.WiFiStatus.txt", (String) "IP: " + WiFi.localIP().toString());
-  uint8_t wifiStatus = WiFi.waitForConnectResult();
+  if (awake) {
+    IPAddress ip = WiFi.localIP();
+    snprintf(text, sizeof(text), "IP: %u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    myNex.writeStr("Setup.WiFiStatus.txt", text);
+  }
+  {
+    StallGuard guard(stallWiFiConnect);
+    WiFi.waitForConnectResult();
+  }
   if (WiFi.status() != WL_CONNECTED) {
     WiFi.disconnect();
-    myNex.writeStr("Setup.WiFiStatus.txt", "WiFi Disconnected");
+    if (awake) myNex.writeStr("Setup.WiFiStatus.txt", "WiFi Disconnected");
     delay(5000);
     WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
   }
@@ -304,6 +653,7 @@ void handleNextion(void* parameter) {
 
     int _len = myNex.listen(_bytes, 255);
     if (_len) {
+      powerPlan.wake();
       if (_len > 3) {
         _hexString.reserve(_len * 3);
         for (const auto& item : _bytes) {
@@ -312,6 +662,12 @@ void handleNextion(void* parameter) {
         }
         // Serial.println((String) "handleNextion returned: " + _hexString.c_str());
 
+        // Touch event: 65 page component event. Hourly page scroll buttons.
+        if (_bytes[0] == '\x65' && (uint8_t)_bytes[1] == NEXTION_HOURLY_PAGE_ID) {
+          if ((uint8_t)_bytes[2] == NEXTION_HOURLY_BACK_ID) hourlyScroll = -1;
+          if ((uint8_t)_bytes[2] == NEXTION_HOURLY_FORWARD_ID) hourlyScroll = 1;
+        }
+
         // If we see interesting event from Nextion.
         for (size_t i = 0; i < sizeof filter; i++) {
           if (_bytes[0] == filter[i]) {
@@ -319,13 +675,13 @@ void handleNextion(void* parameter) {
             // (do nothing)
           }
         }
-      } else {
-        myNex.flushReads();
+      } else if (!myNex.acksEnabled()) {
+        myNex.flushReads();  // Would discard return codes of writes in flight
       }
     }
-    vTaskDelay(100 / portTICK_PERIOD_MS);
+    vTaskDelay(powerPlan.nextionPoll(myNex.sleeping()));
   }
-  Serial.println("Task ended");
+  LOG_ERROR("Task ended");
   vTaskDelete(NULL);  // Should never reach this.
 }  // handleNextion()
 
@@ -1,5 +1,21 @@
 #include "nextionInterface.h"
 
+#include <Preferences.h>
+
+#include "stallWatch.h"
+
+// Candidate link speeds, fastest first
+static const unsigned long baudRates[] = {921600, 512000, 256000, 230400, 115200, 57600, 38400, 19200, 9600};
+
+// Resync markers read back 'NX' and a count, a value the display's own variables are never asked for
+static const uint32_t markerTag = 0x4E580000;
+
+/// @brief Take a serial port semaphore, the wait is timed by the stall watchdog
+static BaseType_t takeSemaphore(SemaphoreHandle_t _semaphore, TickType_t _wait) {
+  StallGuard _guard(stallNextionLock);
+  return xSemaphoreTake(_semaphore, _wait);
+}
+
 /// @brief Class to handle communication with Nextion device.
 /// @param serial Serial port to which Nextion is attached
 /// @param baud Baud rate to be used for communication with Nextion
@@ -15,9 +31,16 @@ myNextionInterface::myNextionInterface(HardwareSerial& serial, unsigned long bau
 }
 
 /// @brief Initialize Nextion Interface
-///        Flush serial interface, reset Nextion display
-/// @return true
+///        Flush serial interface, reset Nextion display, then negotiate fastest
+///        working link speed up to NEXTION_MAX_BAUD
+/// @return true if display responds
 bool myNextionInterface::begin() {
+  // Start at last negotiated rate, display keeps it across resets ('bauds=')
+  Preferences prefs;
+  prefs.begin("nextion", true);
+  _baud = prefs.getULong("baud", _baud);
+  prefs.end();
+
   vTaskDelay(100 / portTICK_PERIOD_MS);
   _serial->begin(_baud, SERIAL_8N1, RXDN, TXDN);
 
@@ -27,108 +50,788 @@ bool myNextionInterface::begin() {
   // Reset Nextion Display
   vTaskDelay(100 / portTICK_PERIOD_MS);
   writeCmd("rest");
+  vTaskDelay(500 / portTICK_PERIOD_MS);  // Wait for display to restart
+  flushReads();
+
+  if (!findBaud()) {
+    Serial.println("Nextion not responding");
+    return false;
+  }
+  negotiateBaud(NEXTION_MAX_BAUD);
   return true;
 }
 
+/// @brief Check link with a 'get' round trip
+/// @return true if display sent a well formed numeric reply
+bool myNextionInterface::ping() {
+  int32_t _page;
+  return getNum("dp", _page);
+}
+
+/// @brief Switch local UART to a new rate and clear anything received at the old one
+void myNextionInterface::setLocalBaud(unsigned long baud) {
+  _serial->flush();  // Wait for pending transmit at old rate
+  _serial->updateBaudRate(baud);
+  _baud = baud;
+  vTaskDelay(50 / portTICK_PERIOD_MS);
+  flushReads();
+}
+
+/// @brief Find rate display is using, trying current rate first
+/// @return true if display found
+bool myNextionInterface::findBaud() {
+  if (ping()) return true;
+  for (auto rate : baudRates) {
+    setLocalBaud(rate);
+    if (ping()) {
+      Serial.printf("Nextion found at %lu baud\n", rate);
+      return true;
+    }
+  }
+  return false;
+}
+
+/// @brief Step link speed up to maxBaud. Each step is verified with two 'get' round trips,
+///        on failure both ends return to the previous rate and the next lower rate is tried.
+///        The working rate is persisted on the display ('bauds=') and in NVS, once a ping
+///        at that rate has succeeded. If none does, both ends return to the starting rate.
+/// @param maxBaud Highest rate to try, call with the display answering at the current rate
+/// @return Negotiated rate
+unsigned long myNextionInterface::negotiateBaud(unsigned long maxBaud) {
+  char _command[32];
+  unsigned long _startBaud = _baud;
+
+  for (auto rate : baudRates) {
+    if (rate > maxBaud) continue;
+    if (rate <= _baud) break;
+
+    unsigned long _oldBaud = _baud;
+    snprintf(_command, sizeof(_command), "baud=%lu", rate);
+    writeCmd(_command);
+    setLocalBaud(rate);
+    if (ping() && ping()) {
+      Serial.printf("Nextion link at %lu baud\n", rate);
+      break;
+    }
+
+    // Fall back. Display may or may not have switched, tell it to return to old rate.
+    Serial.printf("Nextion failed at %lu baud\n", rate);
+    snprintf(_command, sizeof(_command), "baud=%lu", _oldBaud);
+    writeCmd(_command);
+    setLocalBaud(_oldBaud);
+    if (!ping() && !findBaud()) break;
+  }
+
+  if (!ping()) {
+    // Nothing verified, don't persist a rate the display may not be using
+    Serial.printf("Nextion lost at %lu baud, returning to %lu\n", _baud, _startBaud);
+    snprintf(_command, sizeof(_command), "baud=%lu", _startBaud);
+    writeCmd(_command);
+    setLocalBaud(_startBaud);
+    return _baud;
+  }
+
+  // Persist so display and ESP32 agree after a reboot or display reset.
+  // Only written when changed, 'bauds=' writes display EEPROM.
+  Preferences prefs;
+  prefs.begin("nextion", false);
+  if (prefs.getULong("baud", NEXTION_BAUD) != _baud) {
+    snprintf(_command, sizeof(_command), "bauds=%lu", _baud);
+    writeCmd(_command);
+    vTaskDelay(50 / portTICK_PERIOD_MS);
+    flushReads();
+    prefs.putULong("baud", _baud);
+  }
+  prefs.end();
+  return _baud;
+}
+
+/// @brief Block until all queued bytes have been transmitted
+///        In acknowledged mode, also wait for the display to acknowledge them
+void myNextionInterface::flushWrites() {
+  if (_xSerialWriteSemaphore != NULL) {
+    if (takeSemaphore(_xSerialWriteSemaphore, 1000 / portTICK_PERIOD_MS) == pdTRUE) {
+      _serial->flush();
+      xSemaphoreGive(_xSerialWriteSemaphore);
+    }
+  }
+  if (_acks) waitForAcks(NEXTION_ACK_TIMEOUT_MS * (NEXTION_ACK_RETRIES + 1));
+}
+
 /// @brief Read and throw away serial input until no bytes or timeout
 void myNextionInterface::flushReads() {
   if (_xSerialReadSemaphore != NULL) {
-    if (xSemaphoreTake(_xSerialReadSemaphore, 400 / portTICK_PERIOD_MS)) {
+    if (takeSemaphore(_xSerialReadSemaphore, 400 / portTICK_PERIOD_MS)) {
       unsigned long _timer = millis();
       while ((_serial->available() > 0) && (millis() - _timer) < 400L) {
         _serial->read();  // Start with clear serial port.
       }
+      _rxLen = 0;
+      _rxTerminators = 0;
       xSemaphoreGive(_xSerialReadSemaphore);
     }
   }
 }
 
-/// @brief Write Nextion formatted 'Number' to Nextion display objects 'val' property
-/// @param _componentName Name of Nextion object/component
-/// @param _val Number to write
+/// @brief Write a command to the display, given as parts to concatenate, plus terminator.
+///        Written piecewise to the serial port, no heap allocation.
+///        A due resync marker and queued priority commands are written first.
+///        When tracked, a copy is kept in the ack window for retransmission. If the
+///        window is full, acks are polled (and failed commands resent) until a slot frees.
+///        A write that can't go out is counted in lostWrites().
+/// @param _parts Command text pieces
+/// @param _count Number of pieces
+/// @param _tracked Expect a bkcmd=3 return code for this command
 /// @return Success or not
-bool myNextionInterface::writeNum(const String& _componentName, uint32_t _val) {
-  String _command = _componentName + "=" + _val;
-  if (_xSerialWriteSemaphore != NULL) {
-    if (xSemaphoreTake(_xSerialWriteSemaphore, 100 / portTICK_PERIOD_MS) == pdTRUE) {
-      _serial->print(_command + _cmdTerminator);
+bool myNextionInterface::send(const char* const _parts[], uint8_t _count, bool _tracked) {
+  if (_xSerialWriteSemaphore == NULL) return false;
+  unsigned long _timer = millis();
+  bool _stalled = false;
+
+  for (;;) {
+    if (takeSemaphore(_xSerialWriteSemaphore, 100 / portTICK_PERIOD_MS) != pdTRUE) {
+      portENTER_CRITICAL(&_windowMux);
+      _lostWrites++;
+      portEXIT_CRITICAL(&_windowMux);
+      return false;
+    }
+    sendMarker();
+    sendPriority();
+
+    InFlight* _slot = _tracked ? freeSlot(NEXTION_ACK_WINDOW) : nullptr;
+    if (!_tracked || _slot) {
+      transmit(_parts, _count, _slot);
       xSemaphoreGive(_xSerialWriteSemaphore);
       return true;
     }
+    xSemaphoreGive(_xSerialWriteSemaphore);
+
+    // Window full
+    if (!_stalled) {
+      _stalled = true;
+      portENTER_CRITICAL(&_windowMux);
+      _ackStats.windowStalls++;
+      portEXIT_CRITICAL(&_windowMux);
+    }
+    if ((millis() - _timer) > NEXTION_ACK_TIMEOUT_MS * (NEXTION_ACK_RETRIES + 1)) {
+      portENTER_CRITICAL(&_windowMux);
+      _ackStats.refused++;
+      _lostWrites++;
+      portEXIT_CRITICAL(&_windowMux);
+      return false;
+    }
+    int _frames = pollAcks(10 / portTICK_PERIOD_MS);
+    resendPending();
+    if (!_frames) vTaskDelay(1);  // Nothing back yet
   }
-  return false;
+}  // send()
+
+/// @brief Find a free window slot, if fewer than _limit commands are in flight
+/// @param _limit NEXTION_ACK_WINDOW for normal writes, plus NEXTION_PRIORITY_SLOTS for priority writes
+myNextionInterface::InFlight* myNextionInterface::freeSlot(uint8_t _limit) {
+  InFlight* _slot = nullptr;
+  uint8_t _busy = 0;
+  for (auto& _entry : _window) {
+    if (_entry.state != slotFree)
+      _busy++;
+    else if (!_slot)
+      _slot = &_entry;
+  }
+  return _busy < _limit ? _slot : nullptr;
+}
+
+/// @brief Write command parts and terminator. Write semaphore must be held.
+/// @param _slot Window slot to track the command in, nullptr if untracked
+void myNextionInterface::transmit(const char* const _parts[], uint8_t _count, InFlight* _slot) {
+  size_t _len = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    size_t _partLen = strlen(_parts[i]);
+    _txBytes += _serial->write((const uint8_t*)_parts[i], _partLen);
+    if (_slot && _len + _partLen <= NEXTION_CMD_MAX) memcpy(_slot->command + _len, _parts[i], _partLen);
+    _len += _partLen;
+  }
+  _txBytes += _serial->write((const uint8_t*)_cmdTerminator, sizeof(_cmdTerminator));
+  _txCommands++;
+  if (!_slot) return;
+
+  uint8_t _kept = _len <= NEXTION_CMD_MAX ? _len : 0;
+  const char* _equals = _kept ? (const char*)memchr(_slot->command, '=', _kept) : nullptr;
+  portENTER_CRITICAL(&_windowMux);
+  // Older writes to the same component must not be resent over this one
+  if (_equals) {
+    size_t _target = _equals - _slot->command + 1;
+    for (auto& _entry : _window) {
+      if (_entry.state != slotFree && _entry.length >= _target &&
+          memcmp(_entry.command, _slot->command, _target) == 0) {
+        _entry.superseded = true;
+      }
+    }
+  }
+  _slot->length = _kept;
+  _slot->retries = 0;
+  _slot->superseded = false;
+  _slot->sequence = _sequence++;
+  _slot->sentMicros = micros();
+  _slot->state = slotAwaiting;
+  portEXIT_CRITICAL(&_windowMux);
+}
+
+/// @brief Queue a command to go out ahead of normal writes, then write it unless
+///        another task holds the serial port, in which case that task writes it
+///        before its next command.
+/// @return false if the command is too long or the queue is full
+bool myNextionInterface::queuePriority(const char* const _parts[], uint8_t _count) {
+  char _command[NEXTION_CMD_MAX + 1];
+  size_t _len = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    size_t _partLen = strlen(_parts[i]);
+    if (_len + _partLen > NEXTION_CMD_MAX) return false;
+    memcpy(_command + _len, _parts[i], _partLen);
+    _len += _partLen;
+  }
+  _command[_len] = 0;
+
+  portENTER_CRITICAL(&_windowMux);
+  bool _queued = _priorityCount < NEXTION_PRIORITY_QUEUE;
+  if (_queued) memcpy(_priority[_priorityCount++], _command, _len + 1);
+  portEXIT_CRITICAL(&_windowMux);
+  if (!_queued) return false;
+
+  if (_xSerialWriteSemaphore != NULL && xSemaphoreTake(_xSerialWriteSemaphore, 0) == pdTRUE) {
+    sendPriority();
+    xSemaphoreGive(_xSerialWriteSemaphore);
+  }
+  return true;
+}
+
+/// @brief Write queued priority commands, oldest first. Write semaphore must be held.
+///        In acknowledged mode they may use the slots kept for them when the window is full;
+///        if none is free the rest stay queued until an ack frees one, see resendPending().
+void myNextionInterface::sendPriority() {
+  for (;;) {
+    char _command[NEXTION_CMD_MAX + 1];
+    InFlight* _slot = _acks ? freeSlot(NEXTION_ACK_WINDOW + NEXTION_PRIORITY_SLOTS) : nullptr;
+    if (_acks && !_slot) return;
+
+    portENTER_CRITICAL(&_windowMux);
+    bool _pending = _priorityCount > 0;
+    if (_pending) {
+      memcpy(_command, _priority[0], sizeof(_command));
+      _priorityCount--;
+      memmove(_priority[0], _priority[1], _priorityCount * sizeof(_priority[0]));
+      _ackStats.priority++;
+    }
+    portEXIT_CRITICAL(&_windowMux);
+    if (!_pending) return;
+
+    const char* _parts[] = {_command};
+    transmit(_parts, 1, _slot);
+  }
+}
+
+/// @brief Write Nextion formatted 'Number' to Nextion display objects 'val' property
+/// @param _componentName Name of Nextion object/component
+/// @param _val Number to write
+/// @return Success or not
+bool myNextionInterface::writeNum(const char* _componentName, int32_t _val) {
+  char _number[12];
+  snprintf(_number, sizeof(_number), "=%d", (int)_val);
+  const char* _parts[] = {_componentName, _number};
+  return send(_parts, 2, _acks);
 }  // writeNum()
 
-/// @brief Write Arduino String object to Nextion display objects 'txt' property
+/// @brief Write text to Nextion display objects 'txt' property
 /// @param command Name of Nextion object/component
 /// @param txt String to write
 /// @return Success or not
-bool myNextionInterface::writeStr(const String& _componentName, const String& txt) {
-  String _command = _componentName + "=\"" + txt + "\"";
-  if (_xSerialWriteSemaphore != NULL) {
-    if (xSemaphoreTake(_xSerialWriteSemaphore, 100 / portTICK_PERIOD_MS) == pdTRUE) {
-      _serial->print(_command + _cmdTerminator);
-      xSemaphoreGive(_xSerialWriteSemaphore);
-      return true;
-    }
-  }
-  return false;
+bool myNextionInterface::writeStr(const char* _componentName, const char* txt) {
+  const char* _parts[] = {_componentName, "=\"", txt, "\""};
+  return send(_parts, 4, _acks);
 }  // writeStr()
 
 /// @brief Write a generic Nextion command to the display
 /// @param command Nextion command
 /// @return Success or not
-bool myNextionInterface::writeCmd(const String& command) {
-  if (_xSerialWriteSemaphore != NULL) {
-    if (xSemaphoreTake(_xSerialWriteSemaphore, 100 / portTICK_PERIOD_MS) == pdTRUE) {
-      _serial->print(command + _cmdTerminator);
-      xSemaphoreGive(_xSerialWriteSemaphore);
-      return true;
+bool myNextionInterface::writeCmd(const char* command) {
+  const char* _parts[] = {command};
+  return send(_parts, 1, _acks);
+}  // writeCmd()
+
+/// @brief Write text ahead of normal writes already waiting for the serial port, e.g. an alert banner
+/// @param _componentName Name of Nextion object/component
+/// @param txt String to write, command must fit NEXTION_CMD_MAX
+/// @return true if queued
+bool myNextionInterface::writeStrPriority(const char* _componentName, const char* txt) {
+  const char* _parts[] = {_componentName, "=\"", txt, "\""};
+  return queuePriority(_parts, 4);
+}
+
+/// @brief Write a command ahead of normal writes already waiting for the serial port
+/// @param command Nextion command, must fit NEXTION_CMD_MAX
+/// @return true if queued
+bool myNextionInterface::writeCmdPriority(const char* command) {
+  const char* _parts[] = {command};
+  return queuePriority(_parts, 1);
+}
+
+/// @brief Read a numeric value from Nextion ('get' command)
+///        Holds the read semaphore so listen() can't consume the reply.
+///        In acknowledged mode, outstanding writes are acknowledged first so their
+///        return codes can't be mistaken for the reply. Other frames are kept for listen().
+/// @param _varName Nextion variable or component attribute, e.g. "rtc5" or "page0.n0.val"
+/// @param _val Value returned by Nextion
+/// @return true if a numeric reply was received before timeout
+bool myNextionInterface::getNum(const String& _varName, int32_t& _val) {
+  bool _success = false;
+  if (_acks) waitForAcks(NEXTION_ACK_TIMEOUT_MS * (NEXTION_ACK_RETRIES + 1));
+  if (_xSerialReadSemaphore != NULL) {
+    if (takeSemaphore(_xSerialReadSemaphore, 100 / portTICK_PERIOD_MS) == pdTRUE) {
+      const char* _parts[] = {"get ", _varName.c_str()};
+      if (send(_parts, 2, false)) {
+        unsigned long _timer = millis();
+        while (!_success && (millis() - _timer) < 100L) {
+          int _len = readFrame(100L - (millis() - _timer));
+          if (_len == 0) break;
+          if (_acks && takeMarker(_len)) continue;
+          // Numeric reply: 0x71 + 4 byte little endian value + FF FF FF
+          if (_len == 8 && _rxFrame[0] == 0x71) {
+            _val = (int32_t)(_rxFrame[1] | (_rxFrame[2] << 8) | (_rxFrame[3] << 16) | ((uint32_t)_rxFrame[4] << 24));
+            _success = true;
+          } else if (_acks && isReturnCode(_len)) {
+            processAck(_rxFrame[0]);
+          } else if (!isReturnCode(_len)) {
+            stashFrame(_len);
+          }
+        }
+      }
+      xSemaphoreGive(_xSerialReadSemaphore);
     }
   }
-  return false;
-}  // writeCmd()
+  return _success;
+}  // getNum()
 
 /// @brief Set Nextion Real Time Clock (RTC)
+///        All six registers are written in a single burst, or as six
+///        acknowledged writes in acknowledged mode.
 /// @param time tm struct containing time to set
 /// @return true if RTC set successfully
 bool myNextionInterface::setRTC(tm time) {
-  if (writeNum((String) "rtc0", time.tm_year + 1900) && writeNum((String) "rtc1", time.tm_mon + 1) &&
-      writeNum((String) "rtc2", time.tm_mday) && writeNum((String) "rtc3", time.tm_hour) &&
-      writeNum((String) "rtc4", time.tm_min) && writeNum((String) "rtc5", time.tm_sec))
+  if (_acks) {
+    return writeNum("rtc0", time.tm_year + 1900) && writeNum("rtc1", time.tm_mon + 1) &&
+           writeNum("rtc2", time.tm_mday) && writeNum("rtc3", time.tm_hour) && writeNum("rtc4", time.tm_min) &&
+           writeNum("rtc5", time.tm_sec);
+  }
+
+  char _command[96];
+  int _len = snprintf(_command, sizeof(_command),
+                      "rtc0=%d\xFF\xFF\xFF" "rtc1=%d\xFF\xFF\xFF" "rtc2=%d\xFF\xFF\xFF"
+                      "rtc3=%d\xFF\xFF\xFF" "rtc4=%d\xFF\xFF\xFF" "rtc5=%d\xFF\xFF\xFF",
+                      time.tm_year + 1900, time.tm_mon + 1, time.tm_mday, time.tm_hour, time.tm_min, time.tm_sec);
+  if (_len <= 0 || _len >= (int)sizeof(_command)) return false;
+
+  if (_xSerialWriteSemaphore != NULL) {
+    if (takeSemaphore(_xSerialWriteSemaphore, 100 / portTICK_PERIOD_MS) == pdTRUE) {
+      _txBytes += _serial->write((const uint8_t*)_command, _len);
+      _txCommands += 6;
+      xSemaphoreGive(_xSerialWriteSemaphore);
+      return true;
+    }
+  }
+  return false;
+}
+
+/// @brief Read Nextion Real Time Clock (RTC)
+/// @param time tm struct to fill in. tm_wday, tm_yday and tm_isdst are not set.
+/// @return true if all six registers were read within one minute of the clock
+bool myNextionInterface::getRTC(tm& time) {
+  int32_t _rtc[6];
+  int32_t _seconds;
+  // Registers are read one at a time, so the clock can tick between any two of them.
+  // Seconds are read first and last: if they went down, a carry may have reached any
+  // register already read, so read them all again.
+  for (int _attempt = 0; _attempt < 3; _attempt++) {
+    if (!getNum((String) "rtc5", _seconds)) return false;
+    for (int i = 0; i < 6; i++) {
+      if (!getNum((String) "rtc" + i, _rtc[i])) return false;
+    }
+    if (_rtc[5] < _seconds) continue;
+    time.tm_year = _rtc[0] - 1900;
+    time.tm_mon = _rtc[1] - 1;
+    time.tm_mday = _rtc[2];
+    time.tm_hour = _rtc[3];
+    time.tm_min = _rtc[4];
+    time.tm_sec = _rtc[5];
     return true;
-  else
-    return false;
+  }
+  return false;
 }
 
 /// @brief Listen for data from Nextion device
 ///        Call in a task or the loop() function periodically.
+///        Returns one frame per call. In acknowledged mode return codes are consumed
+///        here, and timed out or failed commands are resent. Priority commands left
+///        queued are written.
 /// @param _nexBytes std::string in which to place bytes from Nextion
 /// @param _size Max number of bytes to read
 /// @return Number of bytes read or 'false' if no bytes read
 int myNextionInterface::listen(std::string& _nexBytes, uint8_t _size) {
-  if (_xSerialReadSemaphore != NULL) {
-    if (xSemaphoreTake(_xSerialReadSemaphore, 100 / portTICK_PERIOD_MS)) {
-      if (_serial->available() > 0) {
-        int _byte_read = 0;
-        uint8_t _terminatorCount = 0;  // Expect three '\xFF' bytes at end of each Nextion command
-        unsigned long _timer = millis();
+  if (_xSerialReadSemaphore == NULL) return false;
+  if (takeSemaphore(_xSerialReadSemaphore, 100 / portTICK_PERIOD_MS) != pdTRUE) return false;
+
+  if (_stashCount > 0) {
+    // Frame read earlier by getNum() or ack polling
+    _nexBytes.append((const char*)_stash[0], _stashLen[0] < _size ? _stashLen[0] : _size);
+    _stashCount--;
+    memmove(_stash[0], _stash[1], _stashCount * sizeof(_stash[0]));
+    memmove(_stashLen, _stashLen + 1, _stashCount);
+  } else {
+    unsigned long _timer = millis();
+    while ((_rxLen > 0 || _serial->available() > 0) && (millis() - _timer) < 400L) {
+      int _len = readFrame(400L - (millis() - _timer));
+      if (_len == 0) break;
+      if (_acks && isReturnCode(_len)) {
+        processAck(_rxFrame[0]);
+        continue;
+      }
+      if (_acks && takeMarker(_len)) continue;
+      _nexBytes.append((const char*)_rxFrame, _len < _size ? _len : _size);
+      break;
+    }
+  }
+  if (_acks) checkTimeouts();
+  xSemaphoreGive(_xSerialReadSemaphore);
+
+  resendPending();
+  return _nexBytes.length();
+}  // listen()
 
-        while ((_nexBytes.length() < _size) && (_terminatorCount < 3) && (millis() - _timer) < 400L) {
-          _byte_read = _serial->read();
-          if (_byte_read != -1) {  // HardwareSerial::read returns -1 if no bytes available
-            _nexBytes.push_back(_byte_read);
+/// @brief Assemble the next frame from the display. Partial frames are kept between calls.
+///        A frame ends with FF FF FF; numeric replies (0x71) are always 8 bytes, as their
+///        value may itself contain FF bytes. Yields while waiting. Read semaphore must be held.
+/// @param _timeoutMs How long to wait for the rest of a frame
+/// @return Frame length, bytes in _rxFrame (truncated to its size), or 0 if no complete frame
+int myNextionInterface::readFrame(unsigned long _timeoutMs) {
+  unsigned long _timer = millis();
+  do {
+    while (_serial->available() > 0) {
+      uint8_t _byte = _serial->read();
+      if (_rxLen < sizeof(_rxFrame)) _rxFrame[_rxLen] = _byte;
+      if (_rxLen < UINT16_MAX) _rxLen++;
+      _rxTerminators = (_byte == 0xFF) ? _rxTerminators + 1 : 0;
+      if (_rxTerminators >= 3 && (_rxFrame[0] != 0x71 || _rxLen >= 8)) {
+        int _len = _rxLen < sizeof(_rxFrame) ? _rxLen : sizeof(_rxFrame);
+        _rxLen = 0;
+        _rxTerminators = 0;
+        if (_len == 4) noteEvent(_rxFrame[0]);
+#ifdef POWER_SAVE
+        // Wake frame that woke us from light sleep, its first byte lost (see powerPlan.h)
+        if (_len == 3 && _sleeping) noteEvent(0x87);
+#endif
+        return _len;
+      }
+    }
+    if ((millis() - _timer) < _timeoutMs) vTaskDelay(1);  // Let other tasks run while the reply is on its way
+  } while ((millis() - _timer) < _timeoutMs);
+  return 0;
+}
+
+/// @brief Track display sleep state from an event frame. The frame is still returned to the caller.
+/// @param _code First byte of a four byte frame
+void myNextionInterface::noteEvent(uint8_t _code) {
+  if (_code == 0x86) {
+    _sleeping = true;
+  } else if (_code == 0x87) {
+    _sleeping = false;
+    _wakes++;
+  } else if (_code == 0x88) {
+    _sleeping = false;
+    _readies++;
+  }
+}
+
+/// @brief Is the frame in _rxFrame a bkcmd return code (0x00 - 0x24 + FF FF FF)
+bool myNextionInterface::isReturnCode(int _len) { return _len == 4 && _rxFrame[0] <= 0x24; }
+
+/// @brief Keep an event frame for the next listen(). Oldest is dropped if full.
+void myNextionInterface::stashFrame(int _len) {
+  if (_stashCount == _stashSize) {
+    _stashCount--;
+    memmove(_stash[0], _stash[1], _stashCount * sizeof(_stash[0]));
+    memmove(_stashLen, _stashLen + 1, _stashCount);
+  }
+  uint8_t _kept = _len < (int)sizeof(_stash[0]) ? _len : sizeof(_stash[0]);
+  memcpy(_stash[_stashCount], _rxFrame, _kept);
+  _stashLen[_stashCount++] = _kept;
+}
+
+/// @brief Turn acknowledged writes on or off
+///        On: display returns a code for every command (bkcmd=3). Writes are pipelined,
+///        up to NEXTION_ACK_WINDOW commands may be in flight. Return codes arrive in
+///        command order and are matched to the oldest awaiting command. A command that
+///        fails is resent up to NEXTION_ACK_RETRIES times unless its component has been
+///        written again since. A timeout resends the whole window, see checkTimeouts().
+///        Off: display only reports failures (bkcmd=2, Nextion default).
+/// @param _on Enable or disable
+/// @return true if mode changed
+bool myNextionInterface::enableAcks(bool _on) {
+  if (_on == _acks) return false;
+  if (!_on) waitForAcks(NEXTION_ACK_TIMEOUT_MS * (NEXTION_ACK_RETRIES + 1));
+
+  const char* _parts[] = {_on ? "bkcmd=3" : "bkcmd=2"};
+  if (!send(_parts, 1, false)) return false;
+  vTaskDelay(50 / portTICK_PERIOD_MS);
+  flushReads();  // Discard return code of bkcmd itself
+  clearWindow();
+
+  portENTER_CRITICAL(&_windowMux);
+  _ackStats = {};
+  portEXIT_CRITICAL(&_windowMux);
+  _acks = _on;
+  return true;
+}
+
+/// @brief Restore acknowledged writes after the display reset (0x88), which returns it
+///        to bkcmd=2. Commands in flight or queued were lost with the reset, they are
+///        dropped; repaint the display afterwards. Statistics are kept.
+/// @return true if acks are on and bkcmd=3 was sent
+bool myNextionInterface::reinitAcks() {
+  if (!_acks) return false;
+  const char* _parts[] = {"bkcmd=3"};
+  if (!send(_parts, 1, false)) return false;
+  vTaskDelay(50 / portTICK_PERIOD_MS);
+  flushReads();
+  clearWindow();
+  return true;
+}
+
+/// @brief Forget every command in flight or queued, and any resync in progress
+void myNextionInterface::clearWindow() {
+  portENTER_CRITICAL(&_windowMux);
+  for (auto& _entry : _window) _entry.state = slotFree;
+  _resyncDue = false;
+  _resyncNonce = 0;
+  _resyncTries = 0;
+  _priorityCount = 0;
+  portEXIT_CRITICAL(&_windowMux);
+}
+
+/// @brief Match a return code to the oldest command awaiting acknowledgement.
+///        While the window is being resynchronised codes are thrown away, they belong
+///        to commands sent before the marker and those are all resent.
+/// @param _code bkcmd return code, 0x01 success, otherwise error
+void myNextionInterface::processAck(uint8_t _code) {
+  portENTER_CRITICAL(&_windowMux);
+  InFlight* _oldest = nullptr;
+  for (auto& _entry : _window) {
+    if (_entry.state == slotAwaiting && (!_oldest || (int32_t)(_entry.sequence - _oldest->sequence) < 0)) {
+      _oldest = &_entry;
+    }
+  }
+  if (_resyncDue || _resyncNonce) {
+    _ackStats.discarded++;
+  } else if (!_oldest) {
+    _ackStats.stray++;
+  } else if (_code == 0x01) {
+    uint32_t _rtt = micros() - _oldest->sentMicros;
+    _ackStats.acked++;
+    _ackStats.rttTotalMicros += _rtt;
+    if (_rtt > _ackStats.rttMaxMicros) _ackStats.rttMaxMicros = _rtt;
+    _oldest->state = slotAcked;
+  } else {
+    _ackStats.failed++;
+    _ackStats.lastError = _code;
+    retryOrDrop(*_oldest);
+  }
+  releaseAcked();
+  portEXIT_CRITICAL(&_windowMux);
+}
+
+/// @brief Queue a failed command for resend, or give up on it. Call with _windowMux held.
+void myNextionInterface::retryOrDrop(InFlight& _entry) {
+  if (_entry.superseded) {
+    _entry.state = slotFree;
+  } else if (_entry.length > 0 && _entry.retries < NEXTION_ACK_RETRIES) {
+    _entry.state = slotResend;
+  } else {
+    _ackStats.abandoned++;
+    _lostWrites++;
+    _entry.state = slotFree;
+  }
+}
+
+/// @brief Free acked commands once every command sent has had its return code, so each
+///        code is known to belong to the command it was matched to. Call with _windowMux held.
+void myNextionInterface::releaseAcked() {
+  if (_resyncDue || _resyncNonce) return;
+  for (auto& _entry : _window) {
+    if (_entry.state != slotFree && _entry.state != slotAcked) return;
+  }
+  for (auto& _entry : _window) _entry.state = slotFree;
+}
+
+/// @brief Mark every command in the window for resend after the next marker. Call with _windowMux held.
+void myNextionInterface::markResync() {
+  for (auto& _entry : _window) {
+    if (_entry.state != slotFree) _entry.state = slotResync;
+  }
+  _resyncDue = true;
+  _resyncNonce = 0;
+}
+
+/// @brief Write a due resync marker, 'get' of a fresh constant. Write semaphore must be held.
+void myNextionInterface::sendMarker() {
+  portENTER_CRITICAL(&_windowMux);
+  bool _due = _resyncDue;
+  if (_due) {
+    _resyncDue = false;
+    _resyncNonce = markerTag | ++_markers;
+    _resyncMicros = micros();
+  }
+  uint32_t _nonce = _resyncNonce;
+  portEXIT_CRITICAL(&_windowMux);
+  if (!_due) return;
+
+  char _command[16];
+  snprintf(_command, sizeof(_command), "get %lu", (unsigned long)_nonce);
+  const char* _parts[] = {_command};
+  transmit(_parts, 1, nullptr);
+}
+
+/// @brief Check a frame for a marker reply. The reply to the marker in flight ends the resync:
+///        every return code before it has been seen, so the commands sent before the marker
+///        are resent and codes match again from here. Replies to older markers are ignored.
+///        Read semaphore must be held.
+/// @return true if the frame was a marker reply
+bool myNextionInterface::takeMarker(int _len) {
+  if (_len != 8 || _rxFrame[0] != 0x71) return false;
+  uint32_t _value = _rxFrame[1] | (_rxFrame[2] << 8) | (_rxFrame[3] << 16) | ((uint32_t)_rxFrame[4] << 24);
+  if ((_value & 0xFFFF0000) != markerTag) return false;
+  portENTER_CRITICAL(&_windowMux);
+  if (_resyncNonce && _value == _resyncNonce) {
+    _resyncNonce = 0;
+    _resyncTries = 0;
+    for (auto& _entry : _window) {
+      if (_entry.state == slotResync) retryOrDrop(_entry);
+    }
+    releaseAcked();
+  }
+  portEXIT_CRITICAL(&_windowMux);
+  return true;
+}
+
+/// @brief Resynchronise the window when the oldest awaiting command is not acknowledged
+///        within NEXTION_ACK_TIMEOUT_MS. Codes are matched by order alone, so a lost command,
+///        a lost code or a late code shifts every later match and any command in the window,
+///        acked or not, may be the one missing. All of them are resent once the marker reply
+///        shows no older code is still on its way. A marker not answered in time is sent
+///        again, up to NEXTION_ACK_RETRIES times, then the commands before it are abandoned.
+void myNextionInterface::checkTimeouts() {
+  unsigned long _now = micros();
+  portENTER_CRITICAL(&_windowMux);
+  if (_resyncNonce) {
+    if ((_now - _resyncMicros) > NEXTION_ACK_TIMEOUT_MS * 1000UL) {
+      _ackStats.timeouts++;
+      if (++_resyncTries <= NEXTION_ACK_RETRIES) {
+        markResync();
+      } else {
+        for (auto& _entry : _window) {
+          if (_entry.state == slotResync) {
+            _ackStats.abandoned++;
+            _lostWrites++;
+            _entry.state = slotFree;
           }
-          if (_byte_read == '\xFF') _terminatorCount++;
         }
-        xSemaphoreGive(_xSerialReadSemaphore);
-        return _nexBytes.length();
+        _resyncNonce = 0;
+        _resyncTries = 0;
+        releaseAcked();
       }
-      xSemaphoreGive(_xSerialReadSemaphore);
-      return false;
-    } else {
-      return false;
     }
-  } else
-    return false;
-}  // listen()
+  } else if (!_resyncDue) {
+    for (auto& _entry : _window) {
+      if (_entry.state == slotAwaiting && (_now - _entry.sentMicros) > NEXTION_ACK_TIMEOUT_MS * 1000UL) {
+        _ackStats.timeouts++;
+        _ackStats.resyncs++;
+        markResync();
+        break;
+      }
+    }
+  }
+  portEXIT_CRITICAL(&_windowMux);
+}
+
+/// @brief Process any return codes received, keeping other frames for listen()
+/// @param _wait Ticks to wait for the read semaphore
+/// @return Frames read
+int myNextionInterface::pollAcks(TickType_t _wait) {
+  if (_xSerialReadSemaphore == NULL) return 0;
+  if (takeSemaphore(_xSerialReadSemaphore, _wait) != pdTRUE) return 0;
+  int _len, _frames = 0;
+  while ((_len = readFrame(0)) > 0) {
+    _frames++;
+    if (isReturnCode(_len))
+      processAck(_rxFrame[0]);
+    else if (!takeMarker(_len))
+      stashFrame(_len);
+  }
+  checkTimeouts();
+  xSemaphoreGive(_xSerialReadSemaphore);
+  return _frames;
+}
+
+/// @brief Write a due resync marker, then retransmit failed and resynchronised commands,
+///        oldest first, then any priority commands still queued. The rest of the window
+///        stays in flight. Called after acks are polled, so slots freed by acks or
+///        timeouts are used without waiting for the next write.
+void myNextionInterface::resendPending() {
+  if (_xSerialWriteSemaphore == NULL) return;
+  if (takeSemaphore(_xSerialWriteSemaphore, 10 / portTICK_PERIOD_MS) != pdTRUE) return;
+  sendMarker();
+  for (;;) {
+    portENTER_CRITICAL(&_windowMux);
+    InFlight* _oldest = nullptr;
+    for (auto& _entry : _window) {
+      if (_entry.state == slotResend && (!_oldest || (int32_t)(_entry.sequence - _oldest->sequence) < 0)) {
+        _oldest = &_entry;
+      }
+    }
+    if (_oldest) {
+      if (_oldest->superseded) {
+        _oldest->state = slotFree;
+      } else {
+        // Resent command takes a new place in acknowledgement order
+        _oldest->retries++;
+        _oldest->sequence = _sequence++;
+        _oldest->sentMicros = micros();
+        _oldest->state = slotAwaiting;
+        _ackStats.resent++;
+      }
+    }
+    portEXIT_CRITICAL(&_windowMux);
+    if (!_oldest) break;
+    if (_oldest->state != slotAwaiting) continue;
+
+    _txBytes += _serial->write((const uint8_t*)_oldest->command, _oldest->length);
+    _txBytes += _serial->write((const uint8_t*)_cmdTerminator, sizeof(_cmdTerminator));
+    _txCommands++;
+  }
+  sendPriority();
+  xSemaphoreGive(_xSerialWriteSemaphore);
+}
+
+/// @brief Poll acks and resend until no commands are in flight and no resync is under way
+/// @param _timeoutMs Give up after this long
+/// @return true if every command was acknowledged or abandoned
+bool myNextionInterface::waitForAcks(unsigned long _timeoutMs) {
+  unsigned long _timer = millis();
+  for (;;) {
+    portENTER_CRITICAL(&_windowMux);
+    bool _empty = !_resyncDue && !_resyncNonce;
+    for (auto& _entry : _window) _empty = _empty && _entry.state == slotFree;
+    portEXIT_CRITICAL(&_windowMux);
+    if (_empty) return true;
+    if ((millis() - _timer) > _timeoutMs) return false;
+    int _frames = pollAcks(10 / portTICK_PERIOD_MS);
+    resendPending();
+    if (!_frames) vTaskDelay(1);  // Nothing back yet
+  }
+}
@@ -0,0 +1,220 @@
+#include "stallWatch.h"
+
+#include <esp_attr.h>
+#include <esp_timer.h>
+
+#ifdef __XTENSA__
+#include <esp_debug_helpers.h>
+#include <xtensa_context.h>
+#endif
+
+#include "deferredLog.h"
+#include "settings.h"
+
+StallWatch stallWatch;
+
+namespace {
+
+const uint32_t ringMagic = 0x53544C4C;  // "STLL"
+
+struct Section {
+  const char* name;
+  uint32_t budgetMillis;
+};
+
+const Section sections[stallSectionCount] = {
+    {"WiFi connect", 1000},
+    {"BLE scan", RUUVI_SCAN_TIME * 1000 + 1000},  // Blocks for the scan itself
+    {"HTTP fetch", 8000},  // Request, body read and parse
+    {"Nextion lock", 90},  // Under the 100 ms take timeouts, so every timeout is flagged
+};
+
+const uint32_t bucketLimits[STALL_BUCKETS - 1] = {10, 100, 1000, 5000, 15000};  // ms
+const char* const bucketNames[STALL_BUCKETS] = {"<10ms", "<100ms", "<1s", "<5s", "<15s", "more"};
+
+struct Active {
+  TaskHandle_t task;  // nullptr = free slot
+  uint32_t start;     // millis()
+  uint8_t section;
+  bool captured;
+};
+
+struct Histogram {
+  uint32_t count[STALL_BUCKETS];
+  uint32_t maxMillis;
+  uint32_t overBudget;
+};
+
+// Survives reset, not power loss. Checked by magic and bounds at begin().
+struct Ring {
+  uint32_t magic;
+  uint32_t boots;
+  uint8_t head;
+  uint8_t count;
+  StallWatch::Record records[STALL_RING_SIZE];
+};
+RTC_NOINIT_ATTR Ring ring;
+
+Active active[STALL_ACTIVE_SLOTS];
+Histogram histograms[stallSectionCount];
+esp_timer_handle_t checkTimer = nullptr;
+
+portMUX_TYPE stallMux = portMUX_INITIALIZER_UNLOCKED;
+void lock() { portENTER_CRITICAL(&stallMux); }
+void unlock() { portEXIT_CRITICAL(&stallMux); }
+
+// Walk a blocked task's stack from the registers saved when it was switched out.
+// Returns the frames found, 0 if the task is neither blocked nor suspended (its saved
+// registers are stale), -1 if it ran during the walk and the frames can't be trusted.
+// The scheduler is held off on this core; a task on the other core can still wake, so
+// its state and saved stack pointer are compared before and after.
+int8_t backtrace(TaskHandle_t task, uint32_t* pc, uint8_t depth) {
+#ifdef __XTENSA__
+  vTaskSuspendAll();
+  eTaskState state = eTaskGetState(task);
+  if (state != eBlocked && state != eSuspended) {
+    xTaskResumeAll();
+    return 0;
+  }
+  // pxTopOfStack is the first member of the TCB
+  const XtExcFrame* const volatile* top = (const XtExcFrame* const volatile*)task;
+  const XtExcFrame* frame = *top;
+  esp_backtrace_frame_t bt;
+  if (frame->exit == 0) {
+    // Solicited frame: the task yielded, e.g. blocked on a semaphore
+    const XtSolFrame* sol = (const XtSolFrame*)frame;
+    bt = {sol->pc, sol->a1, sol->a0};
+  } else {
+    bt = {frame->pc, frame->a1, frame->a0};
+  }
+  uint8_t n = 0;
+  pc[n++] = esp_cpu_process_stack_pc(bt.pc);
+  while (n < depth && bt.next_pc && esp_backtrace_get_next_frame(&bt)) pc[n++] = esp_cpu_process_stack_pc(bt.pc);
+  bool ran = eTaskGetState(task) != state || *top != frame;
+  xTaskResumeAll();
+  return ran ? -1 : n;
+#else
+  (void)task;
+  (void)pc;
+  (void)depth;
+  return 0;
+#endif
+}
+
+// Timer callback: record open sections the first time they pass their budget
+void check(void*) {
+  uint32_t now = millis();
+  for (auto& slot : active) {
+    lock();
+    bool overdue = slot.task && !slot.captured && now - slot.start > sections[slot.section].budgetMillis;
+    Active open = slot;
+    if (overdue) slot.captured = true;
+    unlock();
+    if (!overdue) continue;
+
+    StallWatch::Record record = {};
+    record.boot = ring.boots;
+    record.uptime = now / 1000;
+    record.elapsed = now - open.start;
+    record.section = open.section;
+    strlcpy(record.task, pcTaskGetName(open.task), sizeof(record.task));
+    int8_t depth = backtrace(open.task, record.pc, STALL_BACKTRACE_DEPTH);
+    if (depth < 0) {
+      // Caught waking up, try again at the next check
+      lock();
+      if (slot.task == open.task && slot.start == open.start) slot.captured = false;
+      unlock();
+      continue;
+    }
+    record.depth = depth;
+
+    lock();
+    ring.records[ring.head] = record;
+    ring.head = (ring.head + 1) % STALL_RING_SIZE;
+    if (ring.count < STALL_RING_SIZE) ring.count++;
+    unlock();
+  }
+}
+
+}  // namespace
+
+void StallWatch::begin() {
+  if (ring.magic != ringMagic || ring.head >= STALL_RING_SIZE || ring.count > STALL_RING_SIZE) {
+    memset(&ring, 0, sizeof(ring));
+    ring.magic = ringMagic;
+  }
+  ring.boots++;
+  for (auto& record : ring.records) record.task[sizeof(record.task) - 1] = 0;  // Logged with %s
+  if (ring.count) printRecords();
+
+  esp_timer_create_args_t args = {};
+  args.callback = check;
+  args.name = "stallWatch";
+  if (esp_timer_create(&args, &checkTimer) == ESP_OK) esp_timer_start_periodic(checkTimer, STALL_CHECK_MS * 1000);
+}
+
+int8_t StallWatch::enter(StallSection section) {
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+  lock();
+  for (int8_t i = 0; i < STALL_ACTIVE_SLOTS; i++) {
+    if (!active[i].task) {
+      active[i] = {task, (uint32_t)millis(), section, false};
+      unlock();
+      return i;
+    }
+  }
+  unlock();
+  return -1;
+}
+
+void StallWatch::exit(int8_t slot) {
+  if (slot < 0) return;
+  uint32_t elapsed = millis() - active[slot].start;
+  uint8_t section = active[slot].section;
+  uint8_t bucket = 0;
+  while (bucket < STALL_BUCKETS - 1 && elapsed >= bucketLimits[bucket]) bucket++;
+  bool over = elapsed > sections[section].budgetMillis;
+
+  lock();
+  active[slot].task = nullptr;
+  Histogram& h = histograms[section];
+  h.count[bucket]++;
+  if (elapsed > h.maxMillis) h.maxMillis = elapsed;
+  if (over) h.overBudget++;
+  unlock();
+
+  if (over) {
+    LOG_WARN("Stall: %s took %u ms (budget %u ms) in %s", sections[section].name, elapsed,
+             sections[section].budgetMillis, pcTaskGetName(nullptr));
+  }
+}
+
+void StallWatch::report() {
+  static_assert(STALL_BUCKETS == 6, "one log argument per bucket");
+  for (uint8_t s = 0; s < stallSectionCount; s++) {
+    lock();
+    Histogram h = histograms[s];
+    unlock();
+    deferredLog.waitForRoom(2);
+    LOG_INFO("Stall: %-12s max %5u ms, %u over %u ms", sections[s].name, h.maxMillis, h.overBudget,
+             sections[s].budgetMillis);
+    LOG_INFO("  <10ms %u, <100ms %u, <1s %u, <5s %u, <15s %u, more %u", h.count[0], h.count[1], h.count[2],
+             h.count[3], h.count[4], h.count[5]);
+  }
+}
+
+// Records are logged from the ring itself, their task names must outlive the log records.
+// The check timer is not running yet at begin(), so nothing overwrites them meanwhile.
+void StallWatch::printRecords() {
+  LOG_INFO("Stall records (boot %u):", ring.boots);
+  for (uint8_t i = 0; i < ring.count; i++) {
+    const Record& r = ring.records[(ring.head + STALL_RING_SIZE - ring.count + i) % STALL_RING_SIZE];
+    if (r.section >= stallSectionCount) continue;
+    deferredLog.waitForRoom(1 + STALL_BACKTRACE_DEPTH);
+    LOG_INFO("  boot %u at %u s: %s, %u ms in %s, %u frames", r.boot, r.uptime, sections[r.section].name, r.elapsed,
+             r.task, r.depth);
+    for (uint8_t f = 0; f < r.depth && f < STALL_BACKTRACE_DEPTH; f++) LOG_INFO("    0x%08x", r.pc[f]);
+  }
+}
+
+uint32_t StallWatch::boots() { return ring.boots; }
@@ -0,0 +1,339 @@
+#include "tlsClient.h"
+
+#include <lwip/netdb.h>
+#include <lwip/sockets.h>
+#include <mbedtls/pk.h>
+#include <mbedtls/sha256.h>
+#include <mbedtls/version.h>
+
+#include "deferredLog.h"
+
+ResumableTlsClient::ResumableTlsClient() {
+  mbedtls_ssl_session_init(&_session);
+  mbedtls_net_init(&_net);
+  mbedtls_ssl_init(&_ssl);
+}
+
+ResumableTlsClient::~ResumableTlsClient() {
+  stop();
+  mbedtls_ssl_session_free(&_session);
+  if (_configured) {
+    mbedtls_ssl_config_free(&_conf);
+    mbedtls_x509_crt_free(&_ca);
+    mbedtls_ctr_drbg_free(&_drbg);
+    mbedtls_entropy_free(&_entropy);
+  }
+}
+
+/// @brief Pin the server's public key
+/// @param sha256Hex SHA-256 of the DER SubjectPublicKeyInfo, 64 hex digits
+/// @return true if the pin is well formed
+bool ResumableTlsClient::setPublicKeyPin(const char* sha256Hex) {
+  _hasPin = false;
+  if (sha256Hex == nullptr || strlen(sha256Hex) != 2 * sizeof(_pin)) return false;
+  for (size_t i = 0; i < sizeof(_pin); i++) {
+    char byteHex[3] = {sha256Hex[2 * i], sha256Hex[2 * i + 1], 0};
+    char* end;
+    _pin[i] = strtoul(byteHex, &end, 16);
+    if (*end) return false;
+  }
+  _hasPin = true;
+  return true;
+}
+
+/// @brief One time TLS setup: random generator, client configuration and pinned CA
+/// @return true if ready to connect
+bool ResumableTlsClient::configure() {
+  if (_configured) return true;
+  if (_caPem == nullptr && !_hasPin) {
+    LOG_ERROR("TLS: no CA certificate or public key pin set");
+    return false;
+  }
+
+  mbedtls_entropy_init(&_entropy);
+  mbedtls_ctr_drbg_init(&_drbg);
+  mbedtls_ssl_config_init(&_conf);
+  mbedtls_x509_crt_init(&_ca);
+  _configured = true;
+
+  int ret = mbedtls_ctr_drbg_seed(&_drbg, mbedtls_entropy_func, &_entropy, nullptr, 0);
+  if (ret == 0) {
+    ret = mbedtls_ssl_config_defaults(&_conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                      MBEDTLS_SSL_PRESET_DEFAULT);
+  }
+  if (ret == 0 && _caPem) ret = mbedtls_x509_crt_parse(&_ca, (const unsigned char*)_caPem, strlen(_caPem) + 1);
+  if (ret != 0) {
+    LOG_ERROR("TLS: setup failed (-0x%04X)", -ret);
+    return false;
+  }
+
+  mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &_drbg);
+  if (_caPem) {
+    mbedtls_ssl_conf_ca_chain(&_conf, &_ca, nullptr);
+    mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+  } else {
+    mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_NONE);  // Pinned key is the trust anchor
+  }
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+  mbedtls_ssl_conf_session_tickets(&_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+  return true;
+}
+
+int ResumableTlsClient::connect(IPAddress ip, uint16_t port) {
+  return connect(ip.toString().c_str(), port, TLS_HANDSHAKE_TIMEOUT_MS);
+}
+
+int ResumableTlsClient::connect(IPAddress ip, uint16_t port, int32_t timeout) {
+  return connect(ip.toString().c_str(), port, timeout);
+}
+
+int ResumableTlsClient::connect(const char* host, uint16_t port) {
+  return connect(host, port, TLS_HANDSHAKE_TIMEOUT_MS);
+}
+
+/// @brief Open a TLS connection, offering the session of the previous connection
+/// @param host Server name, also used for SNI and certificate name check
+/// @param port TCP port
+/// @param timeout Handshake timeout (ms)
+/// @return 1 if connected, 0 on failure
+int ResumableTlsClient::connect(const char* host, uint16_t port, int32_t timeout) {
+  stop();
+  if (!configure()) return 0;
+
+  uint32_t heapBefore = esp_get_free_heap_size();
+  unsigned long tcpStart = micros();
+  int ret = connectTcp(host, port, timeout);
+  _lastTcpMicros = micros() - tcpStart;
+  if (ret == 0) ret = mbedtls_net_set_nonblock(&_net);
+  if (ret == 0) ret = mbedtls_ssl_setup(&_ssl, &_conf);
+  if (ret == 0) ret = mbedtls_ssl_set_hostname(&_ssl, host);
+  if (ret == 0 && _hasSession) ret = mbedtls_ssl_set_session(&_ssl, &_session);
+  _connected = true;  // Context needs freeing from here on
+
+  unsigned long handshakeStart = micros();
+  if (ret == 0) {
+    mbedtls_ssl_set_bio(&_ssl, &_net, mbedtls_net_send, mbedtls_net_recv, nullptr);
+    while ((ret = mbedtls_ssl_handshake(&_ssl)) != 0) {
+      if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) break;
+      if ((long)(micros() - handshakeStart) / 1000 > timeout) break;
+      vTaskDelay(1);
+    }
+  }
+  uint32_t handshakeMicros = micros() - handshakeStart;
+
+  if (ret != 0 || !verifyPeer()) {
+    if (ret != 0) LOG_WARN("TLS: connect to port %u failed (-0x%04X)", port, -ret);  // host may be a temporary
+    _failures++;
+    _peerClosed = true;  // No close_notify on a failed handshake
+    forgetSession();
+    stop();
+    return 0;
+  }
+
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+#if MBEDTLS_VERSION_NUMBER >= 0x021B0000  // 2.27, session fields are private from 3.0
+  _lastResumed = _hasSession && mbedtls_ssl_session_reused(&_ssl);
+#else
+  _lastResumed = false;
+#endif
+  if (mbedtls_ssl_get_session(&_ssl, &session) == 0) {
+#if MBEDTLS_VERSION_NUMBER < 0x021B0000
+    // A resumed session keeps the master secret of the session it was resumed from
+    _lastResumed = _hasSession && memcmp(session.master, _session.master, sizeof(session.master)) == 0;
+#endif
+    mbedtls_ssl_session_free(&_session);
+    _session = session;  // Takes ownership of ticket and peer certificate
+    _hasSession = true;
+  } else {
+    mbedtls_ssl_session_free(&session);
+    forgetSession();
+  }
+
+  _lastMicros = handshakeMicros;
+  _lastHeap = heapBefore - esp_get_free_heap_size();
+  HandshakeStats& stats = _lastResumed ? _resumed : _full;
+  stats.count++;
+  stats.totalMicros += handshakeMicros;
+  stats.totalHeap += _lastHeap;
+  if (handshakeMicros > stats.maxMicros) stats.maxMicros = handshakeMicros;
+  return 1;
+}
+
+/// @brief Open the TCP connection, giving up after timeout. mbedtls_net_connect() would
+///        block for the stack's own connect timeout, over a minute on lwIP. Name lookup
+///        still blocks for up to the resolver's timeout.
+/// @return 0, or an MBEDTLS_ERR_NET_* or MBEDTLS_ERR_SSL_TIMEOUT code
+int ResumableTlsClient::connectTcp(const char* host, uint16_t port, int32_t timeout) {
+  char portText[6];
+  snprintf(portText, sizeof(portText), "%u", port);
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_protocol = IPPROTO_TCP;
+  struct addrinfo* addresses = nullptr;
+  if (getaddrinfo(host, portText, &hints, &addresses) != 0 || addresses == nullptr) {
+    return MBEDTLS_ERR_NET_UNKNOWN_HOST;
+  }
+
+  int ret = MBEDTLS_ERR_NET_CONNECT_FAILED;
+  unsigned long start = millis();
+  for (struct addrinfo* address = addresses; address && ret != 0; address = address->ai_next) {
+    int fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (fd < 0) continue;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    if (::connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+      ret = 0;
+    } else if (errno == EINPROGRESS) {
+      int32_t left = timeout - (int32_t)(millis() - start);
+      if (left < 0) left = 0;
+      struct timeval wait = {left / 1000, (left % 1000) * 1000};
+      fd_set writable;
+      FD_ZERO(&writable);
+      FD_SET(fd, &writable);
+      int ready = select(fd + 1, nullptr, &writable, nullptr, &wait);
+      int error = 0;
+      socklen_t length = sizeof(error);
+      if (ready == 0) {
+        ret = MBEDTLS_ERR_SSL_TIMEOUT;
+      } else if (ready > 0 && getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0) {
+        ret = 0;
+      }
+    }
+    if (ret == 0) {
+      _net.fd = fd;
+    } else {
+      close(fd);
+      if (ret == MBEDTLS_ERR_SSL_TIMEOUT) break;
+    }
+  }
+  freeaddrinfo(addresses);
+  return ret;
+}
+
+/// @brief Check the pinned public key, if set. Chain is checked in the handshake.
+bool ResumableTlsClient::verifyPeer() {
+  if (!_hasPin) return true;
+  const mbedtls_x509_crt* peer = mbedtls_ssl_get_peer_cert(&_ssl);
+  if (peer == nullptr) {
+    LOG_ERROR("TLS: no server certificate to check pin");
+    return false;
+  }
+
+  // Key is written at the end of the buffer
+  unsigned char der[1024];
+  int len = mbedtls_pk_write_pubkey_der((mbedtls_pk_context*)&peer->pk, der, sizeof(der));
+  if (len <= 0) return false;
+  unsigned char hash[32];
+#if MBEDTLS_VERSION_MAJOR >= 3
+  if (mbedtls_sha256(der + sizeof(der) - len, len, hash, 0) != 0) return false;
+#else
+  if (mbedtls_sha256_ret(der + sizeof(der) - len, len, hash, 0) != 0) return false;
+#endif
+  if (memcmp(hash, _pin, sizeof(hash)) == 0) return true;
+
+  // The key is not printed: a pin copied from a mismatch trusts whoever answered
+  LOG_ERROR("TLS: public key pin mismatch");
+  return false;
+}
+
+void ResumableTlsClient::forgetSession() {
+  mbedtls_ssl_session_free(&_session);
+  mbedtls_ssl_session_init(&_session);
+  _hasSession = false;
+}
+
+/// @brief Close connection. The session is kept for the next connect().
+void ResumableTlsClient::stop() {
+  if (_connected) {
+    if (!_peerClosed) mbedtls_ssl_close_notify(&_ssl);
+    mbedtls_ssl_free(&_ssl);
+    mbedtls_net_free(&_net);
+    mbedtls_ssl_init(&_ssl);
+    mbedtls_net_init(&_net);
+  }
+  _connected = false;
+  _peerClosed = false;
+  _peeked = -1;
+}
+
+uint8_t ResumableTlsClient::connected() { return _connected && (!_peerClosed || available() > 0); }
+
+/// @brief Read decrypted bytes without blocking
+/// @return Bytes read, 0 if none available
+int ResumableTlsClient::readRecord(uint8_t* buf, size_t size) {
+  if (!_connected || _peerClosed) return 0;
+  int ret = mbedtls_ssl_read(&_ssl, buf, size);
+  if (ret > 0) return ret;
+  if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) _peerClosed = true;
+  return 0;
+}
+
+int ResumableTlsClient::available() {
+  if (!_connected) return 0;
+  if (!_peerClosed && mbedtls_ssl_get_bytes_avail(&_ssl) == 0) {
+    int ret = mbedtls_ssl_read(&_ssl, nullptr, 0);  // Pull in next record
+    if (ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) _peerClosed = true;
+  }
+  return (_peeked >= 0) + (_peerClosed ? 0 : (int)mbedtls_ssl_get_bytes_avail(&_ssl));
+}
+
+int ResumableTlsClient::read(uint8_t* buf, size_t size) {
+  size_t count = 0;
+  if (_peeked >= 0 && size > 0) {
+    buf[count++] = _peeked;
+    _peeked = -1;
+  }
+  if (count < size) count += readRecord(buf + count, size - count);
+  return count > 0 ? (int)count : -1;
+}
+
+int ResumableTlsClient::read() {
+  uint8_t data;
+  return read(&data, 1) == 1 ? data : -1;
+}
+
+int ResumableTlsClient::peek() {
+  if (_peeked < 0) {
+    uint8_t data;
+    if (readRecord(&data, 1) == 1) _peeked = data;
+  }
+  return _peeked;
+}
+
+size_t ResumableTlsClient::write(const uint8_t* buf, size_t size) {
+  if (!_connected) return 0;
+  size_t written = 0;
+  unsigned long start = millis();
+  while (written < size) {
+    int ret = mbedtls_ssl_write(&_ssl, buf + written, size - written);
+    if (ret > 0) {
+      written += ret;
+    } else if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+      _peerClosed = true;
+      break;
+    } else if (millis() - start > TLS_WRITE_TIMEOUT_MS) {
+      break;
+    } else {
+      vTaskDelay(1);
+    }
+  }
+  return written;
+}
+
+/// @brief Log last handshake and full vs resumed handshake cost
+void ResumableTlsClient::report() {
+  deferredLog.waitForRoom(4);
+  LOG_INFO("TLS: %s handshake %u ms (TCP connect %u ms), connection heap %u bytes", _lastResumed ? "resumed" : "full",
+           _lastMicros / 1000, _lastTcpMicros / 1000, _lastHeap);
+  const HandshakeStats* kinds[] = {&_full, &_resumed};
+  static const char* const names[] = {"full", "resumed"};
+  for (int i = 0; i < 2; i++) {
+    const HandshakeStats& s = *kinds[i];
+    LOG_INFO("  %-7s %4u handshakes, avg %u ms, max %u ms, avg heap %u bytes", names[i], s.count,
+             s.count ? (uint32_t)(s.totalMicros / s.count / 1000) : 0, s.maxMicros / 1000,
+             s.count ? (uint32_t)(s.totalHeap / s.count) : 0);
+  }
+  LOG_INFO("  %u failed connects", _failures);
+}
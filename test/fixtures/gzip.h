@@ -0,0 +1,298 @@
+#ifndef GZIP_FIXTURE_H
+#define GZIP_FIXTURE_H
+
+// gzip members (RFC 1952) for GzipStream, compressed at level 9 by zlib.
+//   oneCallGzip: oneCallFixture three times over (65115 bytes, more than the 32 KB window), FNAME set
+//   headerGzip:  headerGzipText with every optional header field, FEXTRA, FNAME, FCOMMENT and FHCRC
+
+static const char headerGzipText[] = R"json({"lat":41.85,"lon":-87.65,"current":{"dt":1720002034}})json";
+
+static const uint8_t oneCallGzip[] = {
+    0x1f, 0x8b, 0x08, 0x08, 0xf2, 0x25, 0x85, 0x66, 0x02, 0x03, 0x6f, 0x6e, 0x65, 0x43, 0x61, 0x6c,
+    0x6c, 0x2e, 0x6a, 0x73, 0x6f, 0x6e, 0x00, 0xed, 0x5c, 0xdb, 0x6e, 0x1b, 0x39, 0x12, 0x7d, 0x9f,
+    0xaf, 0x68, 0xe8, 0x71, 0xe1, 0xed, 0xe5, 0xfd, 0x92, 0x37, 0xad, 0xad, 0x4d, 0xbc, 0x71, 0xe4,
+    0xc0, 0x76, 0xc6, 0x58, 0xcc, 0x0c, 0x02, 0xad, 0xdd, 0x89, 0x85, 0xb1, 0x25, 0x43, 0x97, 0xcc,
+    0x64, 0x83, 0xfc, 0xfb, 0x92, 0xdd, 0x92, 0xba, 0x59, 0xa4, 0xda, 0x0c, 0xc6, 0xd6, 0x53, 0x25,
+    0x40, 0x2e, 0x12, 0xbb, 0xcd, 0x3e, 0x3c, 0xac, 0x2a, 0x56, 0x55, 0x9f, 0x6f, 0x83, 0xfb, 0xc9,
+    0x6a, 0xf0, 0x4a, 0xd0, 0xd2, 0xc8, 0xa3, 0xc1, 0xfd, 0x7c, 0x36, 0x78, 0xf5, 0x77, 0xa3, 0x4b,
+    0xe5, 0xfe, 0xb3, 0x9a, 0x3e, 0x54, 0xff, 0x9b, 0xcf, 0xaa, 0xc1, 0xab, 0xc1, 0xf0, 0xa1, 0x5a,
+    0x4c, 0x6f, 0x26, 0xff, 0x38, 0xbe, 0x73, 0x7f, 0x7e, 0x9e, 0x0f, 0xda, 0x2f, 0x3f, 0xce, 0x3f,
+    0x7d, 0x5a, 0x56, 0xee, 0x0e, 0x7f, 0xa7, 0x86, 0x10, 0x72, 0xf4, 0xd3, 0xe0, 0x66, 0xbd, 0x58,
+    0x54, 0x33, 0xf7, 0xc9, 0xb7, 0xc1, 0xad, 0xfb, 0x93, 0x6a, 0xe6, 0x3e, 0x67, 0x84, 0x8b, 0xa3,
+    0xc1, 0x72, 0x3d, 0x5b, 0x4c, 0x97, 0x95, 0xff, 0x90, 0x5a, 0x6b, 0x15, 0x51, 0xa4, 0xfe, 0xb0,
+    0xbe, 0x41, 0x3d, 0x50, 0x12, 0xee, 0x6e, 0x32, 0x58, 0x55, 0x0f, 0x8f, 0x83, 0x57, 0xcc, 0x96,
+    0x46, 0x1f, 0x0d, 0x3e, 0x55, 0xd5, 0xfd, 0xf2, 0xe3, 0xfd, 0xf4, 0x77, 0x77, 0x21, 0x67, 0x25,
+    0x3d, 0x1a, 0x3c, 0x2e, 0xaa, 0xe5, 0x72, 0xbd, 0xf0, 0x37, 0x22, 0x94, 0x1d, 0x0d, 0xee, 0xd6,
+    0x0f, 0xd3, 0xdb, 0xe9, 0xea, 0xeb, 0xe0, 0x95, 0x34, 0x47, 0x83, 0xdb, 0xea, 0x8f, 0x8f, 0x8f,
+    0xf3, 0xa9, 0x9f, 0x02, 0x23, 0xa5, 0xe1, 0x47, 0x83, 0xf5, 0x97, 0xe9, 0xe0, 0x95, 0x2e, 0x85,
+    0xbb, 0xf4, 0xe6, 0x7e, 0xbe, 0xbe, 0x5d, 0xba, 0x07, 0x76, 0x3f, 0xe5, 0xcb, 0x74, 0x39, 0xfd,
+    0xef, 0xf4, 0xbe, 0xbe, 0x90, 0x12, 0x3f, 0xfb, 0xc1, 0x1f, 0xd3, 0xd9, 0xed, 0xc7, 0xe5, 0x63,
+    0x55, 0xdd, 0xba, 0x21, 0xa5, 0xbf, 0x77, 0xfd, 0xc9, 0x6d, 0xf5, 0xd9, 0xdf, 0x6c, 0x3b, 0xe0,
+    0xf3, 0x7a, 0xb9, 0xf2, 0x37, 0xf4, 0x5f, 0x57, 0x93, 0xd5, 0x5d, 0xb5, 0x18, 0xbc, 0xfa, 0xe5,
+    0xdb, 0x60, 0xea, 0x2e, 0x32, 0xc4, 0x7d, 0xf8, 0x30, 0x99, 0x3a, 0x1c, 0x07, 0xc7, 0xcd, 0xcf,
+    0xf2, 0x33, 0x5a, 0xde, 0x2c, 0xa6, 0x8f, 0xab, 0xa9, 0x87, 0x77, 0xb0, 0xbc, 0x99, 0xac, 0x56,
+    0xd5, 0xa2, 0xba, 0x2d, 0x6e, 0xb6, 0x03, 0xa6, 0x37, 0xf5, 0x37, 0x84, 0xdf, 0x0e, 0xbe, 0xff,
+    0xf6, 0xdd, 0x81, 0xf8, 0x30, 0x9d, 0xad, 0x57, 0xd5, 0xbd, 0x9b, 0xd8, 0x2f, 0x3f, 0x85, 0x38,
+    0xfa, 0x49, 0xb8, 0xe7, 0xbf, 0x99, 0x3e, 0x4e, 0x57, 0x93, 0xe6, 0x8e, 0xc4, 0x5d, 0x11, 0x0e,
+    0x52, 0x19, 0x83, 0x28, 0xcb, 0x19, 0x64, 0x32, 0x06, 0x31, 0x91, 0x31, 0x88, 0xe7, 0x4c, 0x9c,
+    0xe7, 0x4c, 0x5c, 0xe4, 0x4c, 0x5c, 0xe4, 0x4c, 0x5c, 0xe6, 0x4c, 0x5c, 0xe5, 0x4c, 0x5c, 0xe5,
+    0x4c, 0x5c, 0xe7, 0x4c, 0x5c, 0xe7, 0x4c, 0xdc, 0xe4, 0x4c, 0xdc, 0xe6, 0x4c, 0xdc, 0x66, 0x4c,
+    0x9c, 0x93, 0xd4, 0xc4, 0x4b, 0x11, 0x0d, 0x4b, 0x4d, 0xbd, 0x54, 0x70, 0x18, 0x4d, 0x4d, 0xbe,
+    0x34, 0x70, 0x18, 0x4b, 0x4c, 0x9f, 0x96, 0xd1, 0xdc, 0x98, 0x4a, 0x0d, 0xa3, 0x16, 0x8e, 0xe3,
+    0x2c, 0x35, 0x8e, 0x47, 0x3f, 0x96, 0x9b, 0xd4, 0x38, 0x19, 0x3d, 0x85, 0x10, 0xa9, 0x71, 0x3a,
+    0x02, 0x45, 0x26, 0x1f, 0xc3, 0xd2, 0x68, 0x5c, 0xe2, 0x39, 0x58, 0x49, 0xa2, 0xf9, 0x29, 0x96,
+    0x1a, 0xc7, 0x78, 0x34, 0xce, 0xa4, 0xc6, 0xc5, 0xcf, 0xab, 0x45, 0x6a, 0x9c, 0x64, 0x70, 0x9c,
+    0x21, 0xa9, 0x71, 0x2a, 0x7a, 0x5e, 0x93, 0x7c, 0x0e, 0x1d, 0xe1, 0x67, 0x93, 0xcf, 0x61, 0xe2,
+    0x71, 0xc9, 0xe7, 0xb0, 0x12, 0x8c, 0x13, 0x24, 0xf1, 0x1c, 0xbc, 0x24, 0xf0, 0x39, 0x04, 0x25,
+    0xc9, 0x71, 0x36, 0x1a, 0xa7, 0x52, 0xe3, 0x28, 0x7c, 0x5e, 0xc1, 0x58, 0x72, 0x9c, 0x8e, 0xc6,
+    0x99, 0xe4, 0xb8, 0xe8, 0xe7, 0xf2, 0xe4, 0x73, 0x44, 0x8f, 0x21, 0x48, 0xde, 0xed, 0x84, 0xca,
+    0x9b, 0x9e, 0x64, 0x79, 0x8f, 0x2b, 0x4d, 0x1e, 0x7c, 0x2a, 0x73, 0x39, 0x34, 0xc9, 0x5b, 0x5e,
+    0xad, 0xb2, 0xe8, 0x22, 0x0c, 0xcb, 0xa2, 0x9f, 0x30, 0x26, 0x8b, 0xce, 0xc2, 0xe6, 0x6d, 0x0f,
+    0x49, 0x48, 0xd6, 0x76, 0x93, 0x44, 0x65, 0x6d, 0x5f, 0x49, 0x59, 0x96, 0x39, 0x90, 0xd4, 0x64,
+    0x99, 0x17, 0xc9, 0xf2, 0xcc, 0x95, 0xe4, 0x24, 0xcb, 0xfc, 0x49, 0xae, 0xb2, 0xcc, 0xa9, 0x14,
+    0x2c, 0xcb, 0x3c, 0x4b, 0x61, 0x72, 0xac, 0xbd, 0x94, 0x59, 0xbe, 0x43, 0x26, 0x7d, 0xb6, 0xf3,
+    0x44, 0x3f, 0xfd, 0xe6, 0x62, 0xab, 0xbb, 0xf9, 0x7a, 0x11, 0x47, 0x56, 0xc4, 0x74, 0x02, 0x4f,
+    0x59, 0x4a, 0x19, 0x06, 0x9e, 0xcc, 0x45, 0x7b, 0xb2, 0x37, 0xf2, 0x24, 0x41, 0xe4, 0x49, 0x75,
+    0x49, 0xe5, 0x26, 0xf2, 0x54, 0xf5, 0xa5, 0xdb, 0xc8, 0xf3, 0xe9, 0xc0, 0xd3, 0xed, 0x93, 0x6e,
+    0xdc, 0x59, 0x2f, 0x71, 0x27, 0xee, 0x34, 0xf5, 0xd7, 0xcf, 0x1f, 0x77, 0xba, 0xa7, 0x9b, 0x3f,
+    0xc6, 0xde, 0xbf, 0x31, 0x35, 0x1b, 0x60, 0xdc, 0x53, 0x71, 0x00, 0x8c, 0xa9, 0x43, 0xec, 0x00,
+    0x18, 0x1a, 0x00, 0xa3, 0x43, 0x60, 0x4c, 0xa9, 0xdb, 0x90, 0x9c, 0x75, 0x42, 0x72, 0xaa, 0x33,
+    0x90, 0x61, 0x2a, 0x84, 0xc6, 0x82, 0x90, 0xdc, 0x8a, 0x43, 0x62, 0x53, 0x1f, 0x79, 0xb6, 0xd8,
+    0x98, 0x12, 0x70, 0x86, 0x13, 0x7f, 0x42, 0x08, 0x90, 0x21, 0x5d, 0x64, 0x94, 0x80, 0x87, 0x15,
+    0xba, 0x03, 0xc6, 0xb4, 0xb8, 0xf8, 0x93, 0xd3, 0x93, 0xb8, 0x48, 0x1a, 0xe0, 0x62, 0x0d, 0xc0,
+    0x45, 0xab, 0x03, 0xe2, 0x42, 0xa9, 0x0a, 0x4e, 0x71, 0xd2, 0x02, 0x60, 0x68, 0xc9, 0x6c, 0x88,
+    0x0c, 0xb1, 0x5d, 0x64, 0x34, 0x0d, 0x91, 0xf1, 0x16, 0x63, 0x03, 0x4d, 0xcd, 0xfe, 0x2d, 0x34,
+    0xfe, 0xa9, 0x9f, 0x84, 0xc6, 0xd3, 0xad, 0x7b, 0x8a, 0xd3, 0x00, 0x1a, 0x91, 0x84, 0x86, 0x3f,
+    0x05, 0xcd, 0x7f, 0x17, 0xf3, 0xdf, 0xab, 0x59, 0x8c, 0x8b, 0xe8, 0xc1, 0x45, 0xb2, 0x16, 0x17,
+    0xc7, 0x0e, 0xce, 0xa2, 0xd3, 0x2d, 0x01, 0x8c, 0x21, 0x26, 0xc0, 0xc5, 0x40, 0x5c, 0x2c, 0x4b,
+    0x51, 0x46, 0x99, 0x0c, 0x5c, 0x6c, 0x88, 0x0b, 0x55, 0x00, 0x17, 0xff, 0xa3, 0x0f, 0x84, 0x8b,
+    0x31, 0x01, 0x2e, 0x4a, 0x46, 0xb8, 0x70, 0x60, 0x7c, 0xfd, 0x2a, 0xb6, 0xb8, 0xf8, 0xdc, 0x45,
+    0x17, 0x17, 0x56, 0x5b, 0xdc, 0x84, 0x8d, 0xf1, 0x03, 0x9f, 0x3c, 0xf6, 0x13, 0x1b, 0x00, 0xe3,
+    0x6f, 0xd5, 0x01, 0x46, 0x95, 0x8a, 0x1f, 0x0a, 0x18, 0x7f, 0xb4, 0xee, 0x02, 0xe3, 0xd3, 0x1b,
+    0x00, 0x18, 0x66, 0x00, 0x30, 0x2a, 0x30, 0xbe, 0x0c, 0x02, 0x43, 0x4d, 0xd2, 0x2b, 0xd1, 0x0c,
+    0x5c, 0x58, 0x60, 0x63, 0x98, 0xb7, 0x4b, 0x01, 0x2e, 0x34, 0x61, 0x7b, 0xeb, 0xe3, 0xcf, 0x06,
+    0x97, 0x0b, 0xff, 0x17, 0x44, 0xe5, 0x7e, 0xfa, 0xf9, 0x6e, 0x55, 0x2c, 0x9a, 0xaf, 0x36, 0x90,
+    0x50, 0xd2, 0x85, 0xa4, 0x5e, 0xfb, 0x7a, 0xc0, 0xab, 0x6f, 0x03, 0x7a, 0x57, 0xc7, 0x0f, 0xdf,
+    0x01, 0x4e, 0x8a, 0x04, 0x38, 0x79, 0x0f, 0x04, 0x0c, 0x8e, 0xe9, 0xcf, 0x1b, 0x59, 0xb8, 0xb1,
+    0xf4, 0xd6, 0x16, 0x8b, 0xd2, 0xda, 0x0e, 0x4e, 0x26, 0x07, 0x28, 0x13, 0x00, 0x25, 0x78, 0x00,
+    0x94, 0x2c, 0xd5, 0x0b, 0x01, 0x15, 0xe1, 0x24, 0x21, 0x4e, 0x36, 0x34, 0xcc, 0xcc, 0x44, 0x1e,
+    0xcb, 0x9a, 0x3e, 0x67, 0xae, 0x54, 0x94, 0x5f, 0xdb, 0xf2, 0x89, 0x97, 0x42, 0x77, 0x9c, 0x56,
+    0xce, 0x46, 0x0b, 0x0d, 0x90, 0x64, 0x00, 0x26, 0x1f, 0x10, 0xbc, 0x04, 0x4c, 0x0a, 0xe0, 0xe4,
+    0x18, 0x06, 0x70, 0xe2, 0x9c, 0x05, 0x8e, 0x9d, 0x82, 0x34, 0xe4, 0x26, 0x33, 0xb9, 0xdf, 0xb5,
+    0x7b, 0x9f, 0xd3, 0x0d, 0x7a, 0x6c, 0xa9, 0xf5, 0x06, 0x27, 0x47, 0xad, 0x8e, 0xa5, 0xf6, 0x0f,
+    0xfd, 0x34, 0x9f, 0x74, 0x00, 0x94, 0xa2, 0x01, 0x50, 0xc2, 0x85, 0xf1, 0x29, 0xa0, 0x68, 0x3f,
+    0x50, 0x0f, 0xf3, 0xdb, 0x6a, 0x31, 0x59, 0x55, 0xfd, 0x58, 0x19, 0x08, 0x95, 0x86, 0x50, 0xa9,
+    0x6e, 0xe0, 0xac, 0xea, 0x34, 0x32, 0x88, 0x0f, 0xa5, 0xec, 0xf3, 0xf5, 0x86, 0xc0, 0xf8, 0x50,
+    0x6c, 0x6d, 0x37, 0xe9, 0xfa, 0x7a, 0x65, 0x73, 0x32, 0xb6, 0xe1, 0xce, 0xd3, 0x04, 0x20, 0xf5,
+    0x72, 0x40, 0xb1, 0xa7, 0x6c, 0x94, 0xcf, 0x50, 0x74, 0x4f, 0x18, 0x82, 0x47, 0x27, 0x0c, 0xca,
+    0xfb, 0x9c, 0xbf, 0xd1, 0xf0, 0x84, 0x41, 0xb6, 0x81, 0x74, 0x07, 0x26, 0xa3, 0x72, 0x3c, 0x9c,
+    0x0c, 0x61, 0xb2, 0x00, 0x26, 0x7f, 0x74, 0x79, 0x3e, 0x9c, 0x66, 0xfd, 0xc6, 0x1c, 0x1a, 0x29,
+    0x7f, 0xe0, 0x68, 0x81, 0x72, 0x93, 0x05, 0xc6, 0xdc, 0x61, 0xa7, 0x69, 0x5f, 0x34, 0x20, 0xc3,
+    0xb8, 0x9a, 0x3a, 0x83, 0x4b, 0x63, 0xa0, 0x58, 0x46, 0x88, 0x64, 0x42, 0x3a, 0x19, 0x03, 0x70,
+    0x22, 0x89, 0x0a, 0x00, 0xa3, 0x2d, 0x4e, 0x57, 0x77, 0xeb, 0x99, 0x03, 0x65, 0xb9, 0x9a, 0x2f,
+    0x1e, 0x22, 0xbc, 0x56, 0xe1, 0x97, 0x5b, 0xb8, 0xe8, 0xac, 0xc7, 0xa4, 0xc7, 0xa6, 0xca, 0x67,
+    0x46, 0x5a, 0xb4, 0x58, 0xa9, 0x40, 0xac, 0xed, 0x00, 0xe4, 0xb6, 0x2f, 0x44, 0x50, 0x61, 0xac,
+    0x4d, 0x45, 0x1d, 0x9b, 0x43, 0xb4, 0xa8, 0xcd, 0x80, 0x4b, 0x85, 0x76, 0xca, 0x6a, 0x08, 0x17,
+    0x7d, 0x69, 0xb8, 0x62, 0xd3, 0x0e, 0xed, 0x95, 0xcf, 0xac, 0xb4, 0x78, 0xd1, 0x28, 0xa4, 0x62,
+    0x3c, 0x0a, 0xa9, 0xc2, 0x50, 0x41, 0x85, 0x31, 0x38, 0xe5, 0x6d, 0x48, 0xd5, 0xc1, 0x8b, 0xab,
+    0x0c, 0xbc, 0x84, 0xe8, 0xe2, 0xc5, 0x89, 0x82, 0xdb, 0x90, 0xbf, 0x34, 0x5e, 0xe6, 0x29, 0xab,
+    0xe5, 0x13, 0x33, 0x2d, 0x5c, 0x0e, 0x4e, 0x68, 0xde, 0x59, 0x6d, 0xae, 0xf7, 0x47, 0x0c, 0x3a,
+    0x0c, 0xcd, 0x69, 0x13, 0xca, 0x43, 0xb8, 0x24, 0xcf, 0x80, 0x2b, 0x34, 0xee, 0x9c, 0x4a, 0x00,
+    0x17, 0x57, 0xcf, 0x16, 0x2f, 0xcc, 0x7a, 0x4d, 0x3b, 0xb4, 0x58, 0xd2, 0x88, 0x00, 0x24, 0x18,
+    0x56, 0xf9, 0x73, 0x9a, 0xe9, 0x0b, 0x17, 0x4c, 0x18, 0xa6, 0x53, 0xda, 0x86, 0x55, 0x1d, 0x90,
+    0xf4, 0xd3, 0xa9, 0x23, 0x56, 0x1f, 0x08, 0x3b, 0x20, 0x31, 0x01, 0x40, 0xf2, 0xf6, 0xe1, 0x25,
+    0x40, 0xe2, 0x4f, 0x5a, 0x2a, 0xc5, 0x48, 0x88, 0x12, 0x8d, 0x51, 0xa2, 0xbd, 0x91, 0x82, 0x8d,
+    0x50, 0x4a, 0xd8, 0x75, 0xa3, 0x33, 0x50, 0x0a, 0x2d, 0x15, 0xe7, 0x30, 0x42, 0xa7, 0xf4, 0x65,
+    0x50, 0x7a, 0xd2, 0x3c, 0x29, 0xa9, 0x02, 0x90, 0xbc, 0x2f, 0x03, 0xfb, 0xcd, 0x2f, 0xe9, 0xfe,
+    0x28, 0x41, 0x2a, 0xb8, 0xdf, 0xfc, 0xb1, 0x2c, 0x32, 0x4f, 0x19, 0x18, 0x89, 0x90, 0x49, 0x02,
+    0x86, 0xe7, 0xf2, 0x99, 0xf3, 0x03, 0xb3, 0xbd, 0xc7, 0x60, 0x65, 0x43, 0x9b, 0xcd, 0x74, 0x04,
+    0x8a, 0xd5, 0x7d, 0x11, 0x81, 0xe2, 0x10, 0x14, 0xa3, 0x13, 0x11, 0x41, 0xce, 0xfe, 0x0a, 0x41,
+    0x91, 0x14, 0x9c, 0x81, 0xc9, 0xc1, 0x40, 0xd1, 0xcc, 0x04, 0x8e, 0xdf, 0x5b, 0x3f, 0xe0, 0xf8,
+    0xbd, 0x43, 0xd9, 0xef, 0xf8, 0x35, 0x81, 0x8e, 0xcc, 0xaa, 0x04, 0x53, 0x72, 0xb6, 0x13, 0x09,
+    0x50, 0x21, 0x00, 0x13, 0xa9, 0x0f, 0x95, 0x2f, 0xd1, 0xaa, 0x6b, 0x88, 0x9b, 0xd4, 0x1f, 0x08,
+    0x1d, 0x05, 0xef, 0x73, 0xee, 0x5a, 0xc3, 0xd0, 0x91, 0xf3, 0xf4, 0xb9, 0xed, 0xe9, 0xa4, 0x2c,
+    0xad, 0x49, 0xd6, 0xc2, 0x02, 0x53, 0xd5, 0x24, 0xd9, 0x3e, 0x42, 0x9f, 0x82, 0xe5, 0x53, 0xf5,
+    0x47, 0x8c, 0x09, 0xdb, 0x8f, 0x89, 0x21, 0x24, 0x38, 0x77, 0x70, 0x1a, 0x9d, 0x3b, 0x08, 0xed,
+    0xf3, 0xe0, 0x06, 0x84, 0xd3, 0xaa, 0x36, 0xd3, 0x89, 0x33, 0xbf, 0xa6, 0x19, 0x98, 0x68, 0x90,
+    0xc0, 0x87, 0xc9, 0xd8, 0x03, 0x81, 0xc2, 0x55, 0x70, 0x6a, 0xb5, 0x36, 0x3a, 0xb5, 0x2a, 0xdb,
+    0xe7, 0xb1, 0x25, 0x85, 0xa7, 0x56, 0x69, 0x93, 0x09, 0x23, 0x63, 0x72, 0x40, 0x09, 0x33, 0x6b,
+    0x30, 0x43, 0xad, 0x0f, 0x04, 0x8a, 0x0e, 0xb3, 0x1e, 0x4a, 0x47, 0xd9, 0x21, 0xae, 0xfb, 0x1c,
+    0x74, 0xdc, 0x7d, 0xc5, 0x74, 0x32, 0xdb, 0x98, 0xb3, 0x79, 0x42, 0x0f, 0x0d, 0x93, 0xd3, 0x36,
+    0x09, 0x09, 0xe9, 0x40, 0x52, 0x4d, 0x16, 0x11, 0x22, 0x37, 0xfe, 0xd3, 0x62, 0xf9, 0xfb, 0xd7,
+    0x0e, 0x20, 0x74, 0x3f, 0x20, 0x96, 0x84, 0x79, 0x69, 0x26, 0xa3, 0xb4, 0xa2, 0x95, 0x7d, 0xce,
+    0x58, 0x49, 0x98, 0x56, 0x34, 0xe9, 0xbc, 0x34, 0xcb, 0xda, 0x3a, 0xc1, 0xa9, 0x5d, 0xc8, 0x9c,
+    0xaa, 0xe0, 0x73, 0x23, 0xd2, 0xad, 0x06, 0xba, 0xc7, 0x57, 0xb0, 0x82, 0xc1, 0xeb, 0xa2, 0xc6,
+    0x7e, 0x4f, 0xac, 0x41, 0x42, 0xda, 0x9d, 0xb6, 0x92, 0x15, 0x0c, 0x9e, 0xb3, 0x6d, 0x4c, 0x00,
+    0x88, 0x14, 0x90, 0x23, 0xf2, 0x10, 0x88, 0x74, 0x6b, 0x80, 0x9c, 0xd5, 0x5b, 0x39, 0x40, 0x44,
+    0xd4, 0x7d, 0x87, 0x3d, 0x6e, 0x18, 0xa4, 0x9e, 0x45, 0x6d, 0xa1, 0x13, 0xb5, 0x2e, 0x99, 0xe3,
+    0x88, 0xbb, 0x80, 0x28, 0x0e, 0xed, 0x88, 0x7d, 0x79, 0x40, 0x9c, 0xa1, 0xec, 0x98, 0x56, 0xde,
+    0x1c, 0x72, 0x03, 0x40, 0x64, 0x1d, 0x91, 0xee, 0xf7, 0xc1, 0x06, 0xe4, 0x98, 0x65, 0x49, 0x44,
+    0x8a, 0x22, 0x9a, 0x65, 0x00, 0x12, 0x9e, 0x19, 0x35, 0x03, 0x88, 0x48, 0x7a, 0x08, 0x44, 0x82,
+    0xb2, 0x1f, 0xaf, 0x53, 0xc1, 0x00, 0x11, 0xa1, 0x7b, 0x4b, 0xe8, 0x1c, 0x22, 0xc2, 0x75, 0xba,
+    0xbc, 0x65, 0x73, 0xe2, 0xfa, 0x2e, 0x22, 0x86, 0x02, 0x44, 0xa8, 0x38, 0x04, 0x22, 0x41, 0xc1,
+    0x8f, 0x97, 0x09, 0x40, 0x7a, 0x0b, 0xe7, 0x24, 0xc2, 0x23, 0xe9, 0x66, 0x72, 0x76, 0x8c, 0x0a,
+    0xe0, 0xb0, 0x30, 0x76, 0x55, 0x87, 0xd8, 0x32, 0x34, 0x28, 0xf3, 0x39, 0x93, 0xc8, 0x23, 0x1b,
+    0x62, 0x79, 0x9f, 0xe3, 0x55, 0x1a, 0xda, 0x90, 0x5d, 0xdb, 0x73, 0x18, 0x8d, 0xb0, 0x9c, 0x3d,
+    0x63, 0x82, 0xfa, 0xa7, 0xb5, 0x00, 0x12, 0x76, 0x88, 0x3d, 0x43, 0x55, 0x68, 0x56, 0x45, 0x84,
+    0x08, 0xed, 0x2d, 0x94, 0x0b, 0x08, 0x08, 0x49, 0x97, 0xa9, 0x72, 0xd2, 0x9a, 0x34, 0x70, 0x33,
+    0x94, 0x18, 0x70, 0x10, 0xd6, 0x07, 0x01, 0xa4, 0x5b, 0xba, 0xdb, 0x34, 0x50, 0x80, 0x52, 0xb0,
+    0xb5, 0xbd, 0x35, 0x72, 0x0a, 0x4b, 0xc1, 0xc6, 0xa6, 0x8f, 0x36, 0x59, 0xa9, 0xcb, 0xb0, 0xdf,
+    0x84, 0x6a, 0x80, 0x09, 0xe3, 0x87, 0x08, 0x59, 0x29, 0x0b, 0x0a, 0x75, 0xb6, 0x4e, 0x03, 0x80,
+    0x08, 0x4d, 0xe9, 0x3e, 0xef, 0x6b, 0xa2, 0x8e, 0x0a, 0xa9, 0x53, 0xd5, 0x27, 0x9d, 0x93, 0xa0,
+    0x0c, 0x6d, 0x09, 0x65, 0x30, 0x9f, 0x6b, 0x0e, 0x83, 0x49, 0x50, 0x91, 0x33, 0x51, 0x2b, 0xdb,
+    0x26, 0x90, 0xed, 0x29, 0x86, 0xcb, 0xa8, 0x2f, 0x29, 0x91, 0xb2, 0xb5, 0x39, 0x8d, 0x6c, 0x61,
+    0x84, 0x46, 0x39, 0x4c, 0xd9, 0x0a, 0xf1, 0x8c, 0x90, 0xec, 0xcd, 0x95, 0x50, 0x4e, 0xfe, 0x62,
+    0x13, 0x9b, 0x62, 0x7b, 0x9b, 0xd8, 0xba, 0x25, 0xca, 0x9c, 0xd2, 0x5b, 0x50, 0xf4, 0xa6, 0x02,
+    0xe6, 0x67, 0xa9, 0x79, 0xf6, 0x46, 0xad, 0x1e, 0x5c, 0x44, 0x98, 0x1b, 0x30, 0x71, 0x6e, 0x40,
+    0xd2, 0x5e, 0x4f, 0x6c, 0x61, 0x4d, 0x52, 0xa4, 0x4a, 0x6d, 0x3c, 0xa7, 0x74, 0x1b, 0x1c, 0xf8,
+    0xa8, 0xe4, 0xb0, 0x78, 0xc4, 0x0f, 0x09, 0x4c, 0x50, 0x55, 0x13, 0x30, 0x40, 0x61, 0x0a, 0x06,
+    0x28, 0xa0, 0x7f, 0x4d, 0xc1, 0x94, 0x49, 0x82, 0x2d, 0x59, 0xaf, 0x20, 0x81, 0x7e, 0x47, 0xc5,
+    0x32, 0x4a, 0x6a, 0x2f, 0x86, 0x8a, 0x08, 0x6a, 0x67, 0x3c, 0x7a, 0x3b, 0xcb, 0xf7, 0xcd, 0xea,
+    0xde, 0x12, 0x36, 0x87, 0xe9, 0x35, 0x91, 0xc8, 0xc3, 0x4a, 0xfd, 0xa3, 0xbd, 0x23, 0x54, 0xc3,
+    0x96, 0x08, 0x7a, 0xa0, 0x34, 0xac, 0xdb, 0xc0, 0x26, 0xc0, 0x44, 0x44, 0x90, 0xf4, 0xd7, 0xaa,
+    0x09, 0x44, 0x84, 0x24, 0x0a, 0x3f, 0x22, 0x87, 0x29, 0xb6, 0xaf, 0x69, 0x58, 0xd4, 0xe7, 0xf2,
+    0x03, 0x41, 0x62, 0xc2, 0x2c, 0x2c, 0x8f, 0xb3, 0xb0, 0x84, 0xf7, 0x76, 0xad, 0x69, 0x58, 0x92,
+    0xb6, 0x89, 0xfd, 0x63, 0xb3, 0x7a, 0xd6, 0x58, 0x5f, 0xbf, 0xb0, 0x48, 0xb6, 0x62, 0xbd, 0x0c,
+    0x2a, 0x32, 0x28, 0x7f, 0xb9, 0x60, 0x41, 0x45, 0xa8, 0x70, 0xd5, 0x5b, 0x78, 0x8e, 0xda, 0x1a,
+    0x58, 0x22, 0x5f, 0x9f, 0xb3, 0x77, 0x68, 0x6f, 0xb3, 0xb0, 0x6c, 0xda, 0x43, 0x5e, 0xbe, 0xfa,
+    0x15, 0x55, 0x9b, 0xa9, 0x94, 0xa1, 0xd9, 0xe5, 0x36, 0xb2, 0xbb, 0xc4, 0xf6, 0x56, 0x9b, 0x29,
+    0xc4, 0xc8, 0x26, 0x9a, 0x19, 0x58, 0x4e, 0x47, 0xb5, 0x95, 0x7d, 0x6d, 0xc3, 0x32, 0x99, 0x3a,
+    0x78, 0x0e, 0x90, 0xd4, 0x53, 0x0d, 0x32, 0x54, 0x06, 0xe5, 0x30, 0x67, 0x43, 0x4d, 0xdc, 0x49,
+    0xd4, 0x5b, 0x6e, 0x06, 0x6d, 0xc4, 0xb4, 0xe9, 0xf5, 0x8d, 0xfc, 0x53, 0x56, 0x73, 0xb5, 0xea,
+    0x6b, 0x22, 0x56, 0x49, 0xff, 0xf4, 0x1c, 0x3d, 0x7c, 0xe6, 0x89, 0x6a, 0xb3, 0xf3, 0x94, 0x7f,
+    0xb5, 0x2f, 0x4d, 0xee, 0xed, 0x4b, 0x03, 0xe7, 0xa5, 0x9c, 0x66, 0x6b, 0x29, 0xfa, 0x7b, 0x8a,
+    0xe5, 0xa1, 0x1a, 0xd3, 0xa2, 0x92, 0x33, 0x55, 0x41, 0xd1, 0xcc, 0x44, 0x8d, 0x69, 0xbe, 0x9f,
+    0xb6, 0xb7, 0x31, 0x0d, 0x36, 0x19, 0x93, 0xb6, 0x31, 0x0d, 0x14, 0x88, 0x64, 0xce, 0x1b, 0x1e,
+    0xb6, 0xbf, 0xcb, 0xd8, 0xea, 0x17, 0x83, 0xea, 0xc9, 0x46, 0x63, 0xaa, 0xc9, 0x0f, 0x37, 0x1a,
+    0x03, 0x7f, 0x9f, 0xdb, 0x68, 0x6c, 0x73, 0xfa, 0xd3, 0xc2, 0xc3, 0x04, 0x6c, 0x34, 0xd6, 0x75,
+    0x9a, 0xf0, 0x85, 0xb0, 0x4a, 0x59, 0xa9, 0xfa, 0xf5, 0xaa, 0xdb, 0xc9, 0x34, 0x7a, 0xbb, 0x6a,
+    0xd3, 0x77, 0x9c, 0xfd, 0xfe, 0xff, 0xc3, 0x7c, 0x1e, 0x8c, 0x6c, 0x9e, 0xdd, 0x7f, 0xda, 0x0e,
+    0x15, 0x7c, 0xf7, 0xe1, 0xc7, 0xc7, 0xbb, 0x89, 0x1f, 0x4c, 0xea, 0x38, 0x61, 0xb9, 0x7e, 0x78,
+    0x98, 0x2c, 0xdc, 0x14, 0x06, 0xa3, 0x3f, 0x1f, 0xab, 0x9b, 0x55, 0x31, 0x29, 0x6e, 0x27, 0x5f,
+    0x8b, 0xf9, 0xa7, 0xe2, 0x71, 0xb2, 0x58, 0xdd, 0x7f, 0x6d, 0xbc, 0xf6, 0xd7, 0xe2, 0x8f, 0xe9,
+    0xea, 0xae, 0x00, 0x5d, 0x52, 0xcd, 0xc2, 0xba, 0x99, 0x4f, 0xbe, 0xd6, 0xeb, 0xeb, 0x7f, 0x80,
+    0x7f, 0x48, 0x56, 0x3f, 0xf0, 0xc3, 0xe4, 0xcf, 0x26, 0xf7, 0x72, 0x34, 0x98, 0x79, 0x13, 0x55,
+    0xaf, 0x9f, 0xb3, 0x78, 0xd5, 0x97, 0xc6, 0xea, 0x5a, 0x3f, 0x9d, 0x45, 0x33, 0xdc, 0x7e, 0x0f,
+    0x99, 0xb1, 0xbd, 0x67, 0x9d, 0xa3, 0xdf, 0x5e, 0x5d, 0xff, 0xa7, 0xb9, 0xda, 0xfa, 0x38, 0x71,
+    0x73, 0x35, 0xf5, 0xef, 0x56, 0xf7, 0xe5, 0x83, 0x23, 0xd3, 0xc4, 0xa0, 0x8b, 0x0f, 0x33, 0x11,
+    0x20, 0xad, 0x69, 0xcb, 0x97, 0x68, 0xc4, 0x6b, 0xe8, 0xb1, 0x6b, 0x18, 0x94, 0x81, 0x47, 0xdb,
+    0xd4, 0x33, 0xe8, 0x96, 0x35, 0x02, 0xbc, 0x17, 0xbe, 0x4d, 0xf8, 0x75, 0x28, 0xe2, 0x2b, 0x92,
+    0x4c, 0x12, 0x40, 0x11, 0xca, 0x95, 0xf2, 0x37, 0xec, 0x52, 0xc4, 0x57, 0xfe, 0xad, 0x88, 0x28,
+    0x42, 0x79, 0x73, 0x39, 0xa0, 0x88, 0xfa, 0x41, 0x8a, 0x04, 0xde, 0x28, 0x20, 0x88, 0x5b, 0x34,
+    0xb5, 0x25, 0x08, 0xad, 0xd7, 0xaf, 0x26, 0x48, 0xed, 0x9d, 0xda, 0x25, 0x66, 0x2d, 0x41, 0x64,
+    0x67, 0x89, 0xe5, 0x1e, 0x82, 0xd4, 0x8c, 0x6a, 0xaf, 0xde, 0xd1, 0xcb, 0xf8, 0x43, 0xe8, 0xe6,
+    0x6a, 0xe6, 0xdf, 0x8c, 0xcc, 0x97, 0xc1, 0xf0, 0xbe, 0x0b, 0x12, 0x24, 0x6c, 0xd5, 0x24, 0x14,
+    0x14, 0x13, 0xed, 0x33, 0xbb, 0xed, 0x6e, 0x5d, 0x6f, 0x4b, 0x8b, 0x6e, 0x51, 0xa7, 0x61, 0x85,
+    0x04, 0xaf, 0x72, 0xba, 0xdf, 0x22, 0x62, 0x05, 0x55, 0xa6, 0x7e, 0x2b, 0xb7, 0xcb, 0x0a, 0xc6,
+    0xb8, 0xb3, 0x1c, 0x90, 0x15, 0x6e, 0xa4, 0x89, 0x58, 0xc1, 0x18, 0x4b, 0x18, 0x0e, 0xf2, 0x83,
+    0xa4, 0x08, 0x32, 0x50, 0x90, 0x14, 0xac, 0x25, 0x85, 0x6e, 0x49, 0x21, 0xba, 0xcb, 0x6a, 0x5a,
+    0x52, 0xd0, 0xce, 0xb2, 0xd2, 0xbd, 0xa4, 0xe8, 0xd8, 0x1c, 0xde, 0x52, 0xca, 0xf8, 0x73, 0xf0,
+    0xee, 0x6a, 0x05, 0x49, 0xc1, 0xfb, 0x1a, 0x7d, 0x4d, 0xa9, 0x42, 0x52, 0xc8, 0xb0, 0x7c, 0xc8,
+    0x28, 0x03, 0xa4, 0xd0, 0xcf, 0x9e, 0xbf, 0xdc, 0x65, 0xce, 0xe8, 0x96, 0x16, 0x3b, 0x52, 0x84,
+    0xaf, 0x80, 0x33, 0xd3, 0x2c, 0x65, 0xc0, 0x04, 0x26, 0x65, 0x2d, 0xd7, 0xd0, 0x65, 0x02, 0x27,
+    0x96, 0xdb, 0xc8, 0x3e, 0x30, 0x69, 0x58, 0xc4, 0x04, 0x4e, 0x69, 0xc2, 0x3e, 0x78, 0x0f, 0xd4,
+    0xfd, 0xe5, 0x5b, 0x18, 0x7e, 0x88, 0x1a, 0xdd, 0xc4, 0x7e, 0xc8, 0x0c, 0xe3, 0x97, 0xbd, 0x61,
+    0x06, 0xab, 0x17, 0x6e, 0xc3, 0x0c, 0xd2, 0x5d, 0x5b, 0xb1, 0x5d, 0x5b, 0x15, 0x6c, 0x78, 0xbd,
+    0x87, 0x19, 0x81, 0xb1, 0xe1, 0x5d, 0x5e, 0xb5, 0xde, 0xa8, 0xd6, 0x0f, 0x08, 0x99, 0x21, 0xfa,
+    0x4e, 0x96, 0xf5, 0x3c, 0x43, 0x66, 0x84, 0x81, 0x06, 0xe3, 0x80, 0x19, 0xcf, 0x5d, 0x69, 0xdf,
+    0x15, 0x34, 0x45, 0xc4, 0x8b, 0xf0, 0xd5, 0x7b, 0xae, 0x9b, 0xe2, 0x6a, 0xc0, 0x0b, 0x2e, 0x68,
+    0xad, 0x03, 0x10, 0xf0, 0xc2, 0xca, 0x5a, 0x43, 0x20, 0xe4, 0x05, 0xdf, 0xb4, 0xcf, 0x07, 0xbc,
+    0x10, 0x84, 0xa6, 0x2c, 0x84, 0x0e, 0x79, 0xf1, 0xa3, 0x6e, 0x04, 0xa6, 0x0c, 0x20, 0x35, 0x44,
+    0x4b, 0x0d, 0xbb, 0xa1, 0x46, 0xe3, 0x5f, 0xb6, 0x8b, 0x2b, 0xda, 0x60, 0x41, 0x75, 0xb6, 0x3d,
+    0x77, 0x47, 0x9f, 0x7d, 0xd4, 0x10, 0xdd, 0xab, 0x45, 0xca, 0x0f, 0x71, 0x6f, 0x71, 0x43, 0x6a,
+    0xc8, 0x9e, 0xca, 0x22, 0xb5, 0x25, 0x81, 0xd4, 0x50, 0x7d, 0xf1, 0x7a, 0x6d, 0xa0, 0x9e, 0xbf,
+    0xf9, 0xaf, 0x93, 0xed, 0x08, 0xe8, 0xa1, 0xca, 0x50, 0x59, 0x40, 0x28, 0xaa, 0x22, 0x7a, 0x08,
+    0x66, 0x18, 0x8c, 0x3c, 0x85, 0x71, 0xe6, 0x2e, 0x32, 0x1b, 0x82, 0xeb, 0x38, 0xf2, 0x14, 0x96,
+    0x24, 0xcc, 0x06, 0x0d, 0xd9, 0xe1, 0xcf, 0x92, 0x3f, 0x44, 0x0f, 0x18, 0x75, 0x43, 0x7a, 0xec,
+    0x22, 0x51, 0xbe, 0x8b, 0x44, 0x1b, 0x4f, 0xd3, 0x2e, 0xf0, 0x2e, 0x54, 0x90, 0xc1, 0xde, 0xb7,
+    0x7b, 0xe9, 0xd1, 0xb1, 0x3b, 0xb2, 0x25, 0x57, 0xd7, 0x23, 0x89, 0x38, 0x12, 0xed, 0xed, 0x21,
+    0xb5, 0x30, 0x12, 0xad, 0xa7, 0xd2, 0x3d, 0xa2, 0xc0, 0xae, 0x25, 0xfa, 0xfc, 0x27, 0x94, 0x5d,
+    0xac, 0x41, 0x76, 0xb1, 0x86, 0xd8, 0xf1, 0x43, 0x6d, 0x63, 0x0d, 0x0a, 0xa5, 0x89, 0xea, 0x57,
+    0x1d, 0x20, 0x57, 0x24, 0x6d, 0x24, 0x4a, 0xba, 0x5c, 0x91, 0xca, 0x08, 0x1b, 0x99, 0x12, 0xc9,
+    0x54, 0x1c, 0x82, 0x4a, 0x43, 0x12, 0xa6, 0x84, 0x32, 0x1b, 0xfc, 0xfa, 0x41, 0xaa, 0x24, 0x92,
+    0xf7, 0x21, 0x5b, 0x74, 0x1b, 0x96, 0x8a, 0x5d, 0x58, 0xda, 0x78, 0x9f, 0x76, 0xbd, 0x59, 0xcb,
+    0x16, 0xd9, 0x59, 0xef, 0x3d, 0x61, 0x69, 0x68, 0x8a, 0x64, 0xcb, 0xb5, 0xae, 0x97, 0x92, 0x71,
+    0x58, 0xaa, 0xfb, 0xdf, 0x8a, 0x04, 0x61, 0xa9, 0x0a, 0xdb, 0xab, 0x99, 0x8c, 0xda, 0xfe, 0x5e,
+    0x48, 0xc5, 0xa0, 0xfb, 0x1e, 0x0a, 0x30, 0x28, 0xa1, 0x34, 0x8b, 0xe2, 0x22, 0x8e, 0x48, 0x95,
+    0x3b, 0xbe, 0xc0, 0x88, 0x54, 0x39, 0x3a, 0xc9, 0xc8, 0xa0, 0x28, 0x2a, 0xe3, 0x88, 0x54, 0x29,
+    0x9b, 0x32, 0x28, 0x2a, 0x24, 0x09, 0x7f, 0xb6, 0x30, 0x44, 0xb7, 0x01, 0xaa, 0xd8, 0x05, 0xa8,
+    0x8d, 0x07, 0x6a, 0x17, 0xd8, 0xb4, 0xf4, 0xa0, 0x9d, 0x05, 0xa6, 0x7b, 0xe9, 0xd1, 0x31, 0x45,
+    0xaa, 0x25, 0x57, 0xd7, 0x53, 0xc9, 0x38, 0x40, 0x35, 0x7d, 0x55, 0x33, 0x0b, 0x03, 0xd4, 0x26,
+    0x4d, 0xd6, 0x79, 0x11, 0x36, 0x6a, 0x94, 0x7d, 0xa1, 0x30, 0xc4, 0xcf, 0x0c, 0xd0, 0x82, 0x34,
+    0xd9, 0x8e, 0xc9, 0x7d, 0xb5, 0x58, 0x2d, 0x9b, 0x74, 0xc7, 0xb2, 0xf2, 0xe7, 0xe2, 0x8f, 0xb3,
+    0xc9, 0x83, 0xd7, 0x4c, 0x1c, 0x5f, 0x5f, 0x16, 0x1b, 0xbd, 0xc4, 0xe2, 0xf4, 0x6c, 0x50, 0x03,
+    0xe2, 0x1f, 0x6b, 0x70, 0xe9, 0xfe, 0xb1, 0xa8, 0x8a, 0xee, 0x19, 0xbb, 0xb8, 0x9e, 0xac, 0x6e,
+    0xee, 0xdc, 0x98, 0xe5, 0xca, 0x2d, 0x64, 0xa8, 0xbc, 0xe2, 0x6e, 0x1a, 0xaa, 0x01, 0x84, 0xb3,
+    0xbf, 0x1c, 0xfd, 0x3c, 0xba, 0x18, 0x15, 0x57, 0x6f, 0x3e, 0x8c, 0x4f, 0x46, 0x17, 0x97, 0x57,
+    0xe7, 0x17, 0xef, 0x8a, 0xeb, 0xe1, 0xd5, 0xf1, 0x9b, 0x42, 0x52, 0x56, 0x5c, 0x8c, 0xde, 0x0d,
+    0x4f, 0xc7, 0x97, 0xc5, 0xcf, 0xc3, 0xb3, 0xd3, 0x93, 0xe2, 0xc3, 0xf8, 0xea, 0xf4, 0xac, 0xb0,
+    0xc5, 0xfb, 0x77, 0xc5, 0xf1, 0xc9, 0x95, 0xbb, 0xe6, 0xf4, 0xb2, 0x70, 0x97, 0x8f, 0x4f, 0xc7,
+    0xaf, 0x8b, 0x7f, 0x9d, 0x5f, 0xb8, 0x0f, 0x46, 0xee, 0xef, 0xb3, 0xb3, 0xf3, 0x6b, 0xff, 0xc9,
+    0xf0, 0x62, 0x34, 0xbc, 0xfc, 0x75, 0xf6, 0xeb, 0xec, 0x74, 0xec, 0x1e, 0xe0, 0xec, 0x74, 0x7c,
+    0xee, 0x86, 0xd7, 0xd7, 0x34, 0xf7, 0x3f, 0x1d, 0x1f, 0x9f, 0x7d, 0x38, 0x19, 0x5d, 0x16, 0xa6,
+    0x38, 0x3e, 0xf7, 0xb7, 0x1e, 0x6d, 0x47, 0x8f, 0xcf, 0x2f, 0xdc, 0xad, 0x86, 0x97, 0x57, 0xbb,
+    0xeb, 0xfc, 0x17, 0xc7, 0xe7, 0xe7, 0x6f, 0x8b, 0x93, 0x0f, 0xef, 0x87, 0xaf, 0x47, 0xc5, 0xdb,
+    0xe1, 0xd8, 0xfd, 0x31, 0x1a, 0x9f, 0x0c, 0xcf, 0xce, 0x8a, 0xb3, 0xe1, 0xdb, 0x51, 0xf1, 0xee,
+    0xf8, 0xcd, 0x68, 0x7c, 0xf1, 0x9f, 0xe2, 0xda, 0x5d, 0xd2, 0xbd, 0x4d, 0x71, 0x3c, 0x1a, 0x5f,
+    0x5d, 0x0c, 0xcf, 0x82, 0x5b, 0x9d, 0x8c, 0xde, 0x0e, 0xcf, 0xfe, 0xe9, 0xff, 0x55, 0xcf, 0x67,
+    0x37, 0x13, 0xff, 0x00, 0xc7, 0xa7, 0x7e, 0x26, 0xc5, 0xf9, 0xbf, 0x8a, 0xe1, 0x87, 0x8b, 0xf3,
+    0x8b, 0xe1, 0x51, 0x71, 0xfc, 0xe6, 0xf4, 0x78, 0xf8, 0xfa, 0xfc, 0xa8, 0x68, 0x2e, 0x3b, 0x2a,
+    0x46, 0x67, 0xaf, 0x4f, 0xc7, 0x47, 0xc5, 0xbf, 0xcf, 0xcf, 0x4e, 0x47, 0x57, 0x47, 0xc5, 0x78,
+    0xf8, 0x7e, 0x74, 0xf1, 0xb3, 0xbb, 0xff, 0xe8, 0xa8, 0x38, 0xbf, 0xbc, 0x1e, 0xf9, 0xa1, 0xd7,
+    0xc3, 0x0f, 0x6f, 0x47, 0xaf, 0x87, 0x6e, 0xd4, 0xb5, 0x7b, 0x92, 0xab, 0xf3, 0x71, 0x31, 0x1c,
+    0x9f, 0x14, 0xd7, 0xe7, 0xe7, 0x27, 0x0e, 0xe2, 0xe3, 0xb7, 0xa5, 0xdf, 0x54, 0x93, 0xcf, 0x7e,
+    0xe1, 0x61, 0xb2, 0xe4, 0xda, 0x11, 0xd2, 0xfd, 0xf5, 0x66, 0x32, 0xbd, 0x1f, 0xfc, 0x56, 0xdb,
+    0x8e, 0x4c, 0x5e, 0xbc, 0x71, 0xcc, 0x2d, 0x86, 0xb7, 0x5f, 0xa6, 0xcb, 0xf9, 0xe2, 0x6b, 0x97,
+    0x0b, 0x3e, 0x03, 0xd6, 0xf4, 0xab, 0xb7, 0x5c, 0xd8, 0xbc, 0x24, 0x1b, 0x72, 0xe1, 0x6f, 0x6e,
+    0xb2, 0xc3, 0xab, 0xb2, 0x2c, 0xeb, 0x5b, 0xb9, 0x79, 0x54, 0x7f, 0x16, 0x5f, 0x26, 0xf7, 0xeb,
+    0x6a, 0x59, 0xac, 0x1f, 0x8b, 0xd5, 0xbc, 0xa0, 0x44, 0x16, 0x55, 0x6d, 0x3a, 0xaa, 0xdb, 0xd2,
+    0xc3, 0xe7, 0xaf, 0x70, 0xf4, 0x71, 0x97, 0x1c, 0xcf, 0xe7, 0xbf, 0x17, 0x93, 0xd9, 0x6d, 0x71,
+    0xb2, 0x7e, 0x3f, 0xf9, 0x5c, 0x15, 0xc7, 0xf3, 0xf5, 0x6c, 0x35, 0xad, 0x96, 0xed, 0xb0, 0xb1,
+    0x1b, 0xf5, 0xc1, 0x7d, 0x76, 0x5f, 0xe8, 0x2d, 0x83, 0x56, 0x77, 0xd3, 0x65, 0xe1, 0xe7, 0x3f,
+    0x9d, 0x7d, 0xde, 0x0c, 0x3c, 0x7d, 0xf7, 0x7e, 0x78, 0x7c, 0x75, 0xe9, 0x27, 0x31, 0x5f, 0x15,
+    0xde, 0xf0, 0x78, 0x57, 0xed, 0xf6, 0xfb, 0xb2, 0xbe, 0xfb, 0x9d, 0x33, 0x11, 0xc5, 0x76, 0xcb,
+    0x17, 0x0f, 0xce, 0x7a, 0xdd, 0x4c, 0xd6, 0xcb, 0xaa, 0xb8, 0xab, 0x67, 0x7c, 0x7f, 0x3f, 0x73,
+    0xc6, 0xc1, 0x0d, 0x75, 0x73, 0x9d, 0xdf, 0xdc, 0xac, 0x17, 0x5d, 0x9c, 0x47, 0x7f, 0xae, 0x16,
+    0xd5, 0x43, 0xd5, 0xdc, 0xa2, 0x73, 0x63, 0x87, 0xf2, 0x4f, 0xbf, 0x7d, 0xff, 0x86, 0x42, 0xa6,
+    0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28,
+    0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64,
+    0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a,
+    0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42,
+    0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6,
+    0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28,
+    0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64,
+    0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a,
+    0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42,
+    0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6,
+    0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28,
+    0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64,
+    0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a,
+    0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42,
+    0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6,
+    0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28,
+    0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64,
+    0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a,
+    0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42,
+    0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6,
+    0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28,
+    0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64,
+    0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a,
+    0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42,
+    0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6,
+    0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28, 0x64, 0x8a, 0x42, 0xa6, 0x28,
+    0x64, 0xfa, 0x97, 0x85, 0x4c, 0xff, 0x0f, 0xb0, 0x89, 0xe4, 0xb1, 0x5b, 0xfe, 0x00, 0x00,
+};
+
+static const uint8_t headerGzip[] = {
+    0x1f, 0x8b, 0x08, 0x1e, 0xf2, 0x25, 0x85, 0x66, 0x02, 0x03, 0x08, 0x00, 0x41, 0x50, 0x04, 0x00,
+    0x74, 0x65, 0x73, 0x74, 0x63, 0x75, 0x72, 0x72, 0x65, 0x6e, 0x74, 0x2e, 0x6a, 0x73, 0x6f, 0x6e,
+    0x00, 0x65, 0x78, 0x74, 0x72, 0x61, 0x2c, 0x20, 0x6e, 0x61, 0x6d, 0x65, 0x2c, 0x20, 0x63, 0x6f,
+    0x6d, 0x6d, 0x65, 0x6e, 0x74, 0x20, 0x61, 0x6e, 0x64, 0x20, 0x68, 0x65, 0x61, 0x64, 0x65, 0x72,
+    0x20, 0x43, 0x52, 0x43, 0x00, 0x48, 0x52, 0xab, 0x56, 0xca, 0x49, 0x2c, 0x51, 0xb2, 0x32, 0x31,
+    0xd4, 0xb3, 0x30, 0xd5, 0x51, 0xca, 0xc9, 0xcf, 0x53, 0xb2, 0xd2, 0xb5, 0x30, 0xd7, 0x33, 0x03,
+    0x72, 0x92, 0x4b, 0x8b, 0x8a, 0x52, 0xf3, 0x80, 0x92, 0xd5, 0x4a, 0x29, 0x40, 0xd2, 0xd0, 0xdc,
+    0xc8, 0xc0, 0xc0, 0xc0, 0xc8, 0xc0, 0xd8, 0xa4, 0xb6, 0x16, 0x00, 0xaa, 0x91, 0xf0, 0xed, 0x36,
+    0x00, 0x00, 0x00,
+};
+
+#endif  // GZIP_FIXTURE_H
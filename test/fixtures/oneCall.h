@@ -0,0 +1,138 @@
+#ifndef ONECALL_FIXTURE_H
+#define ONECALL_FIXTURE_H
+
+// A full OneCall 3.0 response (current, 61 minutely, 48 hourly, 8 daily, 2 alerts) for Chicago
+// on a stormy July day. Values are made up, shape and field order are the API's. Lines are the
+// API's minified JSON split between array entries, the newlines are whitespace to the parser.
+
+static const char oneCallFixture[] = R"json({"lat":41.85,"lon":-87.65,"timezone":"America/Chicago","timezone_offset":-18000,
+"current":{"dt":1720002034,"sunrise":1719996060,"sunset":1720050300,"temp":29.87,"feels_like":32.1,"pressure":1012,"humidity":58,"dew_point":20.83,"uvi":7.41,"clouds":40,"visibility":10000,"wind_speed":4.12,"wind_deg":200,"wind_gust":7.2,"weather":[{"id":802,"main":"Clouds","description":"scattered clouds","icon":"03d"}]},
+"minutely":[
+{"dt":1720002000,"precipitation":0},
+{"dt":1720002060,"precipitation":0},
+{"dt":1720002120,"precipitation":0},
+{"dt":1720002180,"precipitation":0},
+{"dt":1720002240,"precipitation":0},
+{"dt":1720002300,"precipitation":0},
+{"dt":1720002360,"precipitation":0},
+{"dt":1720002420,"precipitation":0},
+{"dt":1720002480,"precipitation":0},
+{"dt":1720002540,"precipitation":0},
+{"dt":1720002600,"precipitation":0},
+{"dt":1720002660,"precipitation":0},
+{"dt":1720002720,"precipitation":0},
+{"dt":1720002780,"precipitation":0},
+{"dt":1720002840,"precipitation":0},
+{"dt":1720002900,"precipitation":0},
+{"dt":1720002960,"precipitation":0},
+{"dt":1720003020,"precipitation":0.4},
+{"dt":1720003080,"precipitation":0.6},
+{"dt":1720003140,"precipitation":0.8},
+{"dt":1720003200,"precipitation":1.0},
+{"dt":1720003260,"precipitation":1.19},
+{"dt":1720003320,"precipitation":1.38},
+{"dt":1720003380,"precipitation":1.56},
+{"dt":1720003440,"precipitation":1.74},
+{"dt":1720003500,"precipitation":1.91},
+{"dt":1720003560,"precipitation":2.08},
+{"dt":1720003620,"precipitation":2.23},
+{"dt":1720003680,"precipitation":2.38},
+{"dt":1720003740,"precipitation":2.52},
+{"dt":1720003800,"precipitation":2.64},
+{"dt":1720003860,"precipitation":2.76},
+{"dt":1720003920,"precipitation":2.86},
+{"dt":1720003980,"precipitation":2.95},
+{"dt":1720004040,"precipitation":3.02},
+{"dt":1720004100,"precipitation":3.09},
+{"dt":1720004160,"precipitation":3.14},
+{"dt":1720004220,"precipitation":3.17},
+{"dt":1720004280,"precipitation":3.19},
+{"dt":1720004340,"precipitation":3.2},
+{"dt":1720004400,"precipitation":3.19},
+{"dt":1720004460,"precipitation":3.17},
+{"dt":1720004520,"precipitation":3.14},
+{"dt":1720004580,"precipitation":3.09},
+{"dt":1720004640,"precipitation":3.02},
+{"dt":1720004700,"precipitation":2.95},
+{"dt":1720004760,"precipitation":2.86},
+{"dt":1720004820,"precipitation":2.76},
+{"dt":1720004880,"precipitation":2.64},
+{"dt":1720004940,"precipitation":2.52},
+{"dt":1720005000,"precipitation":2.38},
+{"dt":1720005060,"precipitation":2.23},
+{"dt":1720005120,"precipitation":2.08},
+{"dt":1720005180,"precipitation":1.91},
+{"dt":1720005240,"precipitation":1.74},
+{"dt":1720005300,"precipitation":1.56},
+{"dt":1720005360,"precipitation":1.38},
+{"dt":1720005420,"precipitation":1.19},
+{"dt":1720005480,"precipitation":1.0},
+{"dt":1720005540,"precipitation":0.8},
+{"dt":1720005600,"precipitation":0.6}
+],
+"hourly":[
+{"dt":1720000800,"temp":25.55,"feels_like":27.25,"pressure":1012,"humidity":50,"dew_point":17.15,"uvi":6.25,"clouds":0,"visibility":10000,"wind_speed":3.0,"wind_deg":180,"wind_gust":8.0,"weather":[{"id":802,"main":"Clouds","description":"scattered clouds","icon":"03d"}],"pop":0},
+{"dt":1720004400,"temp":27.13,"feels_like":28.83,"pressure":1011,"humidity":57,"dew_point":18.73,"uvi":7.21,"clouds":17,"visibility":10000,"wind_speed":3.26,"wind_deg":189,"wind_gust":7.94,"weather":[{"id":802,"main":"Clouds","description":"scattered clouds","icon":"03d"}],"pop":0},
+{"dt":1720008000,"temp":28.5,"feels_like":30.2,"pressure":1010,"humidity":64,"dew_point":20.1,"uvi":7.8,"clouds":34,"visibility":10000,"wind_speed":3.51,"wind_deg":198,"wind_gust":7.76,"weather":[{"id":802,"main":"Clouds","description":"scattered clouds","icon":"03d"}],"pop":0},
+{"dt":1720011600,"temp":29.59,"feels_like":31.29,"pressure":1009,"humidity":71,"dew_point":21.19,"uvi":8.0,"clouds":51,"visibility":10000,"wind_speed":3.73,"wind_deg":207,"wind_gust":7.46,"weather":[{"id":803,"main":"Clouds","description":"broken clouds","icon":"04d"}],"pop":0},
+{"dt":1720015200,"temp":30.32,"feels_like":32.02,"pressure":1008,"humidity":78,"dew_point":21.92,"uvi":7.8,"clouds":68,"visibility":10000,"wind_speed":3.93,"wind_deg":216,"wind_gust":7.08,"weather":[{"id":803,"main":"Clouds","description":"broken clouds","icon":"04d"}],"pop":0},
+{"dt":1720018800,"temp":30.65,"feels_like":32.35,"pressure":1007,"humidity":85,"dew_point":22.25,"uvi":7.21,"clouds":85,"visibility":10000,"wind_speed":4.09,"wind_deg":225,"wind_gust":6.63,"weather":[{"id":803,"main":"Clouds","description":"broken clouds","icon":"04d"}],"pop":0},
+{"dt":1720022400,"temp":30.58,"feels_like":32.28,"pressure":1006,"humidity":52,"dew_point":22.18,"uvi":6.25,"clouds":1,"visibility":10000,"wind_speed":4.21,"wind_deg":234,"wind_gust":6.14,"weather":[{"id":500,"main":"Rain","description":"light rain","icon":"10d"}],"pop":0.35,"rain":{"1h":1.1}},
+{"dt":1720026000,"temp":30.11,"feels_like":31.81,"pressure":1012,"humidity":59,"dew_point":21.71,"uvi":4.99,"clouds":18,"visibility":10000,"wind_speed":4.28,"wind_deg":243,"wind_gust":5.64,"weather":[{"id":500,"main":"Rain","description":"light rain","icon":"10d"}],"pop":0.5,"rain":{"1h":1.5}},
+{"dt":1720029600,"temp":29.28,"feels_like":30.98,"pressure":1011,"humidity":66,"dew_point":20.88,"uvi":3.47,"clouds":35,"visibility":10000,"wind_speed":4.3,"wind_deg":252,"wind_gust":5.17,"weather":[{"id":500,"main":"Rain","description":"light rain","icon":"10d"}],"pop":0.65,"rain":{"1h":0.3}},
+{"dt":1720033200,"temp":28.17,"feels_like":29.87,"pressure":1010,"humidity":73,"dew_point":19.77,"uvi":1.78,"clouds":52,"visibility":10000,"wind_speed":4.27,"wind_deg":261,"wind_gust":4.74,"weather":[{"id":501,"main":"Rain","description":"moderate rain","icon":"10d"}],"pop":0.8,"rain":{"1h":0.7}},
+{"dt":1720036800,"temp":26.85,"feels_like":28.55,"pressure":1009,"humidity":80,"dew_point":18.45,"uvi":0.0,"clouds":69,"visibility":10000,"wind_speed":4.18,"wind_deg":270,"wind_gust":4.4,"weather":[{"id":501,"main":"Rain","description":"moderate rain","icon":"10d"}],"pop":0.2,"rain":{"1h":1.1}},
+{"dt":1720040400,"temp":25.43,"feels_like":27.13,"pressure":1008,"humidity":87,"dew_point":17.03,"uvi":0,"clouds":86,"visibility":10000,"wind_speed":4.05,"wind_deg":279,"wind_gust":4.15,"weather":[{"id":501,"main":"Rain","description":"moderate rain","icon":"10n"}],"pop":0.35,"rain":{"1h":1.5}},
+{"dt":1720044000,"temp":24.01,"feels_like":25.71,"pressure":1007,"humidity":54,"dew_point":15.61,"uvi":0,"clouds":2,"visibility":10000,"wind_speed":3.88,"wind_deg":288,"wind_gust":4.02,"weather":[{"id":211,"main":"Thunderstorm","description":"thunderstorm","icon":"11n"}],"pop":0.5,"rain":{"1h":0.3}},
+{"dt":1720047600,"temp":22.69,"feels_like":24.39,"pressure":1006,"humidity":61,"dew_point":14.29,"uvi":0,"clouds":19,"visibility":10000,"wind_speed":3.67,"wind_deg":297,"wind_gust":4.01,"weather":[{"id":211,"main":"Thunderstorm","description":"thunderstorm","icon":"11n"}],"pop":0.65,"rain":{"1h":0.7}},
+{"dt":1720051200,"temp":21.58,"feels_like":23.28,"pressure":1012,"humidity":68,"dew_point":13.18,"uvi":0,"clouds":36,"visibility":10000,"wind_speed":3.44,"wind_deg":306,"wind_gust":4.13,"weather":[{"id":211,"main":"Thunderstorm","description":"thunderstorm","icon":"11n"}],"pop":0.8,"rain":{"1h":1.1}},
+{"dt":1720054800,"temp":20.75,"feels_like":22.45,"pressure":1011,"humidity":75,"dew_point":12.35,"uvi":0,"clouds":53,"visibility":10000,"wind_speed":3.18,"wind_deg":315,"wind_gust":4.36,"weather":[{"id":500,"main":"Rain","description":"light rain","icon":"10n"}],"pop":0.2,"rain":{"1h":1.5}},
+{"dt":1720058400,"temp":20.28,"feels_like":21.98,"pressure":1010,"humidity":82,"dew_point":11.88,"uvi":0,"clouds":70,"visibility":10000,"wind_speed":2.92,"wind_deg":324,"wind_gust":4.69,"weather":[{"id":500,"main":"Rain","description":"light rain","icon":"10n"}],"pop":0.35,"rain":{"1h":0.3}},
+{"dt":1720062000,"temp":20.21,"feels_like":21.91,"pressure":1009,"humidity":89,"dew_point":11.81,"uvi":0,"clouds":87,"visibility":10000,"wind_speed":2.67,"wind_deg":333,"wind_gust":5.11,"weather":[{"id":500,"main":"Rain","description":"light rain","icon":"10n"}],"pop":0.5,"rain":{"1h":0.7}},
+{"dt":1720065600,"temp":20.54,"feels_like":22.24,"pressure":1008,"humidity":56,"dew_point":12.14,"uvi":0,"clouds":3,"visibility":10000,"wind_speed":2.42,"wind_deg":342,"wind_gust":5.58,"weather":[{"id":803,"main":"Clouds","description":"broken clouds","icon":"04n"}],"pop":0},
+{"dt":1720069200,"temp":21.27,"feels_like":22.97,"pressure":1007,"humidity":63,"dew_point":12.87,"uvi":0,"clouds":20,"visibility":10000,"wind_speed":2.2,"wind_deg":351,"wind_gust":6.08,"weather":[{"id":803,"main":"Clouds","description":"broken clouds","icon":"04n"}],"pop":0},
+{"dt":1720072800,"temp":22.36,"feels_like":24.06,"pressure":1006,"humidity":70,"dew_point":13.96,"uvi":0,"clouds":37,"visibility":10000,"wind_speed":2.02,"wind_deg":0,"wind_gust":6.57,"weather":[{"id":803,"main":"Clouds","description":"broken clouds","icon":"04d"}],"pop":0},
+{"dt":1720076400,"temp":23.73,"feels_like":25.43,"pressure":1012,"humidity":77,"dew_point":15.33,"uvi":1.78,"clouds":54,"visibility":10000,"wind_speed":1.87,"wind_deg":9,"wind_gust":7.02,"weather":[{"id":801,"main":"Clouds","description":"few clouds","icon":"02d"}],"pop":0},
+{"dt":1720080000,"temp":25.31,"feels_like":27.01,"pressure":1011,"humidity":84,"dew_point":16.91,"uvi":3.47,"clouds":71,"visibility":10000,"wind_speed":1.76,"wind_deg":18,"wind_gust":7.42,"weather":[{"id":801,"main":"Clouds","description":"few clouds","icon":"02d"}],"pop":0},
+{"dt":1720083600,"temp":26.99,"feels_like":28.69,"pressure":1010,"humidity":51,"dew_point":18.59,"uvi":4.99,"clouds":88,"visibility":10000,"wind_speed":1.71,"wind_deg":27,"wind_gust":7.72,"weather":[{"id":801,"main":"Clouds","description":"few clouds","icon":"02d"}],"pop":0},
+{"dt":1720087200,"temp":28.67,"feels_like":30.37,"pressure":1009,"humidity":58,"dew_point":20.27,"uvi":6.25,"clouds":4,"visibility":10000,"wind_speed":1.7,"wind_deg":36,"wind_gust":7.92,"weather":[{"id":800,"main":"Clear","description":"clear sky","icon":"01d"}],"pop":0},
+{"dt":1720090800,"temp":30.25,"feels_like":31.95,"pressure":1008,"humidity":65,"dew_point":21.85,"uvi":7.21,"clouds":21,"visibility":10000,"wind_speed":1.75,"wind_deg":45,"wind_gust":8.0,"weather":[{"id":800,"main":"Clear","description":"clear sky","icon":"01d"}],"pop":0},
+{"dt":1720094400,"temp":31.62,"feels_like":33.32,"pressure":1007,"humidity":72,"dew_point":23.22,"uvi":7.8,"clouds":38,"visibility":10000,"wind_speed":1.85,"wind_deg":54,"wind_gust":7.95,"weather":[{"id":800,"main":"Clear","description":"clear sky","icon":"01d"}],"pop":0},
+{"dt":1720098000,"temp":32.71,"feels_like":34.41,"pressure":1006,"humidity":79,"dew_point":24.31,"uvi":8.0,"clouds":55,"visibility":10000,"wind_speed":2.0,"wind_deg":63,"wind_gust":7.79,"weather":[{"id":800,"main":"Clear","description":"clear sky","icon":"01d"}],"pop":0},
+{"dt":1720101600,"temp":33.44,"feels_like":35.14,"pressure":1012,"humidity":86,"dew_point":25.04,"uvi":7.8,"clouds":72,"visibility":10000,"wind_speed":2.18,"wind_deg":72,"wind_gust":7.51,"weather":[{"id":800,"main":"Clear","description":"clear sky","icon":"01d"}],"pop":0},
+{"dt":1720105200,"temp":33.77,"feels_like":35.47,"pressure":1011,"humidity":53,"dew_point":25.37,"uvi":7.21,"clouds":89,"visibility":10000,"wind_speed":2.4,"wind_deg":81,"wind_gust":7.14,"weather":[{"id":800,"main":"Clear","description":"clear sky","icon":"01d"}],"pop":0},
+{"dt":1720108800,"temp":33.7,"feels_like":35.4,"pressure":1010,"humidity":60,"dew_point":25.3,"uvi":6.25,"clouds":5,"visibility":10000,"wind_speed":2.64,"wind_deg":90,"wind_gust":6.69,"weather":[{"id":800,"main":"Clear","description":"clear sky","icon":"01d"}],"pop":0},
+{"dt":1720112400,"temp":33.23,"feels_like":34.93,"pressure":1009,"humidity":67,"dew_point":24.83,"uvi":4.99,"clouds":22,"visibility":10000,"wind_speed":2.89,"wind_deg":99,"wind_gust":6.21,"weather":[{"id":800,"main":"Clear","description":"clear sky","icon":"01d"}],"pop":0},
+{"dt":1720116000,"temp":32.4,"feels_like":34.1,"pressure":1008,"humidity":74,"dew_point":24.0,"uvi":3.47,"clouds":39,"visibility":10000,"wind_speed":3.15,"wind_deg":108,"wind_gust":5.71,"weather":[{"id":800,"main":"Clear","description":"clear sky","icon":"01d"}],"pop":0},
+{"dt":1720119600,"temp":31.29,"feels_like":32.99,"pressure":1007,"humidity":81,"dew_point":22.89,"uvi":1.78,"clouds":56,"visibility":10000,"wind_speed":3.41,"wind_deg":117,"wind_gust":5.23,"weather":[{"id":801,"main":"Clouds","description":"few clouds","icon":"02d"}],"pop":0},
+{"dt":1720123200,"temp":29.97,"feels_like":31.67,"pressure":1006,"humidity":88,"dew_point":21.57,"uvi":0.0,"clouds":73,"visibility":10000,"wind_speed":3.64,"wind_deg":126,"wind_gust":4.8,"weather":[{"id":801,"main":"Clouds","description":"few clouds","icon":"02d"}],"pop":0},
+{"dt":1720126800,"temp":28.55,"feels_like":30.25,"pressure":1012,"humidity":55,"dew_point":20.15,"uvi":0,"clouds":90,"visibility":10000,"wind_speed":3.85,"wind_deg":135,"wind_gust":4.44,"weather":[{"id":801,"main":"Clouds","description":"few clouds","icon":"02n"}],"pop":0},
+{"dt":1720130400,"temp":27.13,"feels_like":28.83,"pressure":1011,"humidity":62,"dew_point":18.73,"uvi":0,"clouds":6,"visibility":10000,"wind_speed":4.03,"wind_deg":144,"wind_gust":4.18,"weather":[{"id":802,"main":"Clouds","description":"scattered clouds","icon":"03n"}],"pop":0},
+{"dt":1720134000,"temp":25.81,"feels_like":27.51,"pressure":1010,"humidity":69,"dew_point":17.41,"uvi":0,"clouds":23,"visibility":10000,"wind_speed":4.17,"wind_deg":153,"wind_gust":4.03,"weather":[{"id":802,"main":"Clouds","description":"scattered clouds","icon":"03n"}],"pop":0},
+{"dt":1720137600,"temp":24.7,"feels_like":26.4,"pressure":1009,"humidity":76,"dew_point":16.3,"uvi":0,"clouds":40,"visibility":10000,"wind_speed":4.26,"wind_deg":162,"wind_gust":4.01,"weather":[{"id":802,"main":"Clouds","description":"scattered clouds","icon":"03n"}],"pop":0},
+{"dt":1720141200,"temp":23.87,"feels_like":25.57,"pressure":1008,"humidity":83,"dew_point":15.47,"uvi":0,"clouds":57,"visibility":10000,"wind_speed":4.3,"wind_deg":171,"wind_gust":4.1,"weather":[{"id":803,"main":"Clouds","description":"broken clouds","icon":"04n"}],"pop":0},
+{"dt":1720144800,"temp":23.4,"feels_like":25.1,"pressure":1007,"humidity":50,"dew_point":15.0,"uvi":0,"clouds":74,"visibility":10000,"wind_speed":4.29,"wind_deg":180,"wind_gust":4.32,"weather":[{"id":803,"main":"Clouds","description":"broken clouds","icon":"04n"}],"pop":0},
+{"dt":1720148400,"temp":23.33,"feels_like":25.03,"pressure":1006,"humidity":57,"dew_point":14.93,"uvi":0,"clouds":91,"visibility":10000,"wind_speed":4.22,"wind_deg":189,"wind_gust":4.64,"weather":[{"id":803,"main":"Clouds","description":"broken clouds","icon":"04n"}],"pop":0},
+{"dt":1720152000,"temp":23.66,"feels_like":25.36,"pressure":1012,"humidity":64,"dew_point":15.26,"uvi":0,"clouds":7,"visibility":10000,"wind_speed":4.11,"wind_deg":198,"wind_gust":5.05,"weather":[{"id":500,"main":"Rain","description":"light rain","icon":"10n"}],"pop":0.5,"rain":{"1h":1.1}},
+{"dt":1720155600,"temp":24.39,"feels_like":26.09,"pressure":1011,"humidity":71,"dew_point":15.99,"uvi":0,"clouds":24,"visibility":10000,"wind_speed":3.95,"wind_deg":207,"wind_gust":5.51,"weather":[{"id":500,"main":"Rain","description":"light rain","icon":"10n"}],"pop":0.65,"rain":{"1h":1.5}},
+{"dt":1720159200,"temp":25.48,"feels_like":27.18,"pressure":1010,"humidity":78,"dew_point":17.08,"uvi":0,"clouds":41,"visibility":10000,"wind_speed":3.76,"wind_deg":216,"wind_gust":6.01,"weather":[{"id":500,"main":"Rain","description":"light rain","icon":"10d"}],"pop":0.8,"rain":{"1h":0.3}},
+{"dt":1720162800,"temp":26.85,"feels_like":28.55,"pressure":1009,"humidity":85,"dew_point":18.45,"uvi":1.78,"clouds":58,"visibility":10000,"wind_speed":3.54,"wind_deg":225,"wind_gust":6.5,"weather":[{"id":501,"main":"Rain","description":"moderate rain","icon":"10d"}],"pop":0.2,"rain":{"1h":0.7}},
+{"dt":1720166400,"temp":28.43,"feels_like":30.13,"pressure":1008,"humidity":52,"dew_point":20.03,"uvi":3.47,"clouds":75,"visibility":10000,"wind_speed":3.29,"wind_deg":234,"wind_gust":6.97,"weather":[{"id":501,"main":"Rain","description":"moderate rain","icon":"10d"}],"pop":0.35,"rain":{"1h":1.1}},
+{"dt":1720170000,"temp":30.11,"feels_like":31.81,"pressure":1007,"humidity":59,"dew_point":21.71,"uvi":4.99,"clouds":92,"visibility":10000,"wind_speed":3.03,"wind_deg":243,"wind_gust":7.37,"weather":[{"id":501,"main":"Rain","description":"moderate rain","icon":"10d"}],"pop":0.5,"rain":{"1h":1.5}}
+],
+"daily":[
+{"dt":1720029600,"sunrise":1719996060,"sunset":1720050300,"moonrise":1719990000,"moonset":1720043000,"moon_phase":0.93,"summary":"Expect a day of partly cloudy with thunderstorm","temp":{"day":30.0,"min":20.5,"max":31.2,"night":21.6,"eve":27.9,"morn":20.9},"feels_like":{"day":32.0,"night":22.0,"eve":29.1,"morn":21.4},"pressure":1011,"humidity":55,"dew_point":18.2,"wind_speed":4.4,"wind_deg":190,"wind_gust":9.1,"weather":[{"id":211,"main":"Thunderstorm","description":"thunderstorm","icon":"11d"}],"clouds":15,"pop":0.65,"uvi":8.1,"rain":4.6},
+{"dt":1720116000,"sunrise":1720082500,"sunset":1720136665,"moonrise":1720079400,"moonset":1720132500,"moon_phase":0.96,"summary":"Expect a day of partly cloudy with light rain","temp":{"day":29.6,"min":21.1,"max":30.8,"night":22.2,"eve":27.5,"morn":21.5},"feels_like":{"day":31.6,"night":22.6,"eve":28.7,"morn":22.0},"pressure":1012,"humidity":58,"dew_point":18.4,"wind_speed":4.7,"wind_deg":201,"wind_gust":8.9,"weather":[{"id":500,"main":"Rain","description":"light rain","icon":"10d"}],"clouds":38,"pop":0.6,"uvi":7.8,"rain":5.8},
+{"dt":1720202400,"sunrise":1720168940,"sunset":1720223030,"moonrise":1720168800,"moonset":1720222000,"moon_phase":0.0,"summary":"Expect a day of partly cloudy with few clouds","temp":{"day":29.2,"min":21.7,"max":30.4,"night":22.8,"eve":27.1,"morn":22.1},"feels_like":{"day":31.2,"night":23.2,"eve":28.3,"morn":22.6},"pressure":1013,"humidity":61,"dew_point":18.6,"wind_speed":5.0,"wind_deg":212,"wind_gust":8.7,"weather":[{"id":801,"main":"Clouds","description":"few clouds","icon":"02d"}],"clouds":61,"pop":0,"uvi":7.5},
+{"dt":1720288800,"sunrise":1720255380,"sunset":1720309395,"moonrise":1720258200,"moonset":1720311500,"moon_phase":0.030000000000000027,"summary":"Expect a day of partly cloudy with clear sky","temp":{"day":28.8,"min":22.3,"max":30.0,"night":23.4,"eve":26.7,"morn":22.7},"feels_like":{"day":30.8,"night":23.8,"eve":27.9,"morn":23.2},"pressure":1014,"humidity":64,"dew_point":18.8,"wind_speed":5.3,"wind_deg":223,"wind_gust":8.5,"weather":[{"id":800,"main":"Clear","description":"clear sky","icon":"01d"}],"clouds":84,"pop":0,"uvi":7.2},
+{"dt":1720375200,"sunrise":1720341820,"sunset":1720395760,"moonrise":1720347600,"moonset":1720401000,"moon_phase":0.07000000000000006,"summary":"Expect a day of partly cloudy with broken clouds","temp":{"day":28.4,"min":22.9,"max":29.6,"night":24.0,"eve":26.3,"morn":23.3},"feels_like":{"day":30.4,"night":24.4,"eve":27.5,"morn":23.8},"pressure":1015,"humidity":67,"dew_point":19.0,"wind_speed":5.6,"wind_deg":234,"wind_gust":8.3,"weather":[{"id":803,"main":"Clouds","description":"broken clouds","icon":"04d"}],"clouds":7,"pop":0,"uvi":6.9},
+{"dt":1720461600,"sunrise":1720428260,"sunset":1720482125,"moonrise":1720437000,"moonset":1720490500,"moon_phase":0.10000000000000009,"summary":"Expect a day of partly cloudy with moderate rain","temp":{"day":28.0,"min":23.5,"max":29.2,"night":24.6,"eve":25.9,"morn":23.9},"feels_like":{"day":30.0,"night":25.0,"eve":27.1,"morn":24.4},"pressure":1016,"humidity":70,"dew_point":19.2,"wind_speed":5.9,"wind_deg":245,"wind_gust":8.1,"weather":[{"id":501,"main":"Rain","description":"moderate rain","icon":"10d"}],"clouds":30,"pop":0.4,"uvi":6.6,"rain":10.6},
+{"dt":1720548000,"sunrise":1720514700,"sunset":1720568490,"moonrise":1720526400,"moonset":1720580000,"moon_phase":0.1299999999999999,"summary":"Expect a day of partly cloudy with scattered clouds","temp":{"day":27.6,"min":24.1,"max":28.8,"night":25.2,"eve":25.5,"morn":24.5},"feels_like":{"day":29.6,"night":25.6,"eve":26.7,"morn":25.0},"pressure":1017,"humidity":73,"dew_point":19.4,"wind_speed":6.2,"wind_deg":256,"wind_gust":7.9,"weather":[{"id":802,"main":"Clouds","description":"scattered clouds","icon":"03d"}],"clouds":53,"pop":0,"uvi":6.3},
+{"dt":1720634400,"sunrise":1720601140,"sunset":1720654855,"moonrise":1720615800,"moonset":1720669500,"moon_phase":0.16999999999999993,"summary":"Expect a day of partly cloudy with clear sky","temp":{"day":27.2,"min":24.7,"max":28.4,"night":25.8,"eve":25.1,"morn":25.1},"feels_like":{"day":29.2,"night":26.2,"eve":26.3,"morn":25.6},"pressure":1018,"humidity":76,"dew_point":19.6,"wind_speed":6.5,"wind_deg":267,"wind_gust":7.7,"weather":[{"id":800,"main":"Clear","description":"clear sky","icon":"01d"}],"clouds":76,"pop":0,"uvi":6.0}
+],
+"alerts":[
+{"sender_name":"NWS Chicago IL","event":"Severe Thunderstorm Watch","start":1720004400,"end":1720022400,"description":"SEVERE THUNDERSTORM WATCH 512 REMAINS VALID UNTIL 9 PM CDT THIS EVENING FOR THE FOLLOWING AREAS\n\nIN ILLINOIS THIS WATCH INCLUDES 8 COUNTIES\n\nIN NORTHEAST ILLINOIS\n\nCOOK DUPAGE KANE KENDALL LAKE MCHENRY WILL\n\nIN NORTH CENTRAL ILLINOIS\n\nDEKALB\n\nTHIS INCLUDES THE CITIES OF AURORA, CHICAGO, DEKALB, ELGIN, JOLIET, NAPERVILLE, OSWEGO, WAUKEGAN, WHEATON AND WOODSTOCK.","tags":["Thunderstorm","Wind","Hail"]},
+{"sender_name":"NWS Chicago IL","event":"Heat Advisory","start":1719993600,"end":1720044000,"description":"* WHAT...Heat index values up to 105 expected.\n\n* WHERE...Cook and DuPage Counties.\n\n* WHEN...Until 7 PM CDT this evening.\n\n* IMPACTS...Hot temperatures and high humidity may cause heat illnesses to occur.","tags":["Extreme high temperature"]}
+]})json";
+
+#endif  // ONECALL_FIXTURE_H
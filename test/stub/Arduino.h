@@ -0,0 +1,224 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/*----------------------------------------------------------------
+  Host stand-in for the parts of Arduino and FreeRTOS the tested code uses
+
+    Print, Stream and Serial (to stdout), and a virtual clock: millis(),
+    micros(), delay() and vTaskDelay() read and advance hostClockMicros, so a
+    test decides how much time passes. Tasks are never started; a test calls
+    the task body or drain function itself. Critical sections are no-ops, the
+    tests are single threaded, so a semaphore wait that can't be met at once
+    just lets its timeout pass.
+
+    HardwareSerial's port functions are virtual: a test can put a simulated
+    device behind a port (see test_nextion).
+*/
+
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+
+typedef uint8_t byte;
+
+#ifndef constrain
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+inline uint64_t hostClockMicros = 0;
+
+inline unsigned long millis() { return (unsigned long)(hostClockMicros / 1000); }
+inline unsigned long micros() { return (unsigned long)hostClockMicros; }
+inline void delay(unsigned long ms) { hostClockMicros += (uint64_t)ms * 1000; }
+inline void yield() {}
+inline uint32_t esp_get_free_heap_size() { return 200000; }
+
+// Chip. The MAC is settable, so a test can run several stations in one process.
+class EspClass {
+ public:
+  uint64_t efuseMac = 0x665544332211ULL;
+  uint64_t getEfuseMac() { return efuseMac; }
+};
+inline EspClass ESP;
+
+// esp32-hal-time: TZ goes to the C library, the wall clock is the host's
+inline void configTzTime(const char* tz, const char*, const char* = nullptr, const char* = nullptr) {
+  setenv("TZ", tz, 1);
+  tzset();
+}
+inline bool getLocalTime(struct tm* info, uint32_t = 5000) {
+  time_t now = time(nullptr);
+  return localtime_r(&now, info) != nullptr;
+}
+
+#if defined(__GLIBC__) && __GLIBC__ == 2 && __GLIBC_MINOR__ < 38  // Older glibc has no strlcpy
+inline size_t strlcpy(char* dst, const char* src, size_t size) {
+  size_t length = strlen(src);
+  if (size) {
+    size_t n = length < size - 1 ? length : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = 0;
+  }
+  return length;
+}
+#endif
+
+class String {
+ public:
+  String(const char* text = "") : _text(text ? text : "") {}
+  String(const std::string& text) : _text(text) {}
+  String(char c) : _text(1, c) {}
+  String(int value) : _text(std::to_string(value)) {}
+  String(unsigned value) : _text(std::to_string(value)) {}
+  String(long value) : _text(std::to_string(value)) {}
+  String(unsigned long value) : _text(std::to_string(value)) {}
+  String(long long value) : _text(std::to_string(value)) {}
+  String(double value, unsigned decimals = 2) {  // Two decimals, as Arduino's
+    char text[32];
+    snprintf(text, sizeof(text), "%.*f", (int)decimals, value);
+    _text = text;
+  }
+  const char* c_str() const { return _text.c_str(); }
+  unsigned length() const { return _text.length(); }
+  String substring(unsigned from) const { return from < _text.length() ? _text.substr(from) : ""; }
+  String& operator+=(const String& other) {
+    _text += other._text;
+    return *this;
+  }
+  bool operator==(const String& other) const { return _text == other._text; }
+  bool operator!=(const String& other) const { return _text != other._text; }
+  friend String operator+(const String& left, const String& right) { return String(left._text + right._text); }
+
+ private:
+  std::string _text;
+};
+
+class IPAddress {
+ public:
+  IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : _bytes{a, b, c, d} {}
+  uint8_t operator[](int i) const { return _bytes[i]; }
+  bool operator==(const IPAddress& other) const { return memcmp(_bytes, other._bytes, 4) == 0; }
+  String toString() const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", _bytes[0], _bytes[1], _bytes[2], _bytes[3]);
+    return String(text);
+  }
+
+ private:
+  uint8_t _bytes[4];
+};
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+  size_t print(const char* text) { return write(text); }
+  size_t print(const String& text) { return write(text.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int value) { return printf("%d", value); }
+  size_t print(unsigned value) { return printf("%u", value); }
+  size_t println() { return write("\r\n"); }
+  size_t println(const char* text) { return print(text) + println(); }
+  size_t println(const String& text) { return print(text) + println(); }
+  size_t printf(const char* format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (n < 0) return 0;
+    return write((const uint8_t*)buffer, (size_t)n < sizeof(buffer) ? n : sizeof(buffer) - 1);
+  }
+  virtual void flush() {}
+};
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual size_t readBytes(char* buffer, size_t length) {
+    size_t n = 0;
+    int c;
+    while (n < length && (c = read()) >= 0) buffer[n++] = (char)c;
+    return n;
+  }
+  size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+  void setTimeout(unsigned long) {}
+};
+
+#define SERIAL_8N1 0x800001c
+
+class HardwareSerial : public Stream {
+ public:
+  virtual void begin(unsigned long, uint32_t = SERIAL_8N1, int8_t = -1, int8_t = -1) {}
+  virtual void updateBaudRate(unsigned long) {}
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+  using Print::write;
+  void flush() override {}
+};
+
+inline HardwareSerial Serial;
+
+// FreeRTOS
+typedef void* TaskHandle_t;
+typedef int* SemaphoreHandle_t;
+typedef void (*TaskFunction_t)(void*);
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef int portMUX_TYPE;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portTICK_PERIOD_MS 1
+#define tskNO_AFFINITY 0x7fffffff
+#define configMAX_PRIORITIES 25
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) (void)(mux)
+#define portEXIT_CRITICAL(mux) (void)(mux)
+
+inline TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+inline void vTaskDelay(TickType_t ticks) { delay(ticks); }
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return (TaskHandle_t)&hostClockMicros; }
+inline const char* pcTaskGetName(TaskHandle_t) { return "host"; }
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary() { return new int(0); }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  *semaphore = 1;
+  return pdTRUE;
+}
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+  if (*semaphore) {
+    *semaphore = 0;
+    return pdTRUE;
+  }
+  vTaskDelay(ticks);
+  return pdFALSE;
+}
+inline BaseType_t xPortGetCoreID() { return 0; }
+inline UBaseType_t uxTaskPriorityGet(TaskHandle_t) { return 1; }
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*,
+                                          BaseType_t) {
+  return pdFAIL;
+}
+
+#endif  // HOST_ARDUINO_H
@@ -0,0 +1,59 @@
+#ifndef HOST_HTTPCLIENT_H
+#define HOST_HTTPCLIENT_H
+
+/*----------------------------------------------------------------
+  Host stand-in for HTTPClient: GET() returns a canned response
+
+    A test sets responseCode, body and contentEncoding. The body is served a
+    chunk bytes per read, as from a network stream. url is the last begin().
+*/
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+
+class HTTPClient {
+ public:
+  int responseCode = -1;  // HTTPC_ERROR_CONNECTION_REFUSED
+  const uint8_t* body = nullptr;
+  size_t bodySize = 0;
+  size_t chunk = 64;
+  const char* contentEncoding = "";
+  String url;
+
+  bool begin(const String& location) {
+    url = location;
+    return true;
+  }
+  bool begin(WiFiClient&, const String& location) { return begin(location); }
+  void end() {}
+  void useHTTP10(bool) {}
+  void addHeader(const String&, const String&) {}
+  void collectHeaders(const char**, size_t) {}
+  String header(const char* name) { return strcmp(name, "Content-Encoding") == 0 ? contentEncoding : ""; }
+
+  int GET() {
+    _stream.at = 0;
+    return responseCode;
+  }
+  int getSize() { return (int)bodySize; }
+  Stream& getStream() { return _stream; }
+
+ private:
+  struct BodyStream : public Stream {
+    HTTPClient* http;
+    size_t at = 0;
+    explicit BodyStream(HTTPClient* http) : http(http) {}
+    int available() override { return (int)(http->bodySize - at); }
+    int peek() override { return at < http->bodySize ? http->body[at] : -1; }
+    int read() override { return at < http->bodySize ? http->body[at++] : -1; }
+    size_t readBytes(char* buffer, size_t length) override {
+      size_t n = 0;
+      while (n < length && n < http->chunk && at < http->bodySize) buffer[n++] = http->body[at++];
+      return n;
+    }
+    size_t write(uint8_t) override { return 0; }
+  };
+  BodyStream _stream{this};
+};
+
+#endif  // HOST_HTTPCLIENT_H
@@ -0,0 +1,64 @@
+#ifndef HOST_NIMBLEDEVICE_H
+#define HOST_NIMBLEDEVICE_H
+
+// Host stand-in for the NimBLE types ruuvi.h names. Nothing scans; tests feed
+// adverts to processRuuviAdvertisement() or replay a capture.
+
+#include <Arduino.h>
+
+#include <string>
+
+class NimBLEUUID {
+ public:
+  NimBLEUUID() {}
+  explicit NimBLEUUID(const char*) {}
+  bool operator==(const NimBLEUUID&) const { return true; }
+};
+
+class NimBLEAddress {
+ public:
+  const uint8_t* getNative() const { return _native; }
+
+ private:
+  uint8_t _native[6] = {};
+};
+
+class NimBLEAdvertisedDevice {
+ public:
+  NimBLEUUID getServiceUUID() { return NimBLEUUID(); }
+  const uint8_t* getPayload() { return nullptr; }
+  size_t getPayloadLength() { return 0; }
+  NimBLEAddress getAddress() { return NimBLEAddress(); }
+  int getRSSI() { return 0; }
+};
+
+class NimBLEAdvertisedDeviceCallbacks {
+ public:
+  virtual ~NimBLEAdvertisedDeviceCallbacks() {}
+  virtual void onResult(NimBLEAdvertisedDevice*) {}
+};
+
+class NimBLEScanResults {};
+
+class NimBLEScan {
+ public:
+  void setAdvertisedDeviceCallbacks(NimBLEAdvertisedDeviceCallbacks*, bool) {}
+  void setActiveScan(bool) {}
+  void setInterval(uint16_t) {}
+  void setWindow(uint16_t) {}
+  void setMaxResults(uint8_t) {}
+  bool isScanning() { return false; }
+  NimBLEScanResults start(uint32_t, bool) { return NimBLEScanResults(); }
+  void clearResults() {}
+};
+
+class NimBLEDevice {
+ public:
+  static void init(const std::string&) {}
+  static NimBLEScan* getScan() {
+    static NimBLEScan scan;
+    return &scan;
+  }
+};
+
+#endif  // HOST_NIMBLEDEVICE_H
@@ -0,0 +1,36 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+// Host stand-in for ESP32 NVS preferences, kept in memory for the life of the test program
+
+#include <Arduino.h>
+
+#include <map>
+#include <string>
+
+class Preferences {
+ public:
+  static std::map<std::string, unsigned long>& store() {
+    static std::map<std::string, unsigned long> values;
+    return values;
+  }
+
+  bool begin(const char* name, bool = false) {
+    _name = name;
+    return true;
+  }
+  void end() {}
+  unsigned long getULong(const char* key, unsigned long fallback = 0) {
+    auto found = store().find(_name + "/" + key);
+    return found == store().end() ? fallback : found->second;
+  }
+  size_t putULong(const char* key, unsigned long value) {
+    store()[_name + "/" + key] = value;
+    return sizeof(value);
+  }
+
+ private:
+  std::string _name;
+};
+
+#endif  // HOST_PREFERENCES_H
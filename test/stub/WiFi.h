@@ -0,0 +1,8 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+// Host stand-in for the WiFi library: nothing the tested code calls yet, the include must resolve
+
+#include <Arduino.h>
+
+#endif  // HOST_WIFI_H
@@ -0,0 +1,22 @@
+#ifndef HOST_WIFICLIENT_H
+#define HOST_WIFICLIENT_H
+
+// Host stand-in for WiFiClient: never connects. ResumableTlsClient overrides it with real sockets.
+
+#include <Arduino.h>
+
+class WiFiClient : public Stream {
+ public:
+  virtual int connect(IPAddress, uint16_t) { return 0; }
+  virtual int connect(const char*, uint16_t) { return 0; }
+  size_t write(uint8_t) override { return 0; }
+  size_t write(const uint8_t*, size_t) override { return 0; }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  virtual int read(uint8_t*, size_t) { return -1; }
+  int peek() override { return -1; }
+  virtual void stop() {}
+  virtual uint8_t connected() { return 0; }
+};
+
+#endif  // HOST_WIFICLIENT_H
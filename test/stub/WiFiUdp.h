@@ -0,0 +1,91 @@
+#ifndef HOST_WIFIUDP_H
+#define HOST_WIFIUDP_H
+
+/*----------------------------------------------------------------
+  Host stand-in for WiFiUDP: multicast on an in-process network
+
+    A datagram sent is queued at every socket joined to the same group and
+    port, the sender's own included, as with multicast loopback on. Nothing is
+    lost or reordered unless a test asks: a deaf socket receives nothing, a
+    mute one sends nothing. A test can join the group itself with another
+    WiFiUDP to watch the traffic, or to send datagrams of its own making.
+*/
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+class WiFiUDP {
+ public:
+  typedef std::vector<uint8_t> Datagram;
+
+  bool deaf = false;
+  bool mute = false;
+
+  ~WiFiUDP() { stop(); }
+
+  uint8_t beginMulticast(IPAddress group, uint16_t port) {
+    stop();
+    _group = group;
+    _port = port;
+    joined().push_back(this);
+    return 1;
+  }
+
+  void stop() {
+    auto& sockets = joined();
+    sockets.erase(std::remove(sockets.begin(), sockets.end(), this), sockets.end());
+    _queue.clear();
+  }
+
+  int beginMulticastPacket() {
+    _out.clear();
+    return 1;
+  }
+  size_t write(uint8_t c) { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) {
+    _out.insert(_out.end(), buffer, buffer + size);
+    return size;
+  }
+  int endPacket() {
+    if (mute) return 1;
+    for (WiFiUDP* socket : joined()) {
+      if (socket->_group == _group && socket->_port == _port && !socket->deaf) socket->_queue.push_back(_out);
+    }
+    return 1;
+  }
+
+  // Next datagram, returns its size or 0 if none
+  int parsePacket() {
+    _in.clear();
+    _inPos = 0;
+    if (_queue.empty()) return 0;
+    _in = _queue.front();
+    _queue.pop_front();
+    return _in.size();
+  }
+  int available() { return _in.size() - _inPos; }
+  int read(uint8_t* buffer, size_t size) {
+    size_t n = std::min(size, _in.size() - _inPos);
+    memcpy(buffer, _in.data() + _inPos, n);
+    _inPos += n;
+    return n;
+  }
+
+ private:
+  IPAddress _group;
+  uint16_t _port = 0;
+  Datagram _out;
+  Datagram _in;
+  size_t _inPos = 0;
+  std::deque<Datagram> _queue;
+
+  static std::vector<WiFiUDP*>& joined() {
+    static std::vector<WiFiUDP*> sockets;
+    return sockets;
+  }
+};
+
+#endif  // HOST_WIFIUDP_H
@@ -0,0 +1,8 @@
+#ifndef HOST_ESP32_ROM_MINIZ_H
+#define HOST_ESP32_ROM_MINIZ_H
+
+// Host stand-in for the ROM inflater: tinfl from the miniz library (lib_deps in platformio.ini)
+
+#include <miniz.h>
+
+#endif  // HOST_ESP32_ROM_MINIZ_H
@@ -0,0 +1,7 @@
+#ifndef HOST_ESP_ATTR_H
+#define HOST_ESP_ATTR_H
+
+#define RTC_NOINIT_ATTR
+#define IRAM_ATTR
+
+#endif  // HOST_ESP_ATTR_H
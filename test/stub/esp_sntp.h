@@ -0,0 +1,11 @@
+#ifndef HOST_ESP_SNTP_H
+#define HOST_ESP_SNTP_H
+
+// Host stand-in for the SNTP client: the host clock is always set, no sync ever arrives
+
+#include <sys/time.h>
+
+typedef void (*sntp_sync_time_cb_t)(struct timeval* tv);
+inline void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t) {}
+
+#endif  // HOST_ESP_SNTP_H
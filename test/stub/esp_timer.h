@@ -0,0 +1,24 @@
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+// Host stand-in for esp_timer: time from the virtual clock, periodic timers never fire
+
+#include <Arduino.h>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+typedef void* esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void*);
+struct esp_timer_create_args_t {
+  esp_timer_cb_t callback;
+  void* arg;
+  const char* name;
+};
+
+inline int64_t esp_timer_get_time() { return (int64_t)hostClockMicros; }
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t*, esp_timer_handle_t*) { return ESP_FAIL; }
+inline esp_err_t esp_timer_start_periodic(esp_timer_handle_t, uint64_t) { return ESP_FAIL; }
+
+#endif  // HOST_ESP_TIMER_H
@@ -0,0 +1,8 @@
+#ifndef HOST_LWIP_NETDB_H
+#define HOST_LWIP_NETDB_H
+
+// Host stand-in for lwIP's resolver: the host's getaddrinfo()
+
+#include <netdb.h>
+
+#endif  // HOST_LWIP_NETDB_H
@@ -0,0 +1,2 @@
+// Host tests build with the distributed settings, see include/settings-dist.h
+#include "settings-dist.h"
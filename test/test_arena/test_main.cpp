@@ -0,0 +1,136 @@
+#include <arena.h>
+#include <owmFilter.h>
+#include <unity.h>
+
+#include "../fixtures/oneCall.h"
+
+// Response body served a few bytes per read, as from a network stream
+class TextStream : public Stream {
+ public:
+  explicit TextStream(const char* text, size_t chunk = 64) : _text(text), _chunk(chunk) {}
+  int available() override { return _text[_at] ? 1 : 0; }
+  int peek() override { return _text[_at] ? (uint8_t)_text[_at] : -1; }
+  int read() override { return _text[_at] ? (uint8_t)_text[_at++] : -1; }
+  size_t readBytes(char* buffer, size_t length) override {
+    size_t n = 0;
+    while (n < length && n < _chunk && _text[_at]) buffer[n++] = _text[_at++];
+    return n;
+  }
+  size_t write(uint8_t) override { return 0; }
+
+ private:
+  const char* _text;
+  size_t _chunk;
+  size_t _at = 0;
+};
+
+void setUp() {}
+void tearDown() {}
+
+void test_blocks_bump_and_give_back_last() {
+  MonotonicArena<256> arena;
+  void* a = arena.allocate(10);
+  TEST_ASSERT_EQUAL(8 + 16, arena.used());  // Size header, rounded up to 8
+  void* b = arena.allocate(8);
+  TEST_ASSERT_EQUAL(24 + 16, arena.used());
+  TEST_ASSERT_EQUAL(0, (uintptr_t)b % 8);
+
+  // Only the most recent block is given back, the rest waits for reset()
+  arena.deallocate(a);
+  TEST_ASSERT_EQUAL(40, arena.used());
+  arena.deallocate(b);
+  TEST_ASSERT_EQUAL(24, arena.used());
+  TEST_ASSERT_EQUAL(40, arena.peak());
+  arena.reset();
+  TEST_ASSERT_EQUAL(0, arena.used());
+  TEST_ASSERT_EQUAL(0, arena.peak());
+  TEST_ASSERT_EQUAL(40, arena.maxPeak());
+  TEST_ASSERT_EQUAL(0, arena.heapFallbacks());
+}
+
+void test_reallocate_in_place_or_copy() {
+  MonotonicArena<256> arena;
+  char* a = (char*)arena.allocate(4);
+  memcpy(a, "abc", 4);
+  // Last block grows and shrinks where it is
+  TEST_ASSERT_EQUAL_PTR(a, arena.reallocate(a, 64));
+  TEST_ASSERT_EQUAL(72, arena.used());
+  TEST_ASSERT_EQUAL_PTR(a, arena.reallocate(a, 4));
+  TEST_ASSERT_EQUAL(16, arena.used());
+  TEST_ASSERT_EQUAL(72, arena.peak());
+
+  // An earlier block moves to the end, contents kept
+  arena.allocate(8);
+  char* moved = (char*)arena.reallocate(a, 16);
+  TEST_ASSERT_TRUE(moved != a);
+  TEST_ASSERT_EQUAL_STRING("abc", moved);
+  TEST_ASSERT_EQUAL(16 + 16 + 24, arena.used());
+}
+
+void test_exhausted_arena_falls_back_to_heap() {
+  MonotonicArena<64> arena;
+  void* a = arena.allocate(40);
+  void* b = arena.allocate(40);  // Doesn't fit
+  TEST_ASSERT_NOT_NULL(b);
+  TEST_ASSERT_EQUAL(1, arena.heapFallbacks());
+  TEST_ASSERT_EQUAL(48, arena.used());
+  b = arena.reallocate(b, 400);  // Stays on the heap
+  TEST_ASSERT_NOT_NULL(b);
+  arena.deallocate(b);
+  // The last arena block can't grow past the end either
+  void* c = arena.reallocate(a, 100);
+  TEST_ASSERT_NOT_NULL(c);
+  TEST_ASSERT_EQUAL(2, arena.heapFallbacks());
+  arena.deallocate(c);
+}
+
+// A full response through the firmware's filter fits the firmware's arena, with nothing left to the heap
+void test_onecall_fits_arena() {
+  static MonotonicArena<WEATHER_ARENA_SIZE> arena;
+  JsonDocument filter;
+  owmFilter(filter);
+  {
+    JsonDocument doc(&arena);
+    TextStream body(oneCallFixture);
+    DeserializationError err = deserializeJson(doc, body, DeserializationOption::Filter(filter));
+    TEST_ASSERT_TRUE(err == DeserializationError::Ok);
+    TEST_ASSERT_FALSE(doc.overflowed());
+    TEST_ASSERT_EQUAL_STRING("scattered clouds", doc["current"]["weather"][0]["description"].as<const char*>());
+    TEST_ASSERT_EQUAL(1720170000, doc["hourly"][47]["dt"].as<long>());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 28.4f, doc["daily"][7]["temp"]["max"].as<float>());
+    TEST_ASSERT_TRUE(doc["minutely"].isNull());  // Folded by JsonTap, not stored
+    TEST_ASSERT_TRUE(doc["alerts"].isNull());
+    TEST_ASSERT_TRUE(doc["hourly"][0]["feels_like"].isNull());
+  }
+  printf("  %u byte response, arena peak %u of %u bytes\n", (unsigned)strlen(oneCallFixture), (unsigned)arena.peak(),
+         (unsigned)arena.capacity());
+  TEST_ASSERT_EQUAL(0, arena.heapFallbacks());
+  TEST_ASSERT_GREATER_THAN(0, arena.peak());
+  arena.reset();
+  TEST_ASSERT_EQUAL(0, arena.used());
+}
+
+// An undersized arena still parses, the overflow goes to the heap and is counted
+void test_small_arena_counts_fallbacks() {
+  static MonotonicArena<2048> arena;
+  JsonDocument filter;
+  owmFilter(filter);
+  {
+    JsonDocument doc(&arena);
+    TextStream body(oneCallFixture, 7);
+    TEST_ASSERT_TRUE(deserializeJson(doc, body, DeserializationOption::Filter(filter)) == DeserializationError::Ok);
+    TEST_ASSERT_EQUAL(1720170000, doc["hourly"][47]["dt"].as<long>());
+  }
+  TEST_ASSERT_GREATER_THAN(0, arena.heapFallbacks());
+  arena.reset();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_blocks_bump_and_give_back_last);
+  RUN_TEST(test_reallocate_in_place_or_copy);
+  RUN_TEST(test_exhausted_arena_falls_back_to_heap);
+  RUN_TEST(test_onecall_fits_arena);
+  RUN_TEST(test_small_arena_counts_fallbacks);
+  return UNITY_END();
+}
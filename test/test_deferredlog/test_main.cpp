@@ -0,0 +1,93 @@
+#include <deferredLog.h>
+#include <unity.h>
+
+#include <string>
+
+// Collects drained records
+class Capture : public Print {
+ public:
+  std::string text;
+  size_t write(uint8_t c) override {
+    text += (char)c;
+    return 1;
+  }
+  using Print::write;
+  unsigned lines() {
+    unsigned n = 0;
+    for (char c : text) n += c == '\n';
+    return n;
+  }
+};
+
+Capture out;
+
+void setUp() {
+  deferredLog.drain(&out);  // Leave the ring empty between tests
+  out.text.clear();
+}
+void tearDown() {}
+
+void test_formats_typed_arguments() {
+  hostClockMicros = 12345000;
+  static const char name[] = "outdoor";
+  LOG_INFO("Tag %s: %d.%02u C, %.1f %%, 0x%04x", name, -3, 7u, 45.5f, 0xbeef);
+  deferredLog.drain(&out);
+  TEST_ASSERT_EQUAL_STRING("    12.345 I Tag outdoor: -3.07 C, 45.5 %, 0xbeef\r\n", out.text.c_str());
+}
+
+void test_levels_are_tagged() {
+  LOG_ERROR("e");
+  LOG_WARN("w");
+  deferredLog.drain(&out);
+  TEST_ASSERT_TRUE(out.text.find(" E e") != std::string::npos);
+  TEST_ASSERT_TRUE(out.text.find(" W w") != std::string::npos);
+}
+
+void test_records_keep_their_order() {
+  for (unsigned i = 0; i < 10; i++) LOG_INFO("record %u", i);
+  deferredLog.drain(&out);
+  TEST_ASSERT_EQUAL(10, out.lines());
+  size_t three = out.text.find("record 3");
+  size_t four = out.text.find("record 4");
+  TEST_ASSERT_TRUE(three != std::string::npos && four != std::string::npos && three < four);
+}
+
+void test_full_ring_drops_and_counts() {
+  for (unsigned i = 0; i < LOG_RING_SIZE + 5; i++) LOG_INFO("fill %u", i);
+  deferredLog.drain(&out);
+  TEST_ASSERT_EQUAL(LOG_RING_SIZE + 1, out.lines());
+  TEST_ASSERT_TRUE(out.text.find("Log: 5 records dropped") != std::string::npos);
+  TEST_ASSERT_TRUE(out.text.find("fill 63") != std::string::npos);
+  TEST_ASSERT_TRUE(out.text.find("fill 64") == std::string::npos);
+}
+
+// No Log task on the host: a full ring stays full until drained
+void test_wait_for_room() {
+  for (unsigned i = 0; i < LOG_RING_SIZE - 2; i++) LOG_INFO("fill %u", i);
+  TEST_ASSERT_TRUE(deferredLog.waitForRoom(2));
+  unsigned long start = millis();
+  TEST_ASSERT_FALSE(deferredLog.waitForRoom(3, 100));
+  TEST_ASSERT_TRUE(millis() - start >= 100);
+  deferredLog.drain(&out);
+  TEST_ASSERT_TRUE(deferredLog.waitForRoom(LOG_RING_SIZE));
+}
+
+void test_ring_wraps_over_many_laps() {
+  for (unsigned lap = 0; lap < 5; lap++) {
+    out.text.clear();
+    for (unsigned i = 0; i < LOG_RING_SIZE - 1; i++) LOG_INFO("lap %u %u", lap, i);
+    deferredLog.drain(&out);
+    TEST_ASSERT_EQUAL(LOG_RING_SIZE - 1, out.lines());
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_formats_typed_arguments);
+  RUN_TEST(test_levels_are_tagged);
+  RUN_TEST(test_records_keep_their_order);
+  RUN_TEST(test_full_ring_drops_and_counts);
+  RUN_TEST(test_ring_wraps_over_many_laps);
+  RUN_TEST(test_wait_for_room);
+  return UNITY_END();
+}
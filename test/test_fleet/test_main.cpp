@@ -0,0 +1,309 @@
+#include <fleet.h>
+#include <unity.h>
+
+#include <vector>
+
+// Stations talk over stub/WiFiUdp.h, an in-process multicast network, and keep time on the
+// virtual clock, so the timeouts below pass in microseconds of host time.
+
+#define LAT 41.85f
+#define LON -87.65f
+#define STEP_MS 100  // Poll period, as loop() runs
+
+// The datagram header as fleet.h documents it, to read and forge packets
+struct __attribute__((packed)) FleetHeader {
+  char magic[4];
+  uint8_t version;
+  uint8_t type;
+  uint16_t length;
+  uint32_t sender;
+  uint32_t group;
+  uint32_t sequence;
+  uint32_t crc;
+  uint8_t mac[16];
+};
+static_assert(sizeof(FleetHeader) == 40, "header layout differs from fleet.h");
+
+owmFetcher fetcher;
+
+// A Fleet and the model it fills, with the device id the fleet takes from the MAC
+struct Station {
+  Fleet fleet;
+  owmWeather weather;
+  int applied = 0;  // Snapshots taken from another station
+
+  explicit Station(uint32_t id) : weather("Chicago", LAT, LON, "key", fetcher) {
+    ESP.efuseMac = (uint64_t)id << 16;
+    fleet.begin(LAT, LON);
+  }
+  void poll() { applied += fleet.poll(&weather); }
+  float temp() {
+    WeatherSnapshot snap;
+    weather.toSnapshot(snap);
+    return snap.current.temp;
+  }
+};
+
+// Poll every station once a step for ms
+static void run(std::vector<Station*> stations, unsigned long ms) {
+  for (unsigned long t = 0; t < ms; t += STEP_MS) {
+    for (Station* station : stations) station->poll();
+    delay(STEP_MS);
+  }
+}
+
+// Distinct values in every part of the snapshot, strings short and zero padded
+static void makeSnapshot(WeatherSnapshot& snap, float temp) {
+  memset(&snap, 0, sizeof(snap));
+  snap.current.lon = LON;
+  snap.current.lat = LAT;
+  snap.current.weatherId = 500;
+  strcpy(snap.current.main, "Rain");
+  strcpy(snap.current.description, "light rain");
+  strcpy(snap.current.icon, "10n");
+  snap.current.temp = temp;
+  snap.current.pressure = 1009;
+  snap.current.humidity = 77;
+  snap.current.feelsLike = 18;
+  snap.current.windSpeed = 3.5f;
+  snap.current.windDeg = 270;
+  snap.current.clouds = 75;
+  snap.current.observationTime = 1720002034;
+  for (int i = 0; i < 8; i++) {
+    SnapshotDaily& d = snap.daily[i];
+    d.observationTime = 1720029600 + i * 86400;
+    d.tempMin = 10 + i;
+    d.tempMax = 20 + i;
+    d.weatherId = 800 + i;
+    strcpy(d.main, "Clear");
+    strcpy(d.description, i % 2 ? "clear sky" : "few clouds");
+    strcpy(d.icon, "01d");
+  }
+  snap.hourly.start = 1720000800;
+  snap.hourly.count = HOURLY_HOURS;
+  for (int i = 0; i < HOURLY_HOURS; i++) {
+    snap.hourly.temp[i] = 150 + i;
+    snap.hourly.weatherId[i] = 500 + i;
+    snap.hourly.clouds[i] = i;
+    snap.hourly.pop[i] = 2 * i;
+    snap.hourly.icon[i] = 20 + i % 3;
+    snap.hourly.rain[i] = i % 7;
+  }
+  snap.nowcast = {1720002000, 1720002600, 1720004400, 2.5f, 1.25f, 60};
+  snap.alertCount = 1;
+  strcpy(snap.alerts[0].event, "Flood Watch");
+  snap.alerts[0].start = 1720000000;
+  snap.alerts[0].end = 1720040000;
+  strcpy(snap.alerts[0].description, "Heavy rain may cause flooding.");
+}
+
+// Next datagram of the given type seen by a socket joined to the group
+static std::vector<uint8_t> capture(WiFiUDP& monitor, uint8_t type) {
+  std::vector<uint8_t> packet(2048);
+  int len;
+  while ((len = monitor.parsePacket()) > 0) {
+    monitor.read(packet.data(), packet.size());
+    if (len >= (int)sizeof(FleetHeader) && packet[5] == type) {
+      packet.resize(len);
+      return packet;
+    }
+  }
+  return {};
+}
+
+static void send(WiFiUDP& socket, const std::vector<uint8_t>& packet) {
+  socket.beginMulticastPacket();
+  socket.write(packet.data(), packet.size());
+  socket.endPacket();
+}
+
+static FleetHeader& headerOf(std::vector<uint8_t>& packet) { return *(FleetHeader*)packet.data(); }
+
+static void fixCrc(std::vector<uint8_t>& packet) {
+  FleetHeader& header = headerOf(packet);
+  header.crc = esp_rom_crc32_le(0, packet.data() + sizeof(FleetHeader), packet.size() - sizeof(FleetHeader));
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Stations booting one after another all settle on the lowest id, whatever the order
+void test_lowest_id_elected() {
+  Station c(0x300);
+  run({&c}, 1000);
+  TEST_ASSERT_TRUE(c.fleet.active());
+  TEST_ASSERT_TRUE(c.fleet.isLeader());
+
+  Station a(0x100);
+  Station b(0x200);
+  run({&a, &b, &c}, 1000);
+  TEST_ASSERT_TRUE(a.fleet.isLeader());
+  TEST_ASSERT_FALSE(b.fleet.isLeader());
+  TEST_ASSERT_FALSE(c.fleet.isLeader());
+
+  // Still so after many heartbeats
+  run({&a, &b, &c}, 5 * FLEET_HEARTBEAT_MS);
+  TEST_ASSERT_TRUE(a.fleet.isLeader());
+  TEST_ASSERT_FALSE(b.fleet.isLeader());
+  TEST_ASSERT_FALSE(c.fleet.isLeader());
+}
+
+// A leader that goes quiet is timed out and the next lowest id takes over, within
+// FLEET_TIMEOUT_MS of its last announce. It leads again when it comes back.
+void test_failover_after_timeout() {
+  Station a(0x100), b(0x200), c(0x300);
+  run({&a, &b, &c}, 1000);
+  TEST_ASSERT_TRUE(a.fleet.isLeader());
+
+  unsigned long stopped = millis();
+  while (!b.fleet.isLeader() && millis() - stopped < 2 * FLEET_TIMEOUT_MS) run({&b, &c}, STEP_MS);
+  unsigned long took = millis() - stopped;
+  printf("  new leader after %lu ms\n", took);
+  TEST_ASSERT_TRUE(b.fleet.isLeader());
+  // The last announce came up to a heartbeat before the leader stopped
+  TEST_ASSERT_GREATER_OR_EQUAL(FLEET_TIMEOUT_MS - FLEET_HEARTBEAT_MS, took);
+  TEST_ASSERT_LESS_OR_EQUAL(FLEET_TIMEOUT_MS + STEP_MS, took);
+  run({&b, &c}, 1000);
+  TEST_ASSERT_FALSE(c.fleet.isLeader());
+
+  run({&a, &b, &c}, 1000);
+  TEST_ASSERT_TRUE(a.fleet.isLeader());
+  TEST_ASSERT_FALSE(b.fleet.isLeader());
+  TEST_ASSERT_FALSE(c.fleet.isLeader());
+}
+
+// After FLEET_MISSED_FETCHES failed fetches in a row the leader stops announcing and is
+// timed out. It takes the new leader's snapshots, and its next good fetch makes it leader again.
+void test_stand_down_after_failed_fetches() {
+  Station a(0x100), b(0x200);
+  run({&a, &b}, 1000);
+  a.fleet.publish(a.weather);
+  run({&a, &b}, 1000);
+  TEST_ASSERT_EQUAL(1, b.applied);
+
+  for (int i = 1; i < FLEET_MISSED_FETCHES; i++) a.fleet.fetchFailed();
+  run({&a, &b}, FLEET_TIMEOUT_MS + 1000);
+  TEST_ASSERT_TRUE(a.fleet.isLeader());
+  TEST_ASSERT_FALSE(b.fleet.isLeader());
+
+  a.fleet.fetchFailed();
+  run({&a, &b}, FLEET_TIMEOUT_MS + STEP_MS);
+  TEST_ASSERT_TRUE(b.fleet.isLeader());
+
+  WeatherSnapshot snap;
+  makeSnapshot(snap, 12.5f);
+  b.weather.fromSnapshot(snap);
+  b.fleet.publish(b.weather);
+  run({&a, &b}, 1000);
+  TEST_ASSERT_EQUAL(1, a.applied);
+  TEST_ASSERT_EQUAL_FLOAT(12.5f, a.temp());
+
+  // A good fetch
+  a.fleet.publish(a.weather);
+  run({&a, &b}, 1000);
+  TEST_ASSERT_TRUE(a.fleet.isLeader());
+  TEST_ASSERT_FALSE(b.fleet.isLeader());
+  TEST_ASSERT_EQUAL(2, b.applied);
+}
+
+// A snapshot holds the whole model: into a model and out again gives the same bytes,
+// directly and through a datagram from the leader
+void test_snapshot_round_trip() {
+  WeatherSnapshot sent, back;
+  makeSnapshot(sent, 21.25f);
+  owmWeather weather("Chicago", LAT, LON, "key", fetcher);
+  weather.fromSnapshot(sent);
+  memset(&back, 0x55, sizeof(back));
+  weather.toSnapshot(back);
+  TEST_ASSERT_EQUAL(0, memcmp(&sent, &back, sizeof(sent)));
+
+  Station a(0x100), b(0x200);
+  run({&a, &b}, 1000);
+  a.weather.fromSnapshot(sent);
+  a.fleet.publish(a.weather);
+  run({&a, &b}, 1000);
+  TEST_ASSERT_EQUAL(1, b.applied);
+  memset(&back, 0x55, sizeof(back));
+  b.weather.toSnapshot(back);
+  TEST_ASSERT_EQUAL(0, memcmp(&sent, &back, sizeof(sent)));
+}
+
+// Datagrams altered on the way, or made up, are dropped: a bad CRC always, a bad mac
+// with FLEET_KEY. Without a key a packet with a good CRC is taken, as fleet.h warns.
+void test_bad_crc_and_mac_rejected() {
+  WiFiUDP monitor;
+  monitor.beginMulticast(FLEET_GROUP_IP, FLEET_PORT);
+  Station a(0x100), b(0x200);
+  run({&a, &b}, 1000);
+  WeatherSnapshot snap;
+  makeSnapshot(snap, 21.25f);
+  a.weather.fromSnapshot(snap);
+  a.fleet.publish(a.weather);
+  run({&a, &b}, 1000);
+  TEST_ASSERT_EQUAL(1, b.applied);
+
+  std::vector<uint8_t> packet = capture(monitor, 2);
+  TEST_ASSERT_EQUAL(sizeof(FleetHeader) + 1 + sizeof(WeatherSnapshot), packet.size());
+  TEST_ASSERT_EQUAL(0x100, headerOf(packet).sender);
+
+  // Newer sequence and a different temperature, CRC left as it was
+  std::vector<uint8_t> forged = packet;
+  headerOf(forged).sequence += 10;
+  WeatherSnapshot* payload = (WeatherSnapshot*)(forged.data() + sizeof(FleetHeader) + 1);
+  payload->current.temp = 45;
+  send(monitor, forged);
+  run({&a, &b}, 1000);
+  TEST_ASSERT_EQUAL(1, b.applied);
+  TEST_ASSERT_EQUAL_FLOAT(21.25f, b.temp());
+
+  // Cut short, with a CRC over what is left
+  std::vector<uint8_t> truncated(forged.begin(), forged.end() - 100);
+  fixCrc(truncated);
+  send(monitor, truncated);
+  run({&a, &b}, 1000);
+  TEST_ASSERT_EQUAL(1, b.applied);
+
+  // CRC fixed up
+  fixCrc(forged);
+  send(monitor, forged);
+  run({&a, &b}, 1000);
+#ifdef FLEET_KEY
+  TEST_ASSERT_EQUAL(1, b.applied);
+  TEST_ASSERT_EQUAL_FLOAT(21.25f, b.temp());
+#else
+  TEST_ASSERT_EQUAL(2, b.applied);
+  TEST_ASSERT_EQUAL_FLOAT(45.0f, b.temp());
+#endif
+
+  // An announce from a lower id than the leader's
+  std::vector<uint8_t> announce(packet.begin(), packet.begin() + sizeof(FleetHeader));
+  FleetHeader& header = headerOf(announce);
+  header.type = 1;
+  header.length = 0;
+  header.sender = 0x001;
+  header.sequence = 0;
+  memset(header.mac, 0, sizeof(header.mac));
+  header.crc = ~esp_rom_crc32_le(0, nullptr, 0);
+  send(monitor, announce);
+  run({&a, &b}, 1000);
+  TEST_ASSERT_TRUE(a.fleet.isLeader());
+
+  fixCrc(announce);
+  send(monitor, announce);
+  run({&a, &b}, 1000);
+#ifdef FLEET_KEY
+  TEST_ASSERT_TRUE(a.fleet.isLeader());
+#else
+  TEST_ASSERT_FALSE(a.fleet.isLeader());
+#endif
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_lowest_id_elected);
+  RUN_TEST(test_failover_after_timeout);
+  RUN_TEST(test_stand_down_after_failed_fetches);
+  RUN_TEST(test_snapshot_round_trip);
+  RUN_TEST(test_bad_crc_and_mac_rejected);
+  return UNITY_END();
+}
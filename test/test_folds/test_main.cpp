@@ -0,0 +1,226 @@
+#include <alerts.h>
+#include <arena.h>
+#include <jsonTap.h>
+#include <nowcast.h>
+#include <owmFilter.h>
+#include <unity.h>
+
+#include <chrono>
+#include <climits>
+
+#include "../fixtures/oneCall.h"
+
+// Response body served a few bytes per read, as from a network stream
+class TextStream : public Stream {
+ public:
+  explicit TextStream(const char* text) : _text(text) {}
+  int available() override { return _text[_at] ? 1 : 0; }
+  int peek() override { return _text[_at] ? (uint8_t)_text[_at] : -1; }
+  int read() override { return _text[_at] ? (uint8_t)_text[_at++] : -1; }
+  size_t readBytes(char* buffer, size_t length) override {
+    size_t n = 0;
+    while (n < length && n < 7 && _text[_at]) buffer[n++] = _text[_at++];
+    return n;
+  }
+  size_t write(uint8_t) override { return 0; }
+
+ private:
+  const char* _text;
+  size_t _at = 0;
+};
+
+// Read the whole response through the tap, in the mix of read() and readBytes() a parser makes
+void consume(JsonTap& tap) {
+  char buffer[16];
+  while (tap.available()) {
+    tap.read();
+    tap.readBytes(buffer, sizeof(buffer));
+  }
+}
+
+NowcastFold nowcast;
+AlertFold alerts;
+JsonTap tap;
+
+void setUp() {
+  nowcast.reset();
+  alerts.reset();
+}
+void tearDown() {}
+
+void test_nowcast_folds_minutely() {
+  TextStream body(
+      "{\"lat\":45,\"current\":{\"dt\":1000,\"precipitation\":9},\"minutely\":["
+      "{\"dt\":1000,\"precipitation\":0},{\"dt\":1060,\"precipitation\":0.05},"
+      "{\"dt\":1120,\"precipitation\":1.2},{\"dt\":1180,\"precipitation\":3.6},"
+      "{\"dt\":1240,\"precipitation\":0}],\"hourly\":[{\"dt\":5000,\"precipitation\":7}]}");
+  tap.begin(body);
+  tap.watch(nowcast);
+  consume(tap);
+  const Nowcast& n = nowcast.result();
+  TEST_ASSERT_EQUAL(1000, n.start);
+  TEST_ASSERT_EQUAL(1120, n.onset);
+  TEST_ASSERT_EQUAL(1240, n.stop);
+  TEST_ASSERT_EQUAL(5, n.minutes);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 3.6f, n.peak);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, (0.05f + 1.2f + 3.6f) / 60, n.total);
+
+  char text[48];
+  TEST_ASSERT_EQUAL_STRING("Rain in 2 min, up to 3.6 mm/h", n.describe(text, sizeof(text), 1000));
+  TEST_ASSERT_EQUAL_STRING("Rain stopping in 1 min", n.describe(text, sizeof(text), 1180));
+}
+
+void test_nowcast_dry_and_missing() {
+  TextStream dry("{\"minutely\":[{\"dt\":60,\"precipitation\":0},{\"dt\":120,\"precipitation\":0}]}");
+  tap.begin(dry);
+  tap.watch(nowcast);
+  consume(tap);
+  char text[48];
+  TEST_ASSERT_EQUAL_STRING("No rain next hour", nowcast.result().describe(text, sizeof(text), 60));
+
+  nowcast.reset();
+  TextStream none("{\"current\":{\"dt\":60}}");
+  tap.begin(none);
+  tap.watch(nowcast);
+  consume(tap);
+  TEST_ASSERT_EQUAL_STRING("", nowcast.result().describe(text, sizeof(text), 60));
+}
+
+void test_alerts_copy_and_clean_text() {
+  TextStream body(
+      "{\"alerts\":[{\"sender_name\":\"NWS Duluth\",\"event\":\"Winter \\\"Storm\\\" Warning\","
+      "\"start\":1700000000,\"end\":1700086400,"
+      "\"description\":\"Heavy   snow.\\nTravel \\u00e9 difficult\\\\\",\"tags\":[\"Snow\"]}]}");
+  tap.begin(body);
+  tap.watch(alerts);
+  consume(tap);
+  const AlertStore& store = alerts.result();
+  TEST_ASSERT_EQUAL(1, store.count);
+  TEST_ASSERT_EQUAL(0, store.dropped);
+  const WeatherAlert& a = store.alerts[0];
+  TEST_ASSERT_EQUAL_STRING("NWS Duluth", a.sender);
+  TEST_ASSERT_EQUAL_STRING("Winter 'Storm' Warning", a.event);
+  TEST_ASSERT_EQUAL_STRING("Heavy snow. Travel ? difficult/", a.description);
+  TEST_ASSERT_EQUAL_UINT32(1700000000, a.start);
+  TEST_ASSERT_EQUAL_UINT32(1700086400, a.end);
+  TEST_ASSERT_FALSE(a.truncated);
+  TEST_ASSERT_EQUAL_PTR(&a, store.current(1700000100));
+  TEST_ASSERT_NULL(store.current(1700086401));
+}
+
+void test_alerts_bounded() {
+  std::string json = "{\"alerts\":[";
+  for (int i = 0; i < ALERT_CAPACITY + 2; i++) {
+    if (i) json += ",";
+    json += "{\"event\":\"E" + std::to_string(i) + "\",\"start\":" + std::to_string(100 + i) +
+            ",\"description\":\"" + std::string(3 * ALERT_DESCRIPTION_SIZE, 'x') + "\"}";
+  }
+  json += "]}";
+  TextStream body(json.c_str());
+  tap.begin(body);
+  tap.watch(alerts);
+  consume(tap);
+  const AlertStore& store = alerts.result();
+  TEST_ASSERT_EQUAL(ALERT_CAPACITY, store.count);
+  TEST_ASSERT_EQUAL(2, store.dropped);
+  TEST_ASSERT_EQUAL_STRING("E2", store.alerts[2].event);
+  TEST_ASSERT_EQUAL(ALERT_DESCRIPTION_SIZE - 1, strlen(store.alerts[0].description));
+  TEST_ASSERT_TRUE(store.alerts[0].truncated);
+
+  // One more dropped alert changes the banner's "(+n)"
+  AlertStore more = store;
+  TEST_ASSERT_TRUE(more.sameAs(store));
+  more.dropped++;
+  TEST_ASSERT_FALSE(more.sameAs(store));
+}
+
+void test_two_listeners_share_one_pass() {
+  TextStream body(
+      "{\"minutely\":[{\"dt\":60,\"precipitation\":0.5}],"
+      "\"alerts\":[{\"event\":\"Frost\",\"start\":1,\"end\":0,\"description\":\"Cold\"}]}");
+  tap.begin(body);
+  tap.watch(nowcast);
+  tap.watch(alerts);
+  consume(tap);
+  TEST_ASSERT_EQUAL(60, nowcast.result().onset);
+  TEST_ASSERT_EQUAL(1, alerts.result().count);
+  TEST_ASSERT_EQUAL_STRING("Frost", alerts.result().alerts[0].event);
+  TEST_ASSERT_EQUAL(strlen("{\"minutely\":[{\"dt\":60,\"precipitation\":0.5}],") +
+                        strlen("\"alerts\":[{\"event\":\"Frost\",\"start\":1,\"end\":0,\"description\":\"Cold\"}]}"),
+                    tap.scannedBytes());
+}
+
+// Parse the fixture with the filter, through the tap or not. Returns the fastest of a few
+// runs in microseconds; arena holds the document, its peak is the parse's heap.
+template <size_t N>
+static long timedParse(const JsonDocument& filter, MonotonicArena<N>& arena, bool tapped) {
+  long best = LONG_MAX;
+  for (int run = 0; run < 20; run++) {
+    arena.reset();
+    nowcast.reset();
+    alerts.reset();
+    auto start = std::chrono::steady_clock::now();
+    {
+      JsonDocument doc(&arena);
+      TextStream body(oneCallFixture);
+      Stream* source = &body;
+      if (tapped) {
+        tap.begin(body);
+        tap.watch(nowcast);
+        tap.watch(alerts);
+        source = &tap;
+      }
+      TEST_ASSERT_TRUE(deserializeJson(doc, *source, DeserializationOption::Filter(filter)) == DeserializationError::Ok);
+    }
+    long took = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    if (took < best) best = took;
+  }
+  return best;
+}
+
+// What the folds cost over the firmware's filter alone, on the full OneCall fixture: no more
+// document, under a kilobyte of fold state, and the time to scan each byte once more.
+// Keeping 'minutely' and 'alerts' in the document instead is shown for comparison.
+void test_fold_cost_against_filter() {
+  static MonotonicArena<2 * WEATHER_ARENA_SIZE> arena;
+  JsonDocument filter;
+  owmFilter(filter);
+
+  long plainTime = timedParse(filter, arena, false);
+  size_t plainPeak = arena.peak();
+  long tappedTime = timedParse(filter, arena, true);
+  size_t tappedPeak = arena.peak();
+  TEST_ASSERT_EQUAL(61, nowcast.result().minutes);
+  TEST_ASSERT_EQUAL(2, alerts.result().count);
+  TEST_ASSERT_EQUAL(plainPeak, tappedPeak);  // Folded data never reaches the document
+
+  JsonDocument keepAll;
+  owmFilter(keepAll);
+  keepAll["minutely"][0]["dt"] = true;
+  keepAll["minutely"][0]["precipitation"] = true;
+  keepAll["alerts"][0]["event"] = true;
+  keepAll["alerts"][0]["start"] = true;
+  keepAll["alerts"][0]["end"] = true;
+  keepAll["alerts"][0]["description"] = true;
+  timedParse(keepAll, arena, false);
+  size_t keepAllPeak = arena.peak();
+  TEST_ASSERT_GREATER_THAN(plainPeak, keepAllPeak);
+  TEST_ASSERT_EQUAL(0, arena.heapFallbacks());
+
+  printf("  filter alone:      %ld us, document %u bytes\n", plainTime, (unsigned)plainPeak);
+  printf("  filter + folds:    %ld us, document %u bytes, fold state %u bytes\n", tappedTime, (unsigned)tappedPeak,
+         (unsigned)(sizeof(JsonTap) + sizeof(NowcastFold) + sizeof(AlertFold)));
+  printf("  minutely + alerts in the document: %u bytes\n", (unsigned)keepAllPeak);
+  arena.reset();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_nowcast_folds_minutely);
+  RUN_TEST(test_nowcast_dry_and_missing);
+  RUN_TEST(test_alerts_copy_and_clean_text);
+  RUN_TEST(test_alerts_bounded);
+  RUN_TEST(test_two_listeners_share_one_pass);
+  RUN_TEST(test_fold_cost_against_filter);
+  return UNITY_END();
+}
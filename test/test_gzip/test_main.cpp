@@ -0,0 +1,154 @@
+#include <gzipStream.h>
+#include <unity.h>
+
+#include <string>
+#include <vector>
+
+#include "../fixtures/gzip.h"
+#include "../fixtures/oneCall.h"
+
+// Compressed body served a few bytes per read, as from a network stream
+class ByteStream : public Stream {
+ public:
+  ByteStream(const uint8_t* data, size_t size, size_t chunk = 61) : _data(data), _size(size), _chunk(chunk) {}
+  int available() override { return _size - _at; }
+  int peek() override { return _at < _size ? _data[_at] : -1; }
+  int read() override { return _at < _size ? _data[_at++] : -1; }
+  size_t readBytes(char* buffer, size_t length) override {
+    size_t n = 0;
+    while (n < length && n < _chunk && _at < _size) buffer[n++] = _data[_at++];
+    return n;
+  }
+  size_t write(uint8_t) override { return 0; }
+
+ private:
+  const uint8_t* _data;
+  size_t _size;
+  size_t _chunk;
+  size_t _at = 0;
+};
+
+static std::string readAll(GzipStream& gzip, size_t readSize) {
+  std::string out;
+  std::vector<char> buffer(readSize);
+  size_t n;
+  while ((n = gzip.readBytes(buffer.data(), readSize)) > 0) out.append(buffer.data(), n);
+  return out;
+}
+
+static std::string oneCallTimesThree() { return std::string(oneCallFixture) + oneCallFixture + oneCallFixture; }
+
+// Body with the byte at 'at' changed
+static std::vector<uint8_t> corrupted(size_t at) {
+  std::vector<uint8_t> body(oneCallGzip, oneCallGzip + sizeof(oneCallGzip));
+  body[at] ^= 0x55;
+  return body;
+}
+
+GzipStream gzip;
+
+void setUp() { TEST_ASSERT_TRUE(gzip.reserve()); }
+void tearDown() { gzip.release(); }
+
+// FEXTRA, FNAME, FCOMMENT and FHCRC are skipped, the body starts right after them
+void test_optional_header_fields_skipped() {
+  ByteStream body(headerGzip, sizeof(headerGzip));
+  gzip.begin(body);
+  TEST_ASSERT_EQUAL_STRING(headerGzipText, readAll(gzip, 16).c_str());
+  TEST_ASSERT_TRUE(gzip.finish());
+  TEST_ASSERT_EQUAL(strlen(headerGzipText), gzip.decodedBytes());
+  TEST_ASSERT_EQUAL(sizeof(headerGzip), gzip.wireBytes());
+}
+
+// Output nearly twice the size of the window: it wraps, and deflate's back references reach
+// into the previous copy of the response, across the wrap
+void test_output_larger_than_window() {
+  std::string expected = oneCallTimesThree();
+  TEST_ASSERT_GREATER_THAN(TINFL_LZ_DICT_SIZE, expected.size());
+
+  ByteStream body(oneCallGzip, sizeof(oneCallGzip));
+  gzip.begin(body);
+  std::string out = readAll(gzip, 1000);
+  TEST_ASSERT_EQUAL(expected.size(), out.size());
+  TEST_ASSERT_TRUE(out == expected);
+  TEST_ASSERT_TRUE(gzip.finish());
+  TEST_ASSERT_EQUAL(expected.size(), gzip.decodedBytes());
+  TEST_ASSERT_EQUAL(sizeof(oneCallGzip), gzip.wireBytes());
+
+  // A byte at a time from the source and to the reader, with peek() between reads
+  ByteStream trickle(oneCallGzip, sizeof(oneCallGzip), 1);
+  gzip.begin(trickle);
+  out.clear();
+  for (int c = gzip.peek(); c >= 0; c = gzip.peek()) {
+    TEST_ASSERT_EQUAL(c, gzip.read());
+    out += (char)c;
+  }
+  TEST_ASSERT_TRUE(out == expected);
+  TEST_ASSERT_TRUE(gzip.finish());
+}
+
+// A body cut anywhere, header, deflate data or trailer, fails. What was decoded is a prefix.
+void test_truncated_body_fails() {
+  std::string expected = oneCallTimesThree();
+  const size_t cuts[] = {0, 5, 20, 100, sizeof(oneCallGzip) / 2, sizeof(oneCallGzip) - 8, sizeof(oneCallGzip) - 3};
+  for (size_t cut : cuts) {
+    ByteStream body(oneCallGzip, cut);
+    gzip.begin(body);
+    std::string out = readAll(gzip, 512);
+    TEST_ASSERT_TRUE(out.size() < expected.size() || cut >= sizeof(oneCallGzip) - 8);
+    TEST_ASSERT_TRUE(expected.compare(0, out.size(), out) == 0);
+    TEST_ASSERT_FALSE(gzip.finish());
+    TEST_ASSERT_EQUAL(-1, gzip.read());
+  }
+}
+
+// Every byte decodes, but a trailer that doesn't match the data fails finish()
+void test_bad_trailer_fails() {
+  std::string expected = oneCallTimesThree();
+  const size_t crcByte = sizeof(oneCallGzip) - 8, lengthByte = sizeof(oneCallGzip) - 2;
+  for (size_t at : {crcByte, crcByte + 3, lengthByte}) {
+    std::vector<uint8_t> bad = corrupted(at);
+    ByteStream body(bad.data(), bad.size());
+    gzip.begin(body);
+    TEST_ASSERT_TRUE(readAll(gzip, 4096) == expected);
+    TEST_ASSERT_FALSE(gzip.finish());
+    TEST_ASSERT_FALSE(gzip.failed());  // Inflated to the end
+  }
+}
+
+// Damaged deflate data is either rejected by the inflater or caught by the CRC
+void test_corrupt_body_fails() {
+  for (size_t at : {(size_t)40, sizeof(oneCallGzip) / 3, sizeof(oneCallGzip) - 20}) {
+    std::vector<uint8_t> bad = corrupted(at);
+    ByteStream body(bad.data(), bad.size());
+    gzip.begin(body);
+    TEST_ASSERT_FALSE(gzip.finish());
+  }
+
+  // Not gzip at all
+  ByteStream json((const uint8_t*)headerGzipText, strlen(headerGzipText));
+  gzip.begin(json);
+  TEST_ASSERT_EQUAL(-1, gzip.read());
+  TEST_ASSERT_TRUE(gzip.failed());
+}
+
+// Without reserve() there is no window, nothing is decoded
+void test_begin_without_reserve_fails() {
+  gzip.release();
+  ByteStream body(headerGzip, sizeof(headerGzip));
+  gzip.begin(body);
+  TEST_ASSERT_EQUAL(-1, gzip.read());
+  TEST_ASSERT_FALSE(gzip.finish());
+  TEST_ASSERT_EQUAL(0, gzip.wireBytes());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_optional_header_fields_skipped);
+  RUN_TEST(test_output_larger_than_window);
+  RUN_TEST(test_truncated_body_fails);
+  RUN_TEST(test_bad_trailer_fails);
+  RUN_TEST(test_corrupt_body_fails);
+  RUN_TEST(test_begin_without_reserve_fails);
+  return UNITY_END();
+}
@@ -0,0 +1,118 @@
+#include <heapTracker.h>
+#include <unity.h>
+
+#ifndef HEAP_TRACKER
+#error "Build with HEAP_TRACKER and the --wrap link flags: pio test -e native-heaptrace"
+#endif
+
+// Two allocation sites. The empty asm keeps each malloc() an ordinary call, not a tail
+// call, so it returns into its own function.
+__attribute__((noinline)) void* allocAtA(size_t size) {
+  void* ptr = malloc(size);
+  asm volatile("" ::: "memory");
+  return ptr;
+}
+__attribute__((noinline)) void* allocAtB(size_t size) {
+  void* ptr = malloc(size);
+  asm volatile("" ::: "memory");
+  return ptr;
+}
+__attribute__((noinline)) void* reallocAtB(void* ptr, size_t size) {
+  ptr = realloc(ptr, size);
+  asm volatile("" ::: "memory");
+  return ptr;
+}
+
+void* blocksA[HEAP_TRACKER_LEAK_STREAK + 2];
+void* blocksB[4];
+
+void setUp() {}
+void tearDown() {}
+
+void test_sites_counted_apart() {
+  uint32_t allocs = heapTracker.totalAllocs();
+  int32_t live = heapTracker.totalLiveBytes();
+  for (int i = 0; i < 3; i++) blocksA[i] = allocAtA(100);
+  for (int i = 0; i < 2; i++) blocksB[i] = allocAtB(40);
+
+  HeapTracker::Site a = heapTracker.siteOf(blocksA[0]), b = heapTracker.siteOf(blocksB[0]);
+  TEST_ASSERT_TRUE(a.pc != 0 && b.pc != 0 && a.pc != b.pc);
+  TEST_ASSERT_TRUE(heapTracker.siteOf(blocksA[2]).pc == a.pc);
+  TEST_ASSERT_EQUAL(3, a.allocs);
+  TEST_ASSERT_EQUAL(300, a.liveBytes);
+  TEST_ASSERT_EQUAL(2, b.allocs);
+  TEST_ASSERT_EQUAL(80, b.liveBytes);
+  TEST_ASSERT_EQUAL(allocs + 5, heapTracker.totalAllocs());
+  TEST_ASSERT_EQUAL(live + 380, heapTracker.totalLiveBytes());
+
+  free(blocksA[1]);
+  free(blocksA[2]);
+  free(blocksB[1]);
+  a = heapTracker.siteOf(blocksA[0]);
+  TEST_ASSERT_EQUAL(2, a.frees);
+  TEST_ASSERT_EQUAL(100, a.liveBytes);
+  TEST_ASSERT_EQUAL(300, a.peakLiveBytes);
+  TEST_ASSERT_EQUAL(40, heapTracker.siteOf(blocksB[0]).liveBytes);
+
+  free(blocksA[0]);
+  free(blocksB[0]);
+  TEST_ASSERT_EQUAL(live, heapTracker.totalLiveBytes());
+  TEST_ASSERT_EQUAL(0, heapTracker.siteOf(blocksA[0]).pc);  // Freed, no longer tracked
+}
+
+// A resized block moves to the caller of realloc(), calloc() zeroes, new is tracked too
+void test_realloc_calloc_new() {
+  char* ptr = (char*)allocAtA(10);
+  strcpy(ptr, "tracked");
+  uint32_t aFrees = heapTracker.siteOf(ptr).frees;
+  blocksA[0] = allocAtA(1);  // Keeps site A readable
+  ptr = (char*)reallocAtB(ptr, 1000);
+  TEST_ASSERT_EQUAL_STRING("tracked", ptr);
+  HeapTracker::Site b = heapTracker.siteOf(ptr);
+  TEST_ASSERT_EQUAL(1000, b.liveBytes);
+  TEST_ASSERT_TRUE(b.pc != heapTracker.siteOf(blocksA[0]).pc);
+  TEST_ASSERT_EQUAL(aFrees + 1, heapTracker.siteOf(blocksA[0]).frees);
+  TEST_ASSERT_NULL(realloc(ptr, 0));  // Frees
+  free(blocksA[0]);
+
+  uint8_t* zeroed = (uint8_t*)calloc(16, 4);
+  TEST_ASSERT_EQUAL(64, heapTracker.siteOf(zeroed).liveBytes);
+  for (int i = 0; i < 64; i++) TEST_ASSERT_EQUAL(0, zeroed[i]);
+  free(zeroed);
+  volatile size_t huge = SIZE_MAX / 2;
+  TEST_ASSERT_NULL(calloc(huge, 4));  // Overflows
+
+  int32_t* number = new int32_t(5);
+  TEST_ASSERT_EQUAL(4, heapTracker.siteOf(number).liveBytes);
+  delete number;
+
+  // Blocks the tracker didn't hand out pass through
+  char local[16];
+  TEST_ASSERT_EQUAL(0, heapTracker.siteOf(local + 1).pc);
+}
+
+// A site growing at every sample is flagged after HEAP_TRACKER_LEAK_STREAK samples, one that
+// allocates and frees as much never is, and the flag clears once the site stops growing
+void test_growing_site_flagged() {
+  blocksB[0] = allocAtB(64);
+  for (int i = 0; i < HEAP_TRACKER_LEAK_STREAK; i++) {
+    blocksA[i] = allocAtA(64);
+    free(allocAtB(64));
+    heapTracker.sample();
+    TEST_ASSERT_EQUAL(i + 1 >= HEAP_TRACKER_LEAK_STREAK, heapTracker.isLeakSuspect(heapTracker.siteOf(blocksA[0])));
+    TEST_ASSERT_FALSE(heapTracker.isLeakSuspect(heapTracker.siteOf(blocksB[0])));
+  }
+  heapTracker.sample();
+  TEST_ASSERT_FALSE(heapTracker.isLeakSuspect(heapTracker.siteOf(blocksA[0])));
+
+  for (int i = 0; i < HEAP_TRACKER_LEAK_STREAK; i++) free(blocksA[i]);
+  free(blocksB[0]);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_sites_counted_apart);
+  RUN_TEST(test_realloc_calloc_new);
+  RUN_TEST(test_growing_site_flagged);
+  return UNITY_END();
+}
@@ -0,0 +1,197 @@
+#include <settings.h>
+#include <localtime.h>
+#include <unity.h>
+
+#include <chrono>
+
+static const char* usCentral = "CST6CDT,M3.2.0,M11.1.0";
+static const char* euCentral = "CET-1CEST,M3.5.0,M10.5.0/3";
+static const char* sydney = "AEST-10AEDT,M10.1.0,M4.1.0/3";
+
+static time_t utc(int y, int m, int d, int h, int min = 0, int s = 0) {
+  return (time_t)TzConverter::daysFromCivil(y, m, d) * 86400 + h * 3600 + min * 60 + s;
+}
+
+static void useLibcTz(const char* tz) {
+  setenv("TZ", tz, 1);
+  tzset();
+}
+
+static void assertLocal(TzConverter& tz, time_t t, int hour, int minute, bool isDst) {
+  LocalTm lt;
+  tz.toLocal(t, &lt);
+  TEST_ASSERT_EQUAL(hour, lt.hour);
+  TEST_ASSERT_EQUAL(minute, lt.minute);
+  TEST_ASSERT_EQUAL(isDst, lt.isDst);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_days_from_civil() {
+  TEST_ASSERT_EQUAL(0, TzConverter::daysFromCivil(1970, 1, 1));
+  TEST_ASSERT_TRUE(utc(2024, 1, 1, 0) == 1704067200);
+  TEST_ASSERT_TRUE(utc(2024, 3, 10, 8) == 1710057600);
+  TEST_ASSERT_EQUAL(-1, TzConverter::daysFromCivil(1969, 12, 31));
+}
+
+// 2024: CDT from 2:00 CST on March 10 to 2:00 CDT on November 3
+void test_us_transitions() {
+  TzConverter tz(usCentral);
+  TEST_ASSERT_TRUE(tz.valid());
+  time_t start = utc(2024, 3, 10, 8), end = utc(2024, 11, 3, 7);
+  TEST_ASSERT_EQUAL(-6 * 3600, tz.utcOffset(start - 1));
+  TEST_ASSERT_EQUAL(-5 * 3600, tz.utcOffset(start));
+  TEST_ASSERT_EQUAL(-5 * 3600, tz.utcOffset(end - 1));
+  TEST_ASSERT_EQUAL(-6 * 3600, tz.utcOffset(end));
+
+  // 2:00-2:59 never happens in March
+  assertLocal(tz, start - 1, 1, 59, false);
+  assertLocal(tz, start, 3, 0, true);
+  // 1:00-1:59 happens twice in November, first in CDT
+  assertLocal(tz, end - 1800, 1, 30, true);
+  assertLocal(tz, end + 1800, 1, 30, false);
+}
+
+// 2024: CEST from 2:00 CET on March 31 to 3:00 CEST on October 27, both at 01:00 UTC
+void test_eu_transitions() {
+  TzConverter tz(euCentral);
+  time_t start = utc(2024, 3, 31, 1), end = utc(2024, 10, 27, 1);
+  assertLocal(tz, start - 1, 1, 59, false);
+  assertLocal(tz, start, 3, 0, true);
+  assertLocal(tz, end - 1800, 2, 30, true);
+  assertLocal(tz, end + 1800, 2, 30, false);
+  TEST_ASSERT_EQUAL(3600, tz.utcOffset(utc(2024, 1, 15, 12)));
+  TEST_ASSERT_EQUAL(7200, tz.utcOffset(utc(2024, 7, 15, 12)));
+}
+
+// DST spans the new year: AEDT until 3:00 on April 7, again from 2:00 AEST on October 6
+void test_southern_transitions() {
+  TzConverter tz(sydney);
+  time_t end = utc(2024, 4, 6, 16), start = utc(2024, 10, 5, 16);
+  TEST_ASSERT_EQUAL(11 * 3600, tz.utcOffset(utc(2024, 1, 15, 0)));
+  TEST_ASSERT_EQUAL(10 * 3600, tz.utcOffset(utc(2024, 7, 15, 0)));
+  TEST_ASSERT_EQUAL(11 * 3600, tz.utcOffset(utc(2024, 12, 31, 23)));
+  assertLocal(tz, end - 1800, 2, 30, true);
+  assertLocal(tz, end + 1800, 2, 30, false);
+  assertLocal(tz, start - 1, 1, 59, false);
+  assertLocal(tz, start, 3, 0, true);
+
+  // The local date is ahead of UTC across the year boundary
+  LocalTm lt;
+  tz.toLocal(utc(2024, 12, 31, 14), &lt);
+  TEST_ASSERT_EQUAL(2025, lt.year);
+  TEST_ASSERT_EQUAL(1, lt.month);
+  TEST_ASSERT_EQUAL(1, lt.mday);
+  TEST_ASSERT_EQUAL(1, lt.hour);
+}
+
+void test_transition_after() {
+  TzConverter us(usCentral);
+  time_t start = utc(2024, 3, 10, 8), end = utc(2024, 11, 3, 7);
+  TEST_ASSERT_TRUE(us.transitionAfter(utc(2024, 1, 1, 0)) == start);
+  TEST_ASSERT_TRUE(us.transitionAfter(start - 1) == start);
+  TEST_ASSERT_TRUE(us.transitionAfter(start) == end);  // Strictly after
+  TEST_ASSERT_TRUE(us.transitionAfter(end) == utc(2025, 3, 9, 8));
+
+  TzConverter south(sydney);
+  TEST_ASSERT_TRUE(south.transitionAfter(utc(2024, 1, 1, 0)) == utc(2024, 4, 6, 16));
+  TEST_ASSERT_TRUE(south.transitionAfter(utc(2024, 4, 6, 16)) == utc(2024, 10, 5, 16));
+  TEST_ASSERT_TRUE(south.transitionAfter(utc(2024, 10, 5, 16)) == utc(2025, 4, 5, 16));
+
+  TzConverter plain("UTC0");
+  TEST_ASSERT_TRUE(plain.transitionAfter(start) == 0);
+  TzConverter broken("C");
+  TEST_ASSERT_FALSE(broken.valid());
+  TEST_ASSERT_EQUAL(0, broken.utcOffset(start));
+}
+
+// format() against glibc's localtime_r() and strftime() every 7919 s of a leap year, both sides of it
+void test_format_matches_strftime() {
+  const char* zones[] = {usCentral, euCentral, sydney, "<+0530>-5:30", "NZST-12NZDT,M9.5.0,M4.1.0/3",
+                         "XST3XDT,J60/1:30,J300", "YST-2YDT,59/0,300/23"};
+  const char* fmt = "%a %b %d %e %H:%M:%S %I %p %m/%y %Y %%";
+  for (const char* zone : zones) {
+    TzConverter tz(zone);
+    TEST_ASSERT_TRUE(tz.valid());
+    useLibcTz(zone);
+    uint32_t mismatches = 0;
+    for (time_t t = utc(2023, 12, 25, 0); t < utc(2025, 1, 7, 0); t += 7919) {
+      char ours[64], theirs[64];
+      struct tm tm;
+      localtime_r(&t, &tm);
+      strftime(theirs, sizeof(theirs), fmt, &tm);
+      size_t n = tz.format(ours, sizeof(ours), t, fmt);
+      if (strcmp(ours, theirs) != 0 || n != strlen(theirs)) {
+        if (!mismatches++) printf("  %s at %lld: \"%s\", strftime \"%s\"\n", zone, (long long)t, ours, theirs);
+      }
+    }
+    TEST_ASSERT_EQUAL(0, mismatches);
+  }
+
+  // Output is cut at the buffer, always terminated
+  TzConverter tz(usCentral);
+  char small[6];
+  TEST_ASSERT_EQUAL(5, tz.format(small, sizeof(small), utc(2024, 7, 4, 17), "%H:%M:%S"));
+  TEST_ASSERT_EQUAL_STRING("12:00", small);
+}
+
+// Host wall time per call, as in test_psychro
+template <typename Sweep>
+double nanosPerCall(Sweep sweep) {
+  const int repeats = 20;
+  uint32_t calls = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeats; i++) calls += sweep();
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / calls;
+}
+
+void test_throughput_against_localtime_r() {
+  TzConverter tz(usCentral);
+  useLibcTz(usCentral);
+  volatile int sink = 0;
+  auto sweep = [&](auto convert) {
+    return nanosPerCall([&] {
+      uint32_t calls = 0;
+      for (time_t t = utc(2024, 1, 1, 0); t < utc(2025, 1, 1, 0); t += 3607, calls++) sink = sink + convert(t);
+      return calls;
+    });
+  };
+  double ours = sweep([&](time_t t) {
+    LocalTm lt;
+    tz.toLocal(t, &lt);
+    return lt.hour;
+  });
+  double libc = sweep([](time_t t) {
+    struct tm tm;
+    localtime_r(&t, &tm);
+    return tm.tm_hour;
+  });
+  double ourFormat = sweep([&](time_t t) {
+    char buffer[16];
+    return (int)tz.format(buffer, sizeof(buffer), t, "%I:%M %p");
+  });
+  double libcFormat = sweep([](time_t t) {
+    char buffer[16];
+    struct tm tm;
+    localtime_r(&t, &tm);
+    return (int)strftime(buffer, sizeof(buffer), "%I:%M %p", &tm);
+  });
+  printf("  toLocal: %.1f ns/call, localtime_r %.1f ns/call (%.1fx)\n", ours, libc, libc / ours);
+  printf("  format : %.1f ns/call, localtime_r + strftime %.1f ns/call (%.1fx)\n", ourFormat, libcFormat,
+         libcFormat / ourFormat);
+  TEST_ASSERT_TRUE(sink != 0);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_days_from_civil);
+  RUN_TEST(test_us_transitions);
+  RUN_TEST(test_eu_transitions);
+  RUN_TEST(test_southern_transitions);
+  RUN_TEST(test_transition_after);
+  RUN_TEST(test_format_matches_strftime);
+  RUN_TEST(test_throughput_against_localtime_r);
+  return UNITY_END();
+}
@@ -0,0 +1,171 @@
+#ifndef SIMDISPLAY_H
+#define SIMDISPLAY_H
+
+/*----------------------------------------------------------------
+  SimDisplay: a Nextion behind a simulated serial port
+
+    Bytes written take their UART time on the virtual clock at the port's
+    rate. A command is executed when its terminator arrives, if the display
+    is listening at the same rate; anything else is garbage to the display
+    and is dropped. Replies follow the bkcmd
+    level in force, as on the display:
+
+      get dp / get <name>   0x71 + value
+      get <number>          0x71 + the number
+      get rtc0..rtc5        0x71 + year, month, day, hour, minute, second of rtc
+      baud= / bauds=        switch rate (bauds= is also kept over a reset),
+                            invalid baud (0x11) above maxBaud
+      bkcmd=                return code level
+      rest                  reset: bkcmd=2, stored rate, 00 00 00 and 88 frames
+      bad...                invalid variable (0x1A)
+      anything else         executed, name=value kept in values
+
+    Faults: dropCommands loses the next commands on the wire, dropAcks
+    executes them but loses their return codes, lateAcks holds their return
+    codes back until the display next replies to anything. rtcTickAfter
+    moves the clock on a second once that many more RTC registers are read.
+*/
+
+#include <Arduino.h>
+#include <ctype.h>
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+class SimDisplay : public HardwareSerial {
+ public:
+  unsigned long displayBaud;
+  unsigned long storedBaud;
+  unsigned long maxBaud = 921600;  // Fastest rate the display accepts
+  uint8_t bkcmd = 2;
+  int32_t page = 0;
+  time_t rtc = 0;  // Display clock, read through rtc0..rtc5
+  uint16_t rtcTickAfter = 0;
+
+  uint16_t dropCommands = 0;
+  uint16_t dropAcks = 0;
+  uint16_t lateAcks = 0;
+
+  std::vector<std::string> executed;
+  std::map<std::string, std::string> values;
+  uint64_t linkMicros = 0;  // UART time of bytes written
+
+  explicit SimDisplay(unsigned long baud) : displayBaud(baud), storedBaud(baud), _hostBaud(baud) {}
+
+  void begin(unsigned long baud, uint32_t, int8_t, int8_t) override { _hostBaud = baud; }
+  void updateBaudRate(unsigned long baud) override { _hostBaud = baud; }
+  unsigned long hostBaud() { return _hostBaud; }
+
+  int available() override { return _rx.size(); }
+  int peek() override { return _rx.empty() ? -1 : _rx.front(); }
+  int read() override {
+    if (_rx.empty()) return -1;
+    uint8_t c = _rx.front();
+    _rx.pop_front();
+    return c;
+  }
+
+  size_t write(uint8_t c) override {
+    uint64_t micros = 10000000ULL / _hostBaud;
+    hostClockMicros += micros;
+    linkMicros += micros;
+    _command += (char)c;
+    _terminators = c == 0xFF ? _terminators + 1 : 0;
+    if (_terminators == 3) {
+      std::string command = _command.substr(0, _command.length() - 3);
+      _command.clear();
+      _terminators = 0;
+      if (_hostBaud == displayBaud) execute(command);
+    }
+    return 1;
+  }
+  using Print::write;
+
+  // Display side events
+  void reset() {
+    bkcmd = 2;
+    displayBaud = storedBaud;
+    reply({0x00, 0x00, 0x00});
+    reply({0x88});
+  }
+  void event(uint8_t code) { reply({code}); }
+
+ private:
+  unsigned long _hostBaud;
+  std::string _command;
+  uint8_t _terminators = 0;
+  std::deque<uint8_t> _rx;
+  std::vector<uint8_t> _late;
+
+  void reply(std::vector<uint8_t> frame) {
+    if (_hostBaud != displayBaud) return;  // Garbage to the host
+    std::vector<uint8_t> late;
+    late.swap(_late);
+    for (uint8_t code : late) reply({code});
+    for (uint8_t c : frame) _rx.push_back(c);
+    for (int i = 0; i < 3; i++) _rx.push_back(0xFF);
+  }
+
+  int32_t rtcRegister(int index) {
+    struct tm fields;
+    gmtime_r(&rtc, &fields);
+    const int32_t registers[] = {fields.tm_year + 1900, fields.tm_mon + 1, fields.tm_mday,
+                                 fields.tm_hour,        fields.tm_min,     fields.tm_sec};
+    if (rtcTickAfter && !--rtcTickAfter) rtc++;
+    return index >= 0 && index < 6 ? registers[index] : 0;
+  }
+
+  void returnCode(uint8_t code) {
+    if (code == 0x01 ? bkcmd != 1 && bkcmd != 3 : bkcmd < 2) return;
+    if (dropAcks) {
+      dropAcks--;
+      return;
+    }
+    if (lateAcks) {
+      lateAcks--;
+      _late.push_back(code);
+      return;
+    }
+    reply({code});
+  }
+
+  void execute(const std::string& command) {
+    if (dropCommands) {
+      dropCommands--;
+      return;
+    }
+    executed.push_back(command);
+    if (command.rfind("get ", 0) == 0) {
+      std::string name = command.substr(4);
+      int32_t value = name == "dp"                 ? page
+                      : isdigit(name[0])          ? strtoul(name.c_str(), nullptr, 10)
+                      : name.rfind("rtc", 0) == 0 ? rtcRegister(name[3] - '0')
+                                                  : atol(values[name].c_str());
+      reply({0x71, (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)});
+    } else if (command.rfind("baud", 0) == 0) {
+      bool stored = command[4] == 's';
+      unsigned long baud = strtoul(command.c_str() + (stored ? 6 : 5), nullptr, 10);
+      if (baud > maxBaud) {
+        returnCode(0x11);
+        return;
+      }
+      displayBaud = baud;
+      if (stored) storedBaud = baud;
+    } else if (command.rfind("bkcmd=", 0) == 0) {
+      bkcmd = atoi(command.c_str() + 6);
+      returnCode(0x01);
+    } else if (command == "rest") {
+      reset();
+    } else if (command.rfind("bad", 0) == 0) {
+      returnCode(0x1A);
+    } else {
+      size_t equals = command.find('=');
+      if (equals != std::string::npos) values[command.substr(0, equals)] = command.substr(equals + 1);
+      returnCode(0x01);
+    }
+  }
+};
+
+#endif  // SIMDISPLAY_H
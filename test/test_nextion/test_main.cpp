@@ -0,0 +1,255 @@
+#include <Preferences.h>
+#include <nextionInterface.h>
+#include <unity.h>
+
+#include "simDisplay.h"
+
+void setUp() { Preferences::store().clear(); }
+void tearDown() {}
+
+void test_negotiates_fastest_working_rate() {
+  SimDisplay display(NEXTION_BAUD);
+  display.maxBaud = 512000;
+  myNextionInterface nextion(display, NEXTION_BAUD);
+  TEST_ASSERT_TRUE(nextion.begin());
+  TEST_ASSERT_EQUAL(512000, nextion.baud());
+  TEST_ASSERT_EQUAL(512000, display.displayBaud);
+  TEST_ASSERT_EQUAL(512000, display.storedBaud);
+  Preferences prefs;
+  prefs.begin("nextion");
+  TEST_ASSERT_EQUAL(512000, prefs.getULong("baud"));
+}
+
+void test_slow_display_keeps_rate_and_eeprom() {
+  SimDisplay display(NEXTION_BAUD);
+  display.maxBaud = NEXTION_BAUD;
+  myNextionInterface nextion(display, NEXTION_BAUD);
+  TEST_ASSERT_TRUE(nextion.begin());
+  TEST_ASSERT_EQUAL(NEXTION_BAUD, nextion.baud());
+  for (auto& command : display.executed) TEST_ASSERT_TRUE(command.rfind("bauds=", 0) != 0);
+  TEST_ASSERT_TRUE(Preferences::store().empty());
+}
+
+void test_unverified_rate_not_persisted() {
+  SimDisplay display(NEXTION_BAUD);
+  display.maxBaud = NEXTION_BAUD;
+  myNextionInterface nextion(display, NEXTION_BAUD);
+  TEST_ASSERT_TRUE(nextion.begin());
+
+  // Link goes dead while stepping up: no rate answers
+  display.maxBaud = 921600;
+  display.dropCommands = 1000;
+  TEST_ASSERT_EQUAL(NEXTION_BAUD, nextion.negotiateBaud(921600));
+  TEST_ASSERT_EQUAL(NEXTION_BAUD, display.hostBaud());
+  TEST_ASSERT_TRUE(Preferences::store().empty());
+  TEST_ASSERT_EQUAL(NEXTION_BAUD, display.storedBaud);
+}
+
+// Display at NEXTION_BAUD with acknowledged writes on
+static void beginAcked(myNextionInterface& nextion, SimDisplay& display) {
+  display.maxBaud = NEXTION_BAUD;
+  TEST_ASSERT_TRUE(nextion.begin());
+  TEST_ASSERT_TRUE(nextion.enableAcks(true));
+}
+
+static void writeNumbers(myNextionInterface& nextion, int first, int count) {
+  char name[24];
+  for (int i = first; i < first + count; i++) {
+    snprintf(name, sizeof(name), "n%d.val", i);
+    TEST_ASSERT_TRUE(nextion.writeNum(name, 100 + i));
+  }
+}
+
+static void assertNumbers(SimDisplay& display, int count) {
+  char name[24], value[16];
+  for (int i = 0; i < count; i++) {
+    snprintf(name, sizeof(name), "n%d.val", i);
+    snprintf(value, sizeof(value), "%d", 100 + i);
+    TEST_ASSERT_EQUAL_STRING(value, display.values[name].c_str());
+  }
+}
+
+// A command lost on the wire shifts every later return code onto the wrong command.
+// The timeout resends the whole window and every value arrives.
+void test_lost_command_resyncs_window() {
+  SimDisplay display(NEXTION_BAUD);
+  myNextionInterface nextion(display, NEXTION_BAUD);
+  beginAcked(nextion, display);
+  display.dropCommands = 1;
+  writeNumbers(nextion, 0, 12);
+  nextion.flushWrites();
+  assertNumbers(display, 12);
+  myNextionInterface::AckStats acks = nextion.ackStats();
+  TEST_ASSERT_EQUAL(1, acks.resyncs);
+  TEST_ASSERT_EQUAL(0, acks.abandoned);
+  TEST_ASSERT_EQUAL(0, nextion.lostWrites());
+}
+
+void test_lost_ack_resyncs_window() {
+  SimDisplay display(NEXTION_BAUD);
+  myNextionInterface nextion(display, NEXTION_BAUD);
+  beginAcked(nextion, display);
+  display.dropAcks = 1;
+  writeNumbers(nextion, 0, 12);
+  nextion.flushWrites();
+  assertNumbers(display, 12);
+  myNextionInterface::AckStats acks = nextion.ackStats();
+  TEST_ASSERT_EQUAL(1, acks.resyncs);
+  TEST_ASSERT_EQUAL(0, acks.stray);
+  TEST_ASSERT_EQUAL(0, nextion.lostWrites());
+}
+
+// A code arriving after its command timed out comes ahead of the marker reply and is
+// thrown away, not matched to the resent command or the next one
+void test_late_ack_not_matched_to_later_command() {
+  SimDisplay display(NEXTION_BAUD);
+  myNextionInterface nextion(display, NEXTION_BAUD);
+  beginAcked(nextion, display);
+  display.lateAcks = 1;
+  writeNumbers(nextion, 0, 1);
+  nextion.flushWrites();
+  writeNumbers(nextion, 1, 5);
+  nextion.flushWrites();
+  assertNumbers(display, 6);
+  myNextionInterface::AckStats acks = nextion.ackStats();
+  TEST_ASSERT_EQUAL(1, acks.timeouts);
+  TEST_ASSERT_EQUAL(1, acks.discarded);
+  TEST_ASSERT_EQUAL(0, acks.stray);
+  TEST_ASSERT_EQUAL(6, acks.acked);
+}
+
+// Nothing gets through: the write that finds the window full is refused, the window is
+// abandoned once its markers go unanswered, and both show in lostWrites()
+void test_dead_link_counts_lost_writes() {
+  SimDisplay display(NEXTION_BAUD);
+  myNextionInterface nextion(display, NEXTION_BAUD);
+  beginAcked(nextion, display);
+  display.dropCommands = 1000;
+  writeNumbers(nextion, 0, NEXTION_ACK_WINDOW);
+  TEST_ASSERT_FALSE(nextion.writeNum("n8.val", 108));
+  nextion.flushWrites();
+  myNextionInterface::AckStats acks = nextion.ackStats();
+  TEST_ASSERT_EQUAL(1, acks.refused);
+  TEST_ASSERT_EQUAL(NEXTION_ACK_WINDOW, acks.abandoned);
+  TEST_ASSERT_EQUAL(NEXTION_ACK_WINDOW + 1, nextion.lostWrites());
+}
+
+// A priority command finding the whole window taken goes out once acks free a slot,
+// without waiting for another write
+void test_queued_priority_sent_when_acks_free_slot() {
+  SimDisplay display(NEXTION_BAUD);
+  myNextionInterface nextion(display, NEXTION_BAUD);
+  beginAcked(nextion, display);
+  writeNumbers(nextion, 0, NEXTION_ACK_WINDOW);  // Return codes wait unread
+  for (int i = 0; i <= NEXTION_PRIORITY_SLOTS; i++) {
+    char text[8];
+    snprintf(text, sizeof(text), "a%d", i);
+    TEST_ASSERT_TRUE(nextion.writeStrPriority(text, text));
+  }
+  TEST_ASSERT_EQUAL(0, display.values.count("a2"));
+  std::string frame;
+  nextion.listen(frame, 255);
+  TEST_ASSERT_EQUAL_STRING("\"a2\"", display.values["a2"].c_str());
+  nextion.flushWrites();
+  TEST_ASSERT_EQUAL(NEXTION_PRIORITY_SLOTS + 1, nextion.ackStats().priority);
+}
+
+// A display reset returns it to bkcmd=2. reinitAcks() turns return codes back on and
+// drops what was in flight, so later writes are acknowledged without timeouts.
+void test_display_reset_restores_acks() {
+  SimDisplay display(NEXTION_BAUD);
+  myNextionInterface nextion(display, NEXTION_BAUD);
+  beginAcked(nextion, display);
+  writeNumbers(nextion, 0, 4);  // Return codes wait unread
+  display.reset();
+  std::string frame;
+  for (int i = 0; i < 4 && !nextion.readyCount(); i++) nextion.listen(frame, 255);
+  TEST_ASSERT_EQUAL(1, nextion.readyCount());
+  TEST_ASSERT_TRUE(nextion.reinitAcks());
+  TEST_ASSERT_EQUAL(3, display.bkcmd);
+  uint32_t acked = nextion.ackStats().acked;
+  writeNumbers(nextion, 0, 12);
+  nextion.flushWrites();
+  assertNumbers(display, 12);
+  myNextionInterface::AckStats acks = nextion.ackStats();
+  TEST_ASSERT_EQUAL(acked + 12, acks.acked);
+  TEST_ASSERT_EQUAL(0, acks.timeouts);
+  TEST_ASSERT_EQUAL(0, nextion.lostWrites());
+}
+
+// The clock ticks over a new year while its registers are read one at a time
+void test_rtc_read_across_carry() {
+  SimDisplay display(NEXTION_BAUD);
+  myNextionInterface nextion(display, NEXTION_BAUD);
+  display.maxBaud = NEXTION_BAUD;
+  TEST_ASSERT_TRUE(nextion.begin());
+  tm time;
+  for (uint16_t tick = 1; tick <= 7; tick++) {
+    display.rtc = 1735689599;  // 2024-12-31 23:59:59
+    display.rtcTickAfter = tick;
+    TEST_ASSERT_TRUE(nextion.getRTC(time));
+    bool after = time.tm_year == 125;
+    // Whole time before or after the tick, never a mix
+    TEST_ASSERT_EQUAL(after ? 0 : 11, time.tm_mon);
+    TEST_ASSERT_EQUAL(after ? 1 : 31, time.tm_mday);
+    TEST_ASSERT_EQUAL(after ? 0 : 23, time.tm_hour);
+    TEST_ASSERT_EQUAL(after ? 0 : 59, time.tm_min);
+    TEST_ASSERT_EQUAL(after ? 0 : 59, time.tm_sec);
+    TEST_ASSERT_TRUE(after || tick == 7);
+  }
+}
+
+// Throughput of a forecast repaint at each link speed, with and without acknowledged writes
+void test_repaint_throughput() {
+  static const unsigned long rates[] = {115200, 230400, 512000, 921600};
+  double last = 0;
+  for (unsigned long rate : rates) {
+    for (bool acks : {false, true}) {
+      SimDisplay display(NEXTION_BAUD);
+      display.maxBaud = rate;
+      myNextionInterface nextion(display, NEXTION_BAUD);
+      TEST_ASSERT_TRUE(nextion.begin());
+      TEST_ASSERT_EQUAL(rate, nextion.baud());
+      nextion.enableAcks(acks);
+
+      uint32_t bytes = nextion.txBytes(), commands = nextion.txCommands();
+      uint64_t start = hostClockMicros;
+      char name[24], text[24];
+      for (int i = 0; i < 48; i++) {
+        snprintf(name, sizeof(name), "page2.t%d.txt", i);
+        snprintf(text, sizeof(text), "%02d:00 Partly cloudy", i % 24);
+        TEST_ASSERT_TRUE(nextion.writeStr(name, text));
+        snprintf(name, sizeof(name), "page2.n%d.val", i);
+        TEST_ASSERT_TRUE(nextion.writeNum(name, 1000 + i));
+      }
+      nextion.flushWrites();
+      double seconds = (hostClockMicros - start) / 1e6;
+      bytes = nextion.txBytes() - bytes;
+      commands = nextion.txCommands() - commands;
+      printf("  %6lu baud, acks %-3s: %u commands, %u bytes in %.1f ms, %.0f bytes/s, %.0f commands/s\n", rate,
+             acks ? "on" : "off", commands, bytes, seconds * 1000, bytes / seconds, commands / seconds);
+      TEST_ASSERT_EQUAL(96, commands);
+      TEST_ASSERT_EQUAL_STRING("1047", display.values["page2.n47.val"].c_str());
+      if (!acks) {
+        TEST_ASSERT_GREATER_THAN(last, bytes / seconds);
+        last = bytes / seconds;
+      }
+    }
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_negotiates_fastest_working_rate);
+  RUN_TEST(test_slow_display_keeps_rate_and_eeprom);
+  RUN_TEST(test_unverified_rate_not_persisted);
+  RUN_TEST(test_lost_command_resyncs_window);
+  RUN_TEST(test_lost_ack_resyncs_window);
+  RUN_TEST(test_late_ack_not_matched_to_later_command);
+  RUN_TEST(test_dead_link_counts_lost_writes);
+  RUN_TEST(test_queued_priority_sent_when_acks_free_slot);
+  RUN_TEST(test_display_reset_restores_acks);
+  RUN_TEST(test_rtc_read_across_carry);
+  RUN_TEST(test_repaint_throughput);
+  return UNITY_END();
+}
@@ -0,0 +1,86 @@
+#include <powerModel.h>
+#include <stdio.h>
+#include <unity.h>
+
+void setUp() {}
+void tearDown() {}
+
+static const uint64_t hour = 3600ULL * 1000000;
+
+// mA for the whole period comes out as mA x 24 mAh/day
+void test_estimate_units() {
+  PowerSpent busy = {24 * hour, 0, 0, 0, 0, 0};
+  PowerEstimate mah = estimatePower(busy, 1000);
+  TEST_ASSERT_EQUAL(POWER_MA_CPU * 24, mah.station);
+  TEST_ASSERT_EQUAL(POWER_MA_DISPLAY_ASLEEP * 24, mah.display);
+
+  PowerSpent half = {2 * hour, hour, 0, 0, 0, 2 * hour};
+  mah = estimatePower(half, 1000);
+  TEST_ASSERT_EQUAL((POWER_MA_CPU + POWER_MA_IDLE) * 12, mah.station);
+  TEST_ASSERT_EQUAL(POWER_MA_DISPLAY_AWAKE * 24, mah.display);
+
+  // Scan current scales with the window's share of the interval
+  PowerSpent scanning = {hour, hour, 0, hour, 0, 0};
+  TEST_ASSERT_EQUAL((POWER_MA_IDLE * 2 + POWER_MA_BLE_RX) * 12, estimatePower(scanning, 500).station);
+  TEST_ASSERT_EQUAL(0, estimatePower({}, 1000).station);
+}
+
+void test_simulated_day_adds_up() {
+  PowerPolicy policy = PowerPolicy::fromSettings(true);
+  policy.displayOnHours = 6;
+  PowerSpent day = simulateDay(policy);
+  TEST_ASSERT_TRUE(day.period == 24 * hour);
+  TEST_ASSERT_TRUE(day.displayOn == 6 * hour);
+  TEST_ASSERT_TRUE(day.idle + day.sleep <= day.period);
+  TEST_ASSERT_TRUE(day.sleep <= day.period - day.displayOn);  // Light sleep only while the display sleeps
+  TEST_ASSERT_TRUE(day.scan < day.period && day.fetch < day.scan);
+
+  // Scans and fetches slow down while the display sleeps
+  policy.displayOnHours = 24;
+  PowerSpent awake = simulateDay(policy);
+  TEST_ASSERT_TRUE(awake.scan > day.scan && awake.fetch > day.fetch);
+
+  // Without POWER_SAVE loop() never blocks
+  PowerSpent spinning = simulateDay(PowerPolicy::fromSettings(false));
+  TEST_ASSERT_TRUE(spinning.idle == 0 && spinning.sleep == 0);
+}
+
+// mAh/day of each policy with this build's settings, printed for comparison
+void test_policies_compared() {
+  struct Case {
+    const char* name;
+    PowerPolicy policy;
+  };
+  PowerPolicy alwaysOn = PowerPolicy::fromSettings(false);
+  PowerPolicy saveAwake = PowerPolicy::fromSettings(true);
+  saveAwake.lightSleep = false;
+  PowerPolicy saveIdle = PowerPolicy::fromSettings(true);
+  saveIdle.lightSleep = false;
+  saveIdle.displayOnHours = 2;
+  PowerPolicy saveSleep = PowerPolicy::fromSettings(true);
+  saveSleep.displayOnHours = 2;
+  const Case cases[] = {
+      {"always on, display on", alwaysOn},
+      {"POWER_SAVE, display on", saveAwake},
+      {"POWER_SAVE, display 2 h, no light sleep", saveIdle},
+      {"POWER_SAVE, display 2 h, light sleep", saveSleep},
+  };
+  PowerEstimate mah[4];
+  for (int i = 0; i < 4; i++) {
+    mah[i] = estimatePower(simulateDay(cases[i].policy), cases[i].policy.scanDutyPermille);
+    printf("  %-40s station %4u mAh/day, display %4u mAh/day\n", cases[i].name, mah[i].station, mah[i].display);
+  }
+  TEST_ASSERT_TRUE(mah[1].station < mah[0].station / 2);
+  TEST_ASSERT_TRUE(mah[2].station < mah[1].station);
+  TEST_ASSERT_TRUE(mah[3].station < mah[2].station);
+  TEST_ASSERT_EQUAL(mah[0].display, mah[1].display);
+  TEST_ASSERT_TRUE(mah[2].display < mah[1].display / 2);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_estimate_units);
+  RUN_TEST(test_simulated_day_adds_up);
+  RUN_TEST(test_policies_compared);
+  return UNITY_END();
+}
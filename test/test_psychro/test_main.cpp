@@ -0,0 +1,139 @@
+#define PSYCHRO_BENCHMARK  // dewPointLibm(), windChillLibm()
+#include <psychro.h>
+#include <unity.h>
+
+#include <chrono>
+
+// Exact forms the tables replace, as in psychroBenchmark()
+float dewPointExact(int16_t centiC, float humidity) {
+  const double b = 17.625, c = 243.04;
+  double t = centiC * 0.01;
+  double g = log(humidity * 0.01) + b * t / (c + t);
+  return (float)(c * g / (b - g));
+}
+float windChillExact(float f, float mph) {
+  double factor = pow(mph, 0.16);
+  return (float)(35.74 + 0.6215 * f - 35.75 * factor + 0.4275 * f * factor);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_saturation_pressure_table() {
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 610.94f, saturationPressure(0));
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 18.9684f, saturationPressure(-6000));  // Clamped to -40 C
+  TEST_ASSERT_FLOAT_WITHIN(0.1f, 20023.0f, saturationPressure(7000));    // Clamped to 60 C
+  // Halfway between table points
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, (610.94f + 656.696f) / 2, saturationPressure(50));
+}
+
+void test_dew_point_matches_magnus() {
+  float worst = 0;
+  for (int16_t centiC = -3500; centiC <= 6000; centiC += 37) {
+    for (uint8_t rh = 5; rh <= 100; rh += 5) {
+      float exact = dewPointExact(centiC, rh);
+      if (exact <= -40.0f) continue;  // Clamped
+      worst = fmaxf(worst, fabsf(dewPoint(centiC, rh) - exact));
+    }
+  }
+  TEST_ASSERT_LESS_THAN(0.012f, worst);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 21.37f, dewPoint(2137, 100));
+}
+
+void test_absolute_humidity() {
+  // 20 C, 50 %: e = 1167 Pa, e / (Rv T) = 8.62 g/m3
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 8.62f, absoluteHumidity(2000, 50));
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, absoluteHumidity(2000, 0));
+}
+
+void test_heat_index() {
+  // Below 80 F the simple form applies
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.5f * (70 + 61 + 2 * 1.2f + 40 * 0.094f), heatIndex(70, 40));
+  // NWS table: 90 F at 60 % is 100 F, 100 F at 40 % is 109 F
+  TEST_ASSERT_FLOAT_WITHIN(1.0f, 100.0f, heatIndex(90, 60));
+  TEST_ASSERT_FLOAT_WITHIN(1.0f, 109.0f, heatIndex(100, 40));
+}
+
+void test_wind_chill_matches_powf() {
+  float worst = 0;
+  for (int16_t f = -40; f <= 50; f += 5) {
+    for (float mph = 3.0f; mph <= 100.0f; mph += 0.7f) worst = fmaxf(worst, fabsf(windChill(f, mph) - windChillExact(f, mph)));
+  }
+  TEST_ASSERT_LESS_THAN(0.09f, worst);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 55.0f, windChill(55, 20));  // Too warm
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f, windChill(10, 2));   // Too calm
+  TEST_ASSERT_FLOAT_WITHIN(0.5f, -24.0f, windChill(0, 25));    // NWS table
+}
+
+void test_metrics_derived_only_on_change() {
+  RuuviTag tag("Test", "Test tag");
+  RuuviMetrics metrics(tag);
+  tag.update(2000, 50, 101325);
+  RuuviDerived d = metrics.get(0);
+  TEST_ASSERT_EQUAL(1, metrics.derivations());
+  TEST_ASSERT_EQUAL(86, d.absoluteHumidity);
+  TEST_ASSERT_EQUAL(669, d.heatIndexDeciF);  // Simple form at 68 F
+  TEST_ASSERT_EQUAL(680, d.windChillDeciF);
+  TEST_ASSERT_EQUAL((int)lroundf(dewPoint(2000, 50) * 18 + 320), d.dewPointDeciF);
+
+  metrics.get(0);
+  TEST_ASSERT_EQUAL(1, metrics.derivations());
+  metrics.get(5);  // Wind changed
+  TEST_ASSERT_EQUAL(2, metrics.derivations());
+  tag.update(2010, 50, 101325);
+  metrics.get(5);
+  TEST_ASSERT_EQUAL(3, metrics.derivations());
+  TEST_ASSERT_EQUAL(4, metrics.reads());
+}
+
+// Host wall time per call of a kernel over the sweeps psychroBenchmark() uses, many times over.
+// The virtual clock doesn't move while code runs, so this one uses the host's.
+template <typename Sweep>
+double nanosPerCall(Sweep sweep) {
+  const int repeats = 200;
+  uint32_t calls = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeats; i++) calls += sweep();
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / calls;
+}
+
+void test_throughput_against_libm() {
+  volatile float sink = 0;
+  auto dewSweep = [&](float (*kernel)(int16_t, float)) {
+    return nanosPerCall([&] {
+      uint32_t calls = 0;
+      for (int16_t centiC = -4000; centiC <= 6000; centiC += 37) {
+        for (uint8_t rh = 1; rh <= 100; rh += 3, calls++) sink = sink + kernel(centiC, rh);
+      }
+      return calls;
+    });
+  };
+  auto chillSweep = [&](float (*kernel)(float, float)) {
+    return nanosPerCall([&] {
+      uint32_t calls = 0;
+      for (int16_t f = -40; f <= 50; f += 5) {
+        for (float mph = 3.0f; mph <= 100.0f; mph += 0.7f, calls++) sink = sink + kernel(f, mph);
+      }
+      return calls;
+    });
+  };
+  double dewTable = dewSweep(dewPoint), dewLibm = dewSweep(dewPointLibm);
+  double chillTable = chillSweep(windChill), chillLibm = chillSweep(windChillLibm);
+  printf("  dew point : table %.1f ns/call, libm %.1f ns/call (%.1fx)\n", dewTable, dewLibm, dewLibm / dewTable);
+  printf("  wind chill: table %.1f ns/call, libm %.1f ns/call (%.1fx)\n", chillTable, chillLibm,
+         chillLibm / chillTable);
+  TEST_ASSERT_TRUE(isfinite(sink));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_saturation_pressure_table);
+  RUN_TEST(test_dew_point_matches_magnus);
+  RUN_TEST(test_absolute_humidity);
+  RUN_TEST(test_heat_index);
+  RUN_TEST(test_wind_chill_matches_powf);
+  RUN_TEST(test_metrics_derived_only_on_change);
+  RUN_TEST(test_throughput_against_libm);
+  return UNITY_END();
+}
@@ -0,0 +1,98 @@
+#ifndef GOLDEN_H
+#define GOLDEN_H
+
+/*----------------------------------------------------------------
+  Display commands written by getWeather() before the binding tables replaced it
+  (src/main.cpp at 9a1a974^), for the model in test_main.cpp's fixedSnapshot(),
+  in the order they went out. 84 commands: current conditions, status, five days,
+  hourly headings, twelve hours.
+*/
+
+static const char* const baselineCommands[] = {
+    "page0.humidity.val=83",
+    "page0.wxDescription.txt=\"moderate rain\"",
+    "page0.windSpeed.val=7",
+    "page0.windDirection.val=212",
+    "page0.City.txt=\"Chicago\"",
+    "page0.wxIcon.pic=4",
+    "page0.statusTxt.txt=\"OW: Wed 05:20\"",
+    "Setup.WeatherStatus.txt=\"OW: Wed 05:20\"",
+    "page0.dateTime1.txt=\"Wed 03\"",
+    "page0.forecastTxt1.txt=\"clear sky\"",
+    "page0.forecastMin1.val=-4",
+    "page0.forecastMax1.val=1",
+    "page0.forecastIcon1.pic=14",
+    "page0.dateTime2.txt=\"Thu 04\"",
+    "page0.forecastTxt2.txt=\"few clouds\"",
+    "page0.forecastMin2.val=-1",
+    "page0.forecastMax2.val=2",
+    "page0.forecastIcon2.pic=15",
+    "page0.dateTime3.txt=\"Fri 05\"",
+    "page0.forecastTxt3.txt=\"snow\"",
+    "page0.forecastMin3.val=0",
+    "page0.forecastMax3.val=31",
+    "page0.forecastIcon3.pic=7",
+    "page0.dateTime4.txt=\"Sat 06\"",
+    "page0.forecastTxt4.txt=\"mist\"",
+    "page0.forecastMin4.val=13",
+    "page0.forecastMax4.val=41",
+    "page0.forecastIcon4.pic=0",
+    "page0.dateTime5.txt=\"Sun 07\"",
+    "page0.forecastTxt5.txt=\"\"",
+    "page0.forecastMin5.val=-12",
+    "page0.forecastMax5.val=0",
+    "page0.forecastIcon5.pic=0",
+    "Hourly.hour1.txt=\"05 AM\"",
+    "Hourly.hour5.txt=\"09 AM\"",
+    "Hourly.hour9.txt=\"01 PM\"",
+    "Hourly.temp1.val=22",
+    "Hourly.clouds1.pic=1",
+    "Hourly.pop1.val=0",
+    "Hourly.pcpt1.val=0",
+    "Hourly.temp2.val=-1",
+    "Hourly.clouds2.pic=2",
+    "Hourly.pop2.val=5",
+    "Hourly.pcpt2.val=5",
+    "Hourly.temp3.val=1",
+    "Hourly.clouds3.pic=8",
+    "Hourly.pop3.val=100",
+    "Hourly.pcpt3.val=5",
+    "Hourly.temp4.val=-2",
+    "Hourly.clouds4.pic=22",
+    "Hourly.pop4.val=35",
+    "Hourly.pcpt4.val=6",
+    "Hourly.temp5.val=1",
+    "Hourly.clouds5.pic=24",
+    "Hourly.pop5.val=0",
+    "Hourly.pcpt5.val=50",
+    "Hourly.temp6.val=-1",
+    "Hourly.clouds6.pic=25",
+    "Hourly.pop6.val=99",
+    "Hourly.pcpt6.val=52",
+    "Hourly.temp7.val=0",
+    "Hourly.clouds7.pic=23",
+    "Hourly.pop7.val=50",
+    "Hourly.pcpt7.val=100",
+    "Hourly.temp8.val=35",
+    "Hourly.clouds8.pic=20",
+    "Hourly.pop8.val=1",
+    "Hourly.pcpt8.val=100",
+    "Hourly.temp9.val=-15",
+    "Hourly.clouds9.pic=0",
+    "Hourly.pop9.val=0",
+    "Hourly.pcpt9.val=100",
+    "Hourly.temp10.val=10",
+    "Hourly.clouds10.pic=0",
+    "Hourly.pop10.val=60",
+    "Hourly.pcpt10.val=20",
+    "Hourly.temp11.val=-10",
+    "Hourly.clouds11.pic=25",
+    "Hourly.pop11.val=20",
+    "Hourly.pcpt11.val=0",
+    "Hourly.temp12.val=100",
+    "Hourly.clouds12.pic=22",
+    "Hourly.pop12.val=80",
+    "Hourly.pcpt12.val=8",
+};
+
+#endif  // GOLDEN_H
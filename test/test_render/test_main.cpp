@@ -0,0 +1,191 @@
+#include <Preferences.h>
+#include <nextionBindings.h>
+#include <unity.h>
+
+#include <string>
+#include <vector>
+
+#include "../test_nextion/simDisplay.h"
+#include "golden.h"
+
+// A fixed model reaching every encoder branch: temperatures either side of zero and on
+// the half degree, day, night, missing and unknown icons, rain under the bar's minimum
+// and over full scale. Wed 3 July 2024, 05:20 CDT.
+static void fixedSnapshot(WeatherSnapshot& snap) {
+  memset(&snap, 0, sizeof(snap));
+  SnapshotCurrent& c = snap.current;
+  c.lon = -87.65f;
+  c.lat = 41.85f;
+  c.weatherId = 501;
+  strcpy(c.main, "Rain");
+  strcpy(c.description, "moderate rain");
+  strcpy(c.icon, "10d");
+  c.temp = 21.4f;
+  c.pressure = 1012;
+  c.humidity = 83;
+  c.windSpeed = 7.7f;
+  c.windDeg = 212.5f;
+  c.clouds = 90;
+  c.observationTime = 1720002034;
+
+  static const char* dailyIcons[8] = {"01d", "02n", "13d", "50n", "99d", "11d", "04d", "09n"};
+  static const char* dailyText[8] = {"clear sky", "few clouds", "snow", "mist", "", "thunderstorm", "broken clouds",
+                                     "shower rain"};
+  static const float dailyMin[8] = {-3.5f, -0.5f, 0.4f, 12.5f, -12.49f, 15, 16, 17};
+  static const float dailyMax[8] = {0.5f, 2.49f, 30.5f, 41, -0.4f, 25, 26, 27};
+  for (int i = 0; i < 8; i++) {
+    SnapshotDaily& d = snap.daily[i];
+    d.observationTime = 1720029600 + i * 86400;  // 17:00 UTC, noon CDT
+    d.tempMin = dailyMin[i];
+    d.tempMax = dailyMax[i];
+    strcpy(d.icon, dailyIcons[i]);
+    strcpy(d.description, dailyText[i]);
+  }
+
+  // Icons are packed as 2 x number + night, 0 is none
+  static const int16_t temp[12] = {215, -5, 5, -15, 14, -14, 0, 349, -150, 95, -95, 1000};
+  static const uint8_t icon[12] = {2, 3, 4, 21, 26, 101, 22, 7, 0, 198, 100, 18};
+  static const uint8_t pop[12] = {0, 5, 100, 35, 0, 99, 50, 1, 0, 60, 20, 80};
+  static const uint8_t rain[12] = {0, 1, 2, 3, 25, 26, 50, 51, 255, 10, 0, 4};
+  HourlySeries& h = snap.hourly;
+  h.start = 1720000800;
+  h.count = HOURLY_HOURS;
+  for (int i = 0; i < HOURLY_HOURS; i++) {
+    h.temp[i] = temp[i % 12] + i / 12;
+    h.icon[i] = icon[i % 12];
+    h.pop[i] = pop[i % 12];
+    h.rain[i] = rain[i % 12];
+  }
+
+  snap.nowcast.start = c.observationTime;
+  snap.nowcast.minutes = 60;  // Dry
+
+  snap.alertCount = 1;
+  strcpy(snap.alerts[0].event, "Heat Advisory");
+  snap.alerts[0].start = 1720000000;
+  snap.alerts[0].end = 4102444800;  // Still in force whenever the test runs
+  strcpy(snap.alerts[0].description, "Heat index values up to 105 expected.");
+}
+
+owmFetcher fetcher;
+owmWeather weather("Chicago", 41.85f, -87.65f, "key", fetcher);
+
+static bool isNewRow(const std::string& command) {
+  for (const char* name : {"page0.nowcast.txt=", "page0.alert.txt=", "page0.alertText.txt="}) {
+    if (command.rfind(name, 0) == 0) return true;
+  }
+  return false;
+}
+
+// Last value written to a component, text without its quotes
+static std::string valueOf(SimDisplay& display, const char* component) {
+  std::string value = display.values[component];
+  if (value.size() >= 2 && value.front() == '"') return value.substr(1, value.size() - 2);
+  return value;
+}
+
+// As loop() does it: acknowledged writes, both pages rendered, then flushed
+static void beginDisplay(myNextionInterface& nextion, SimDisplay& display) {
+  display.maxBaud = NEXTION_BAUD;
+  TEST_ASSERT_TRUE(nextion.begin());
+  TEST_ASSERT_TRUE(nextion.enableAcks(true));
+  display.executed.clear();
+}
+
+void setUp() {
+  Preferences::store().clear();
+  WeatherSnapshot snap;
+  fixedSnapshot(snap);
+  weather.fromSnapshot(snap);
+  weather.setFetchStatus(200);
+}
+void tearDown() {}
+
+// The tables write what getWeather() wrote before them, command for command, in the same
+// order. The rows added since (nowcast, alerts) are checked on their own.
+void test_full_render_matches_baseline() {
+  SimDisplay display(NEXTION_BAUD);
+  myNextionInterface nextion(display, NEXTION_BAUD);
+  beginDisplay(nextion, display);
+  BindingShadow<sizeof(weatherBindings) / sizeof(weatherBindings[0])> weatherShadow;
+  BindingShadow<sizeof(hourlyBindings) / sizeof(hourlyBindings[0])> hourlyShadow;
+  uint16_t written = renderChanged(nextion, weather, weatherBindings, 0, weatherShadow);
+  written += renderChanged(nextion, weather, hourlyBindings, 0, hourlyShadow);
+  nextion.flushWrites();
+  TEST_ASSERT_EQUAL(sizeof(weatherBindings) / sizeof(weatherBindings[0]) + sizeof(hourlyBindings) / sizeof(hourlyBindings[0]),
+                    written);
+
+  std::vector<std::string> commands;
+  for (const std::string& command : display.executed) {
+    if (!isNewRow(command)) commands.push_back(command);
+  }
+  const size_t goldenCount = sizeof(baselineCommands) / sizeof(baselineCommands[0]);
+  for (size_t i = 0; i < commands.size() && i < goldenCount; i++) {
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(baselineCommands[i], commands[i].c_str(), "command differs from baseline");
+  }
+  TEST_ASSERT_EQUAL(goldenCount, commands.size());
+
+#ifdef OW_NOWCAST
+  TEST_ASSERT_EQUAL_STRING("No rain next hour", valueOf(display, "page0.nowcast.txt").c_str());
+#endif
+#ifdef OW_ALERTS
+  TEST_ASSERT_TRUE(valueOf(display, "page0.alert.txt").rfind("Heat Advisory until ", 0) == 0);
+  TEST_ASSERT_EQUAL_STRING("Heat index values up to 105 expected.", valueOf(display, "page0.alertText.txt").c_str());
+#endif
+}
+
+// A second render of the same model writes nothing, a changed value writes its row alone
+void test_only_changed_rows_written() {
+  SimDisplay display(NEXTION_BAUD);
+  myNextionInterface nextion(display, NEXTION_BAUD);
+  beginDisplay(nextion, display);
+  BindingShadow<sizeof(weatherBindings) / sizeof(weatherBindings[0])> weatherShadow;
+  BindingShadow<sizeof(hourlyBindings) / sizeof(hourlyBindings[0])> hourlyShadow;
+  renderChanged(nextion, weather, weatherBindings, 0, weatherShadow);
+  renderChanged(nextion, weather, hourlyBindings, 0, hourlyShadow);
+  nextion.flushWrites();
+  display.executed.clear();
+
+  TEST_ASSERT_EQUAL(0, renderChanged(nextion, weather, weatherBindings, 0, weatherShadow));
+  TEST_ASSERT_EQUAL(0, renderChanged(nextion, weather, hourlyBindings, 0, hourlyShadow));
+  TEST_ASSERT_EQUAL(0, display.executed.size());
+
+  WeatherSnapshot snap;
+  fixedSnapshot(snap);
+  snap.current.humidity = 84;
+  strcpy(snap.daily[2].description, "light snow");
+  snap.hourly.rain[7] = 0;
+  weather.fromSnapshot(snap);
+  TEST_ASSERT_EQUAL(2, renderChanged(nextion, weather, weatherBindings, 0, weatherShadow));
+  TEST_ASSERT_EQUAL(1, renderChanged(nextion, weather, hourlyBindings, 0, hourlyShadow));
+  nextion.flushWrites();
+  TEST_ASSERT_EQUAL(3, display.executed.size());
+  TEST_ASSERT_EQUAL_STRING("page0.humidity.val=84", display.executed[0].c_str());
+  TEST_ASSERT_EQUAL_STRING("page0.forecastTxt3.txt=\"light snow\"", display.executed[1].c_str());
+  TEST_ASSERT_EQUAL_STRING("Hourly.pcpt8.val=0", display.executed[2].c_str());
+}
+
+// A scrolled hourly window shows the same rows for later hours
+void test_hourly_offset_shifts_slots() {
+  SimDisplay display(NEXTION_BAUD);
+  myNextionInterface nextion(display, NEXTION_BAUD);
+  beginDisplay(nextion, display);
+  BindingShadow<sizeof(hourlyBindings) / sizeof(hourlyBindings[0])> hourlyShadow;
+  renderChanged(nextion, weather, hourlyBindings, HOURLY_WINDOW, hourlyShadow);
+  nextion.flushWrites();
+
+  // Hours 12 to 23 are hours 0 to 11 one tenth of a degree warmer, 17:00 to 04:00 CDT
+  TEST_ASSERT_EQUAL_STRING("05 PM", valueOf(display, "Hourly.hour1.txt").c_str());
+  TEST_ASSERT_EQUAL_STRING("09 PM", valueOf(display, "Hourly.hour5.txt").c_str());
+  TEST_ASSERT_EQUAL_STRING("22", valueOf(display, "Hourly.temp1.val").c_str());
+  TEST_ASSERT_EQUAL_STRING("-1", valueOf(display, "Hourly.temp4.val").c_str());
+  TEST_ASSERT_EQUAL_STRING("100", valueOf(display, "Hourly.pcpt9.val").c_str());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_full_render_matches_baseline);
+  RUN_TEST(test_only_changed_rows_written);
+  RUN_TEST(test_hourly_offset_shifts_slots);
+  return UNITY_END();
+}
@@ -0,0 +1,145 @@
+#define RUUVI_CAPTURE
+#include <ruuvi.h>
+#include <unity.h>
+
+#include <chrono>
+
+// Raw advert as NimBLE hands it over: flags, complete local name, manufacturer data (Ruuvi v5)
+const char tagName[] = RUUVI_OUTDOOR_TAG;
+uint8_t advert[64];
+size_t advertLen;
+const uint8_t ruuviV5[] = {0x99, 0x04, 0x05, 0x12, 0xFC, 0x53, 0x94, 0xC3, 0x7C};  // 24.3 C, 53.49 %, 100044 Pa
+
+void setUp() {
+  size_t n = 0;
+  advert[n++] = 2;
+  advert[n++] = 0x01;
+  advert[n++] = 0x06;
+  advert[n++] = 1 + strlen(tagName);
+  advert[n++] = 0x09;
+  memcpy(advert + n, tagName, strlen(tagName));
+  n += strlen(tagName);
+  advert[n++] = 1 + sizeof(ruuviV5);
+  advert[n++] = 0xFF;
+  memcpy(advert + n, ruuviV5, sizeof(ruuviV5));
+  advertLen = n + sizeof(ruuviV5);
+}
+void tearDown() {}
+
+void test_fields_found_in_place() {
+  size_t length;
+  const uint8_t* name = findAdvertField(advert, advertLen, 0x09, &length);
+  TEST_ASSERT_EQUAL(strlen(tagName), length);
+  TEST_ASSERT_TRUE(memcmp(name, tagName, length) == 0);
+  const uint8_t* data = findAdvertField(advert, advertLen, 0xFF, &length);
+  TEST_ASSERT_EQUAL(sizeof(ruuviV5), length);
+  TEST_ASSERT_EQUAL_PTR(advert + advertLen - sizeof(ruuviV5), data);
+  TEST_ASSERT_NULL(findAdvertField(advert, advertLen, 0x08, &length));
+  TEST_ASSERT_EQUAL(0, length);
+  // A field running past the end is not trusted
+  TEST_ASSERT_NULL(findAdvertField(advert, advertLen - 1, 0xFF, &length));
+}
+
+void test_decode_updates_named_tag() {
+  TEST_ASSERT_TRUE(processRuuviAdvertisement(tagName, strlen(tagName), true, ruuviV5, sizeof(ruuviV5)));
+  RuuviReading r = outdoorTag.reading();
+  TEST_ASSERT_EQUAL(2430, r.centiC);
+  TEST_ASSERT_EQUAL(53, r.humidity);
+  TEST_ASSERT_EQUAL(100044, r.pressure);
+  TEST_ASSERT_FALSE(processRuuviAdvertisement(tagName, strlen(tagName) - 1, true, ruuviV5, sizeof(ruuviV5)));
+  TEST_ASSERT_FALSE(processRuuviAdvertisement(tagName, strlen(tagName), false, ruuviV5, sizeof(ruuviV5)));
+  TEST_ASSERT_FALSE(processRuuviAdvertisement(tagName, strlen(tagName), true, ruuviV5, 8));
+}
+
+void test_replay_leaves_live_tags_alone() {
+  outdoorTag.update(-500, 80, 99000);
+  ruuviCapture.start();
+  size_t length;
+  const uint8_t* data = findAdvertField(advert, advertLen, 0xFF, &length);
+  uint8_t mac[6] = {1, 2, 3, 4, 5, 6};
+  ruuviCapture.record(mac, -70, true, tagName, strlen(tagName), data, length);
+  ruuviCapture.record(mac, -90, false, nullptr, 0, nullptr, 0);  // Not a Ruuvi
+  TEST_ASSERT_EQUAL(2, ruuviCapture.records());
+
+  RuuviCapture::ReplayStats stats = ruuviCapture.replay(replayRuuviAdvertisement, 1000, 10);
+  TEST_ASSERT_EQUAL(10, stats.offered);
+  TEST_ASSERT_EQUAL(5, stats.tagUpdates);
+  TEST_ASSERT_EQUAL(2430, replayOutdoorTag.reading().centiC);
+  TEST_ASSERT_EQUAL(-500, outdoorTag.reading().centiC);
+}
+
+// The kernels against a double reference rounded half away from zero, over every input
+void test_fixed_point_kernels_round_exactly() {
+  for (int32_t v = INT16_MIN; v <= INT16_MAX; v++) {
+    int16_t x = (int16_t)v;
+    TEST_ASSERT_EQUAL(lround(x / 2.0), ruuviRawToCentiC(x));
+    TEST_ASSERT_EQUAL(lround(x / 100.0), centiCToC(x));
+    TEST_ASSERT_EQUAL(lround((x * 9 + 16000) / 50.0), centiCToDeciF(x));
+    TEST_ASSERT_EQUAL(lround(v / 10.0), deciFToF(v));
+  }
+}
+
+void test_fixed_point_boundaries() {
+  // Halves go away from zero on both sides
+  TEST_ASSERT_EQUAL(1, ruuviRawToCentiC(1));
+  TEST_ASSERT_EQUAL(-1, ruuviRawToCentiC(-1));
+  TEST_ASSERT_EQUAL(1, centiCToC(50));
+  TEST_ASSERT_EQUAL(-1, centiCToC(-50));
+  TEST_ASSERT_EQUAL(0, centiCToC(49));
+  TEST_ASSERT_EQUAL(0, centiCToC(-49));
+  TEST_ASSERT_EQUAL(1, deciFToF(5));
+  TEST_ASSERT_EQUAL(-1, deciFToF(-5));
+  // Fixed points of the scales
+  TEST_ASSERT_EQUAL(320, centiCToDeciF(0));
+  TEST_ASSERT_EQUAL(2120, centiCToDeciF(10000));
+  TEST_ASSERT_EQUAL(-400, centiCToDeciF(-4000));  // -40 C is -40 F
+  TEST_ASSERT_EQUAL(0, centiCToDeciF(-1778));     // 0 F is -17.78 C
+  TEST_ASSERT_EQUAL(1, centiCToDeciF(-1775));     // -17.75 C is 0.05 F, rounds up
+  TEST_ASSERT_EQUAL(0, deciFToF(centiCToDeciF(-1778)));
+  // Ruuvi v5 range ends (+-163.835 C) and the advert's invalid marker stay in range
+  TEST_ASSERT_EQUAL(16384, ruuviRawToCentiC(32767));
+  TEST_ASSERT_EQUAL(-16384, ruuviRawToCentiC(-32767));
+  TEST_ASSERT_EQUAL(-16384, ruuviRawToCentiC(INT16_MIN));
+  TEST_ASSERT_EQUAL(-5578, centiCToDeciF(-32768));
+  RuuviReading r = {};
+  r.centiC = ruuviRawToCentiC(0x12FC);  // 24.3 C from ruuviV5
+  TEST_ASSERT_EQUAL(2430, r.centiC);
+  TEST_ASSERT_EQUAL(24, r.temperatureInC());
+  TEST_ASSERT_EQUAL(757, r.temperatureInDeciF());
+  TEST_ASSERT_EQUAL(76, r.temperatureInF());
+}
+
+// The float conversions the kernels replaced, for the timing comparison
+static int floatDeciF(int16_t raw) { return (int)roundf((raw * 0.005f * 1.8f + 32.0f) * 10.0f); }
+static int fixedDeciF(int16_t raw) { return centiCToDeciF(ruuviRawToCentiC(raw)); }
+
+void test_fixed_point_against_float_timing() {
+  volatile int sink = 0;
+  auto nanosPerCall = [&](int (*convert)(int16_t)) {
+    const int repeats = 50;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) {
+      for (int32_t raw = INT16_MIN; raw <= INT16_MAX; raw++) sink = sink + convert((int16_t)raw);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (repeats * 65536.0);
+  };
+  double fixed = nanosPerCall(fixedDeciF), floating = nanosPerCall(floatDeciF);
+  printf("  raw to deci F: fixed %.2f ns/call, float %.2f ns/call (%.1fx)\n", fixed, floating, floating / fixed);
+  // Within a tenth of a degree F of the float path everywhere (float rounding at the halves)
+  for (int32_t raw = -16000; raw <= 16000; raw++) {
+    int diff = fixedDeciF((int16_t)raw) - floatDeciF((int16_t)raw);
+    TEST_ASSERT_TRUE(diff >= -1 && diff <= 1);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_fields_found_in_place);
+  RUN_TEST(test_decode_updates_named_tag);
+  RUN_TEST(test_replay_leaves_live_tags_alone);
+  RUN_TEST(test_fixed_point_kernels_round_exactly);
+  RUN_TEST(test_fixed_point_boundaries);
+  RUN_TEST(test_fixed_point_against_float_timing);
+  return UNITY_END();
+}
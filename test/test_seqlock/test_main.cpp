@@ -0,0 +1,86 @@
+#include <seqlock.h>
+#include <unity.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// A value whose words all derive from n, so a copy mixing two writes is caught. Large
+// enough that a copy takes a while and the writer often lands in the middle of one.
+struct Snapshot {
+  uint32_t n;
+  uint32_t inverted;
+  uint64_t scrambled[12];
+  uint16_t low;
+  uint8_t parity;
+
+  static Snapshot of(uint32_t n) {
+    Snapshot s = {n, ~n, {}, (uint16_t)n, (uint8_t)__builtin_parity(n)};
+    for (uint64_t i = 0; i < 12; i++) s.scrambled[i] = (n + i) * 0x9E3779B97F4A7C15ULL;
+    return s;
+  }
+  bool consistent() const {
+    Snapshot expected = of(n);
+    return inverted == expected.inverted && low == expected.low && parity == expected.parity &&
+           memcmp(scrambled, expected.scrambled, sizeof(scrambled)) == 0;
+  }
+};
+
+void setUp() {}
+void tearDown() {}
+
+void test_single_thread_round_trip() {
+  Seqlock<Snapshot> lock;
+  TEST_ASSERT_EQUAL(0, lock.version());
+  TEST_ASSERT_EQUAL(0, lock.read().n);
+  lock.write(Snapshot::of(42));
+  TEST_ASSERT_EQUAL(1, lock.version());
+  Snapshot s = lock.read();
+  TEST_ASSERT_EQUAL(42, s.n);
+  TEST_ASSERT_TRUE(s.consistent());
+}
+
+// One writer, several readers on other threads. Every read must be one whole write,
+// and no reader may see writes go backwards. Built with -fsanitize=thread in
+// pio test -e native-tsan, which also checks the copies are not data races.
+void test_readers_never_see_torn_values() {
+  const int readers = 4;
+  const uint32_t writes = 200000;
+  Seqlock<Snapshot> lock;
+  lock.write(Snapshot::of(0));
+  std::atomic<bool> done{false};
+  std::atomic<uint32_t> torn{0}, backwards{0};
+  std::vector<uint32_t> reads(readers, 0);
+
+  std::vector<std::thread> threads;
+  for (int r = 0; r < readers; r++) {
+    threads.emplace_back([&, r] {
+      uint32_t last = 0;
+      while (!done.load(std::memory_order_acquire)) {
+        Snapshot s = lock.read();
+        if (!s.consistent()) torn++;
+        if (s.n < last) backwards++;
+        last = s.n;
+        reads[r]++;
+      }
+    });
+  }
+  for (uint32_t n = 1; n <= writes; n++) lock.write(Snapshot::of(n));
+  done.store(true, std::memory_order_release);
+  for (auto& thread : threads) thread.join();
+
+  uint32_t total = 0;
+  for (uint32_t count : reads) total += count;
+  printf("  %u writes, %u reads by %d readers\n", writes, total, readers);
+  TEST_ASSERT_EQUAL(0, torn.load());
+  TEST_ASSERT_EQUAL(0, backwards.load());
+  TEST_ASSERT_EQUAL(writes + 1, lock.version());
+  TEST_ASSERT_EQUAL(writes, lock.read().n);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_single_thread_round_trip);
+  RUN_TEST(test_readers_never_see_torn_values);
+  return UNITY_END();
+}
@@ -0,0 +1,269 @@
+#include <arpa/inet.h>
+#include <signal.h>
+#include <mbedtls/ssl_cache.h>
+#include <mbedtls/version.h>
+#include <tlsClient.h>
+#include <unity.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "../fixtures/tlsServer.h"
+
+// mbedtls TLS server on a loopback port. serveOne() takes one connection: handshake, answer a
+// "ping" line with "pong", close. Sessions go to a cache, so clients can resume them until
+// forgetSessions().
+class LoopbackServer {
+ public:
+  uint16_t port = 0;
+  int result = 0;  // Handshake result of the last connection
+
+  LoopbackServer() {
+    mbedtls_net_init(&_listen);
+    mbedtls_entropy_init(&_entropy);
+    mbedtls_ctr_drbg_init(&_drbg);
+    mbedtls_ssl_config_init(&_conf);
+    mbedtls_x509_crt_init(&_cert);
+    mbedtls_pk_init(&_key);
+    mbedtls_ssl_cache_init(&_cache);
+  }
+
+  ~LoopbackServer() {
+    mbedtls_net_free(&_listen);
+    mbedtls_ssl_cache_free(&_cache);
+    mbedtls_pk_free(&_key);
+    mbedtls_x509_crt_free(&_cert);
+    mbedtls_ssl_config_free(&_conf);
+    mbedtls_ctr_drbg_free(&_drbg);
+    mbedtls_entropy_free(&_entropy);
+  }
+
+  // Load the server certificate and listen on an unused port of "localhost"
+  void begin() {
+    TEST_ASSERT_EQUAL(0, mbedtls_ctr_drbg_seed(&_drbg, mbedtls_entropy_func, &_entropy, nullptr, 0));
+    TEST_ASSERT_EQUAL(0, mbedtls_x509_crt_parse(&_cert, (const unsigned char*)testServerCertPem,
+                                                strlen(testServerCertPem) + 1));
+#if MBEDTLS_VERSION_MAJOR >= 3
+    TEST_ASSERT_EQUAL(0, mbedtls_pk_parse_key(&_key, (const unsigned char*)testServerKeyPem,
+                                              strlen(testServerKeyPem) + 1, nullptr, 0, mbedtls_ctr_drbg_random,
+                                              &_drbg));
+#else
+    TEST_ASSERT_EQUAL(0, mbedtls_pk_parse_key(&_key, (const unsigned char*)testServerKeyPem,
+                                              strlen(testServerKeyPem) + 1, nullptr, 0));
+#endif
+    TEST_ASSERT_EQUAL(0, mbedtls_ssl_config_defaults(&_conf, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                                     MBEDTLS_SSL_PRESET_DEFAULT));
+    mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &_drbg);
+    TEST_ASSERT_EQUAL(0, mbedtls_ssl_conf_own_cert(&_conf, &_cert, &_key));
+    mbedtls_ssl_conf_session_cache(&_conf, &_cache, mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
+
+    TEST_ASSERT_EQUAL(0, mbedtls_net_bind(&_listen, "localhost", "0", MBEDTLS_NET_PROTO_TCP));
+    port = localPort(_listen.fd);
+  }
+
+  int serveOne() {
+    mbedtls_net_context client;
+    mbedtls_ssl_context ssl;
+    mbedtls_net_init(&client);
+    mbedtls_ssl_init(&ssl);
+    int ret = mbedtls_net_accept(&_listen, &client, nullptr, 0, nullptr);
+    if (ret == 0) ret = mbedtls_ssl_setup(&ssl, &_conf);
+    if (ret == 0) {
+      mbedtls_ssl_set_bio(&ssl, &client, mbedtls_net_send, mbedtls_net_recv, nullptr);
+      do {
+        ret = mbedtls_ssl_handshake(&ssl);
+      } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+    }
+    if (ret == 0) {
+      unsigned char request[16] = {};
+      // Nothing comes if the client gave up on the connection, e.g. after a pin mismatch
+      if (mbedtls_ssl_read(&ssl, request, sizeof(request) - 1) > 0 && strcmp((char*)request, "ping\n") == 0) {
+        mbedtls_ssl_write(&ssl, (const unsigned char*)"pong\n", 5);
+        mbedtls_ssl_close_notify(&ssl);
+      }
+    }
+    mbedtls_ssl_free(&ssl);
+    mbedtls_net_free(&client);
+    return ret;
+  }
+
+  // As after a server restart: no session offered from before will be accepted
+  void forgetSessions() {
+    mbedtls_ssl_cache_free(&_cache);
+    mbedtls_ssl_cache_init(&_cache);
+  }
+
+  static uint16_t localPort(int fd) {
+    struct sockaddr_storage address;
+    socklen_t length = sizeof(address);
+    getsockname(fd, (struct sockaddr*)&address, &length);
+    return ntohs(address.ss_family == AF_INET6 ? ((struct sockaddr_in6*)&address)->sin6_port
+                                               : ((struct sockaddr_in*)&address)->sin_port);
+  }
+
+ private:
+  mbedtls_net_context _listen;
+  mbedtls_entropy_context _entropy;
+  mbedtls_ctr_drbg_context _drbg;
+  mbedtls_ssl_config _conf;
+  mbedtls_x509_crt _cert;
+  mbedtls_pk_context _key;
+  mbedtls_ssl_cache_context _cache;
+};
+
+// Plain TCP listener on 127.0.0.1 that never accepts
+static int silentListener(int backlog) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  TEST_ASSERT_EQUAL(0, bind(fd, (struct sockaddr*)&address, sizeof(address)));
+  TEST_ASSERT_EQUAL(0, listen(fd, backlog));
+  return fd;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Connect, send "ping", expect "pong", close. The handshake timeout counts virtual time, a
+// tick for every try, while the server works in real time, so it is set out of reach. The
+// client socket doesn't block: wait up to two seconds of real time for the reply.
+static bool pingPong(LoopbackServer& server, ResumableTlsClient& client) {
+  std::thread thread([&] { server.result = server.serveOne(); });
+  bool ok = client.connect("localhost", server.port, INT32_MAX / 2) == 1;
+  std::string reply;
+  if (ok) {
+    client.write((const uint8_t*)"ping\n", 5);
+    auto start = std::chrono::steady_clock::now();
+    while (reply.find('\n') == std::string::npos && secondsSince(start) < 2) {
+      int c = client.read();
+      if (c >= 0)
+        reply += (char)c;
+      else
+        std::this_thread::yield();
+    }
+  }
+  client.stop();
+  thread.join();
+  return ok && reply == "pong\n";
+}
+
+void setUp() {}
+void tearDown() {}
+
+// The first connection does the full handshake, later ones offer its session and resume
+void test_full_then_resumed_handshake() {
+  LoopbackServer server;
+  server.begin();
+  ResumableTlsClient client;
+  client.setCACert(testCaPem);
+
+  TEST_ASSERT_TRUE(pingPong(server, client));
+  TEST_ASSERT_EQUAL(1, client.fullHandshakes().count);
+  TEST_ASSERT_EQUAL(0, client.resumedHandshakes().count);
+  for (int i = 1; i <= 2; i++) {
+    TEST_ASSERT_TRUE(pingPong(server, client));
+    TEST_ASSERT_EQUAL(1, client.fullHandshakes().count);
+    TEST_ASSERT_EQUAL(i, client.resumedHandshakes().count);
+  }
+  TEST_ASSERT_EQUAL(0, client.failures());
+  client.report();
+}
+
+// A server that no longer knows the session answers with a full handshake, which succeeds,
+// and the new session is resumed next time
+void test_rejected_session_falls_back_to_full() {
+  LoopbackServer server;
+  server.begin();
+  ResumableTlsClient client;
+  client.setCACert(testCaPem);
+
+  TEST_ASSERT_TRUE(pingPong(server, client));
+  server.forgetSessions();
+  TEST_ASSERT_TRUE(pingPong(server, client));
+  TEST_ASSERT_EQUAL(2, client.fullHandshakes().count);
+  TEST_ASSERT_EQUAL(0, client.resumedHandshakes().count);
+  TEST_ASSERT_TRUE(pingPong(server, client));
+  TEST_ASSERT_EQUAL(1, client.resumedHandshakes().count);
+  TEST_ASSERT_EQUAL(0, client.failures());
+}
+
+// The pin alone is trust enough, also on a resumed session. Any other key is refused after
+// the handshake, with or without a CA, and its session isn't kept.
+void test_public_key_pin() {
+  LoopbackServer server;
+  server.begin();
+
+  ResumableTlsClient pinned;
+  TEST_ASSERT_TRUE(pinned.setPublicKeyPin(testServerPin));
+  TEST_ASSERT_TRUE(pingPong(server, pinned));
+  TEST_ASSERT_TRUE(pingPong(server, pinned));
+  TEST_ASSERT_EQUAL(1, pinned.resumedHandshakes().count);
+
+  ResumableTlsClient wrongPin;
+  TEST_ASSERT_TRUE(wrongPin.setPublicKeyPin(testCaPin));
+  TEST_ASSERT_FALSE(pingPong(server, wrongPin));
+  TEST_ASSERT_EQUAL(0, server.result);  // The handshake itself went through
+  TEST_ASSERT_EQUAL(1, wrongPin.failures());
+  TEST_ASSERT_FALSE(pingPong(server, wrongPin));
+  TEST_ASSERT_EQUAL(2, wrongPin.failures());
+  TEST_ASSERT_EQUAL(0, wrongPin.fullHandshakes().count + wrongPin.resumedHandshakes().count);
+
+  ResumableTlsClient caAndWrongPin;
+  caAndWrongPin.setCACert(testCaPem);
+  TEST_ASSERT_TRUE(caAndWrongPin.setPublicKeyPin(testCaPin));
+  TEST_ASSERT_FALSE(pingPong(server, caAndWrongPin));
+  TEST_ASSERT_EQUAL(1, caAndWrongPin.failures());
+
+  ResumableTlsClient untrusted;
+  TEST_ASSERT_FALSE(untrusted.setPublicKeyPin("70c07efa"));
+  TEST_ASSERT_EQUAL(0, untrusted.connect("localhost", server.port));  // Neither CA nor pin
+}
+
+// A server that never answers the handshake, and one that never completes the TCP connect
+void test_connect_timeout() {
+  ResumableTlsClient client;
+  client.setPublicKeyPin(testServerPin);
+
+  // TCP connects (the kernel accepts for the listener), then no ServerHello. The handshake
+  // loop waits a tick at a time, on the virtual clock.
+  int silent = silentListener(4);
+  uint64_t clockBefore = hostClockMicros;
+  auto start = std::chrono::steady_clock::now();
+  TEST_ASSERT_EQUAL(0, client.connect("127.0.0.1", LoopbackServer::localPort(silent), 300));
+  uint64_t waitedMs = (hostClockMicros - clockBefore) / 1000;
+  TEST_ASSERT_TRUE(waitedMs >= 300 && waitedMs < 400);
+  TEST_ASSERT_TRUE(secondsSince(start) < 2);
+  TEST_ASSERT_EQUAL(1, client.failures());
+  close(silent);
+
+  // On Linux a backlog of 0 takes one connection; SYNs after it are dropped and the connect
+  // hangs until the timeout, in real time
+  int full = silentListener(0);
+  uint16_t port = LoopbackServer::localPort(full);
+  int filler = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  TEST_ASSERT_EQUAL(0, connect(filler, (struct sockaddr*)&address, sizeof(address)));
+  start = std::chrono::steady_clock::now();
+  TEST_ASSERT_EQUAL(0, client.connect("127.0.0.1", port, 300));
+  double waited = secondsSince(start);
+  TEST_ASSERT_TRUE(waited >= 0.25 && waited < 2);
+  TEST_ASSERT_EQUAL(2, client.failures());
+  close(filler);
+  close(full);
+}
+
+int main() {
+  signal(SIGPIPE, SIG_IGN);  // A write to a closed socket fails, as on lwIP
+  UNITY_BEGIN();
+  RUN_TEST(test_full_then_resumed_handshake);
+  RUN_TEST(test_rejected_session_falls_back_to_full);
+  RUN_TEST(test_public_key_pin);
+  RUN_TEST(test_connect_timeout);
+  return UNITY_END();
+}